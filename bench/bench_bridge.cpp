@@ -0,0 +1,555 @@
+// bench_bridge - Débito e latência da bridge por padrão, transporte,
+// tamanho de mensagem e número de threads.
+//
+// Cada caso corre "threads" pares emissor/recetor independentes (cada par
+// com o seu endpoint) durante --duration-ms e escreve uma linha JSON em
+// stdout; o progresso vai para stderr. Exemplo:
+//
+//   bench_bridge --patterns pubsub,pushpull --transports inproc,tcp
+//                --sizes 16,1024,1048576 --threads 1,4 --label my-branch
+//
+// PUB/SUB e PUSH/PULL medem latência num sentido (emissor e recetor no
+// mesmo processo, mesmo relógio); REQ/REP mede ida e volta.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ZMQBridge.h>
+
+using Clock = std::chrono::steady_clock;
+
+// Limite de memória em fila por socket; o HWM é ajustado ao tamanho
+static const size_t kQueueBytes = 32 * 1024 * 1024;
+
+// Tempo sem mensagens, depois do fim do envio, para dar o caso por terminado
+static const int64_t kDrainNs = 200 * 1000 * 1000;
+
+struct BenchOptions {
+    std::vector<std::string> patterns{ "pubsub", "pushpull", "reqrep" };
+#ifdef _WIN32
+    std::vector<std::string> transports{ "inproc", "tcp" };
+#else
+    std::vector<std::string> transports{ "inproc", "ipc", "tcp" };
+#endif
+    std::vector<size_t> sizes;
+    std::vector<int> threads{ 1, 2, 4 };
+    int duration_ms = 1000;
+    int base_port = 56000;
+    int io_threads = 2;
+    std::string label = "default";
+};
+
+// Resultado de um par emissor/recetor
+struct PairResult {
+    uint64_t messages = 0;
+    double seconds = 0.0;
+    std::vector<int64_t> latencies_ns;
+};
+
+static int64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now().time_since_epoch())
+        .count();
+}
+
+static std::vector<std::string> SplitList(const std::string& text)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+
+    return items;
+}
+
+static std::string RunId()
+{
+    return std::to_string(NowNs() % 1000000000);
+}
+
+// Endpoint novo para cada par (os transportes não reutilizam endereços)
+static std::string MakeEndpoint(const std::string& transport, const BenchOptions& options)
+{
+    static const std::string run_id = RunId();
+    static std::atomic<int> counter{ 0 };
+    int n = counter++;
+
+    if (transport == "inproc")
+    {
+        return "inproc://bench-" + std::to_string(n);
+    }
+
+    if (transport == "ipc")
+    {
+        return "ipc:///tmp/zmq-bridge-bench-" + run_id + "-" + std::to_string(n);
+    }
+
+    return "tcp://127.0.0.1:" + std::to_string(options.base_port + n % 8000);
+}
+
+static int CreateSocket(int type, const std::string& endpoint, bool bind, size_t payload)
+{
+    zmq_bridge_socket_options socket_options;
+    zmq_bridge_socket_options_init(&socket_options);
+
+    size_t hwm = std::max<size_t>(2, std::min<size_t>(1000, kQueueBytes / payload));
+    socket_options.sndhwm = static_cast<int>(hwm);
+    socket_options.rcvhwm = static_cast<int>(hwm);
+
+    return zmq_bridge_create_socket_ex(type, endpoint.c_str(), bind ? 1 : 0,
+                                       &socket_options, nullptr);
+}
+
+static void WriteStamp(std::vector<char>& payload, int64_t stamp)
+{
+    memcpy(payload.data(), &stamp, sizeof(stamp));
+}
+
+static int64_t ReadStamp(const void* data, int size)
+{
+    int64_t stamp = 0;
+    if (size >= static_cast<int>(sizeof(stamp)))
+    {
+        memcpy(&stamp, data, sizeof(stamp));
+    }
+
+    return stamp;
+}
+
+// PUB/SUB ou PUSH/PULL: o recetor mede a latência de cada mensagem
+static bool RunOneWayPair(int sender_type, int receiver_type, bool sender_binds,
+                          const std::string& endpoint, size_t size, int duration_ms,
+                          PairResult& result)
+{
+    int sender = -1;
+    int receiver = -1;
+
+    if (sender_binds)
+    {
+        sender = CreateSocket(sender_type, endpoint, true, size);
+        receiver = CreateSocket(receiver_type, endpoint, false, size);
+    }
+    else
+    {
+        receiver = CreateSocket(receiver_type, endpoint, true, size);
+        sender = CreateSocket(sender_type, endpoint, false, size);
+    }
+
+    if (sender < 0 || receiver < 0)
+    {
+        std::cerr << "Failed to create sockets on " << endpoint << ": "
+                  << zmq_bridge_get_last_error() << std::endl;
+        zmq_bridge_close_socket(sender);
+        zmq_bridge_close_socket(receiver);
+        return false;
+    }
+
+    std::atomic<bool> ready{ false };
+    std::atomic<int64_t> sender_done_ns{ 0 };
+    int64_t start_ns = 0;
+    int64_t last_ns = 0;
+
+    result.latencies_ns.reserve(1 << 20);
+
+    std::thread receive_thread([&]() {
+        while (true)
+        {
+            if (zmq_bridge_poll(receiver, 20) <= 0)
+            {
+                int64_t done = sender_done_ns.load();
+                if (done != 0 && NowNs() - done > kDrainNs)
+                {
+                    break;
+                }
+
+                continue;
+            }
+
+            void* message = nullptr;
+            const void* data = nullptr;
+            int received = 0;
+            while (zmq_bridge_receive_borrowed(receiver, &message, &data, &received)
+                   == ZMQ_BRIDGE_OK)
+            {
+                int64_t stamp = ReadStamp(data, received);
+                zmq_bridge_release_message(message);
+
+                // Mensagens de aquecimento (carimbo 0) só confirmam a ligação
+                if (stamp == 0)
+                {
+                    ready = true;
+                    continue;
+                }
+
+                int64_t now = NowNs();
+                result.latencies_ns.push_back(now - stamp);
+                ++result.messages;
+                last_ns = now;
+            }
+        }
+    });
+
+    std::vector<char> payload(size, 'x');
+
+    // Espera pela ligação (evita perder as primeiras mensagens em PUB/SUB)
+    WriteStamp(payload, 0);
+    while (!ready)
+    {
+        zmq_bridge_send(sender, payload.data(), static_cast<int>(size));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    start_ns = NowNs();
+    int64_t end_ns = start_ns + static_cast<int64_t>(duration_ms) * 1000000;
+
+    int64_t now = start_ns;
+    while (now < end_ns)
+    {
+        WriteStamp(payload, now);
+        if (zmq_bridge_send(sender, payload.data(), static_cast<int>(size)) != ZMQ_BRIDGE_OK)
+        {
+            std::cerr << "Send failed: " << zmq_bridge_get_last_error() << std::endl;
+            break;
+        }
+
+        now = NowNs();
+    }
+
+    sender_done_ns = NowNs();
+    receive_thread.join();
+
+    result.seconds = last_ns > start_ns ? (last_ns - start_ns) / 1e9 : 0.0;
+
+    zmq_bridge_close_socket(sender);
+    zmq_bridge_close_socket(receiver);
+    return true;
+}
+
+// REQ/REP: o cliente mede a ida e volta de cada pedido
+static bool RunRequestReplyPair(const std::string& endpoint, size_t size, int duration_ms,
+                                PairResult& result)
+{
+    int server = CreateSocket(ZMQ_BRIDGE_SOCKET_REP, endpoint, true, size);
+    int client = CreateSocket(ZMQ_BRIDGE_SOCKET_REQ, endpoint, false, size);
+
+    if (server < 0 || client < 0)
+    {
+        std::cerr << "Failed to create sockets on " << endpoint << ": "
+                  << zmq_bridge_get_last_error() << std::endl;
+        zmq_bridge_close_socket(server);
+        zmq_bridge_close_socket(client);
+        return false;
+    }
+
+    std::atomic<bool> stop{ false };
+
+    std::thread server_thread([&]() {
+        while (!stop)
+        {
+            if (zmq_bridge_poll(server, 20) <= 0)
+            {
+                continue;
+            }
+
+            void* message = nullptr;
+            const void* data = nullptr;
+            int received = 0;
+            if (zmq_bridge_receive_borrowed(server, &message, &data, &received)
+                == ZMQ_BRIDGE_OK)
+            {
+                // Devolve a mesma mensagem (mesmo tamanho)
+                zmq_bridge_send(server, data, received);
+                zmq_bridge_release_message(message);
+            }
+        }
+    });
+
+    std::vector<char> payload(size, 'x');
+    result.latencies_ns.reserve(1 << 18);
+
+    int64_t start_ns = NowNs();
+    int64_t end_ns = start_ns + static_cast<int64_t>(duration_ms) * 1000000;
+    int64_t now = start_ns;
+
+    while (now < end_ns)
+    {
+        WriteStamp(payload, now);
+        if (zmq_bridge_send(client, payload.data(), static_cast<int>(size)) != ZMQ_BRIDGE_OK)
+        {
+            std::cerr << "Send failed: " << zmq_bridge_get_last_error() << std::endl;
+            break;
+        }
+
+        if (zmq_bridge_poll(client, 5000) <= 0)
+        {
+            std::cerr << "Reply timed out on " << endpoint << std::endl;
+            break;
+        }
+
+        void* message = nullptr;
+        const void* data = nullptr;
+        int received = 0;
+        if (zmq_bridge_receive_borrowed(client, &message, &data, &received) != ZMQ_BRIDGE_OK)
+        {
+            break;
+        }
+
+        int64_t stamp = ReadStamp(data, received);
+        zmq_bridge_release_message(message);
+
+        now = NowNs();
+        result.latencies_ns.push_back(now - stamp);
+        ++result.messages;
+    }
+
+    result.seconds = (now - start_ns) / 1e9;
+
+    stop = true;
+    server_thread.join();
+
+    zmq_bridge_close_socket(client);
+    zmq_bridge_close_socket(server);
+    return true;
+}
+
+static double PercentileUs(const std::vector<int64_t>& sorted, double percentile)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+
+    size_t index = static_cast<size_t>(percentile * static_cast<double>(sorted.size()));
+    index = std::min(index, sorted.size() - 1);
+    return sorted[index] / 1000.0;
+}
+
+static void RunCase(const BenchOptions& options, const std::string& pattern,
+                    const std::string& transport, size_t size, int thread_count)
+{
+    std::cerr << pattern << " " << transport << " " << size << " B x" << thread_count
+              << "..." << std::endl;
+
+    zmq_bridge_pool_stats pool_before;
+    zmq_bridge_get_pool_stats(&pool_before);
+
+    std::vector<PairResult> results(thread_count);
+    std::vector<std::thread> pairs;
+    std::atomic<int> failures{ 0 };
+
+    for (int i = 0; i < thread_count; ++i)
+    {
+        std::string endpoint = MakeEndpoint(transport, options);
+
+        pairs.emplace_back([&, endpoint, i]() {
+            bool ok = false;
+            if (pattern == "pubsub")
+            {
+                ok = RunOneWayPair(ZMQ_BRIDGE_SOCKET_PUB, ZMQ_BRIDGE_SOCKET_SUB, true,
+                                   endpoint, size, options.duration_ms, results[i]);
+            }
+            else if (pattern == "pushpull")
+            {
+                ok = RunOneWayPair(ZMQ_BRIDGE_SOCKET_PUSH, ZMQ_BRIDGE_SOCKET_PULL, false,
+                                   endpoint, size, options.duration_ms, results[i]);
+            }
+            else
+            {
+                ok = RunRequestReplyPair(endpoint, size, options.duration_ms, results[i]);
+            }
+
+            if (!ok)
+            {
+                ++failures;
+            }
+        });
+    }
+
+    for (auto& pair : pairs)
+    {
+        pair.join();
+    }
+
+    if (failures > 0)
+    {
+        return;
+    }
+
+    uint64_t messages = 0;
+    double seconds = 0.0;
+    std::vector<int64_t> latencies;
+
+    for (auto& result : results)
+    {
+        messages += result.messages;
+        seconds = std::max(seconds, result.seconds);
+        latencies.insert(latencies.end(), result.latencies_ns.begin(),
+                         result.latencies_ns.end());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    zmq_bridge_pool_stats pool_after;
+    zmq_bridge_get_pool_stats(&pool_after);
+
+    double msgs_per_sec = seconds > 0.0 ? messages / seconds : 0.0;
+    double mb_per_sec = msgs_per_sec * static_cast<double>(size) / (1024.0 * 1024.0);
+
+    printf("{\"label\":\"%s\",\"pattern\":\"%s\",\"transport\":\"%s\",\"size\":%zu,"
+           "\"threads\":%d,\"messages\":%llu,\"seconds\":%.3f,\"msgs_per_sec\":%.1f,"
+           "\"mb_per_sec\":%.2f,\"p50_us\":%.2f,\"p99_us\":%.2f,\"p999_us\":%.2f,"
+           "\"max_us\":%.2f,\"pool_hits\":%lld,\"pool_misses\":%lld}\n",
+           options.label.c_str(), pattern.c_str(), transport.c_str(), size, thread_count,
+           static_cast<unsigned long long>(messages), seconds, msgs_per_sec, mb_per_sec,
+           PercentileUs(latencies, 0.50), PercentileUs(latencies, 0.99),
+           PercentileUs(latencies, 0.999), latencies.empty() ? 0.0 : latencies.back() / 1000.0,
+           pool_after.hits - pool_before.hits, pool_after.misses - pool_before.misses);
+    fflush(stdout);
+}
+
+static void PrintUsage()
+{
+    std::cerr << "Usage: bench_bridge [options]\n"
+              << "  --patterns LIST     pubsub,pushpull,reqrep\n"
+              << "  --transports LIST   inproc,ipc,tcp\n"
+              << "  --sizes LIST        payload sizes in bytes (default: 16 B to 16 MB, x4)\n"
+              << "  --threads LIST      concurrent sender/receiver pairs (default: 1,2,4)\n"
+              << "  --duration-ms N     measurement time per case (default: 1000)\n"
+              << "  --port N            first TCP port (default: 56000)\n"
+              << "  --io-threads N      libzmq I/O threads (default: 2)\n"
+              << "  --label TEXT        copied to every result line\n";
+}
+
+static bool ParseArgs(int argc, char* argv[], BenchOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc)
+        {
+            return false;
+        }
+
+        std::string value = argv[++i];
+
+        if (arg == "--patterns")
+        {
+            options.patterns = SplitList(value);
+        }
+        else if (arg == "--transports")
+        {
+            options.transports = SplitList(value);
+        }
+        else if (arg == "--sizes")
+        {
+            options.sizes.clear();
+            for (const auto& item : SplitList(value))
+            {
+                options.sizes.push_back(std::strtoull(item.c_str(), nullptr, 10));
+            }
+        }
+        else if (arg == "--threads")
+        {
+            options.threads.clear();
+            for (const auto& item : SplitList(value))
+            {
+                options.threads.push_back(std::atoi(item.c_str()));
+            }
+        }
+        else if (arg == "--duration-ms")
+        {
+            options.duration_ms = std::atoi(value.c_str());
+        }
+        else if (arg == "--port")
+        {
+            options.base_port = std::atoi(value.c_str());
+        }
+        else if (arg == "--io-threads")
+        {
+            options.io_threads = std::atoi(value.c_str());
+        }
+        else if (arg == "--label")
+        {
+            options.label = value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    BenchOptions options;
+    if (!ParseArgs(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    if (options.sizes.empty())
+    {
+        for (size_t size = 16; size <= 16 * 1024 * 1024; size *= 4)
+        {
+            options.sizes.push_back(size);
+        }
+    }
+
+    zmq_bridge_config config;
+    zmq_bridge_config_init(&config);
+    config.io_threads = options.io_threads;
+
+    if (zmq_bridge_init_ex(&config) != ZMQ_BRIDGE_OK)
+    {
+        std::cerr << "Failed to initialize ZeroMQ bridge: " << zmq_bridge_get_last_error()
+                  << std::endl;
+        return 1;
+    }
+
+    for (const auto& pattern : options.patterns)
+    {
+        if (pattern != "pubsub" && pattern != "pushpull" && pattern != "reqrep")
+        {
+            std::cerr << "Unknown pattern: " << pattern << std::endl;
+            continue;
+        }
+
+        for (const auto& transport : options.transports)
+        {
+            for (size_t size : options.sizes)
+            {
+                for (int thread_count : options.threads)
+                {
+                    // O carimbo de tempo ocupa os primeiros 8 bytes
+                    if (size < sizeof(int64_t) || thread_count <= 0 || size > INT32_MAX)
+                    {
+                        continue;
+                    }
+
+                    RunCase(options, pattern, transport, size, thread_count);
+                }
+            }
+        }
+    }
+
+    zmq_bridge_shutdown();
+    return 0;
+}
@@ -16,39 +16,686 @@
 #define ZMQ_BRIDGE_ERROR_SEND -5
 #define ZMQ_BRIDGE_ERROR_RECEIVE -6
 #define ZMQ_BRIDGE_ERROR_INVALID_SOCKET -7
+#define ZMQ_BRIDGE_ERROR_INVALID_HANDLE -8
+#define ZMQ_BRIDGE_ERROR_QUEUE_FULL -9
+#define ZMQ_BRIDGE_ERROR_CODEC -10
+#define ZMQ_BRIDGE_ERROR_SCHEMA -11
+#define ZMQ_BRIDGE_ERROR_OPTION -12
+#define ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL -13
+#define ZMQ_BRIDGE_ERROR_TOPIC -14
+#define ZMQ_BRIDGE_ERROR_SHM -15
+#define ZMQ_BRIDGE_ERROR_TIMEOUT -16
+#define ZMQ_BRIDGE_ERROR_LOG -17
 #define ZMQ_BRIDGE_NO_MESSAGE 1
 
+// Tipos de zmq_bridge_create_socket_ex
+#define ZMQ_BRIDGE_SOCKET_PUB 1
+#define ZMQ_BRIDGE_SOCKET_SUB 2
+#define ZMQ_BRIDGE_SOCKET_REQ 3
+#define ZMQ_BRIDGE_SOCKET_REP 4
+#define ZMQ_BRIDGE_SOCKET_PUSH 5
+#define ZMQ_BRIDGE_SOCKET_PULL 6
+#define ZMQ_BRIDGE_SOCKET_DEALER 7
+#define ZMQ_BRIDGE_SOCKET_ROUTER 8
+
+// Opções de zmq_bridge_set_option/zmq_bridge_get_option (equivalentes às
+// ZMQ_* com o mesmo nome)
+#define ZMQ_BRIDGE_OPT_SNDHWM 1
+#define ZMQ_BRIDGE_OPT_RCVHWM 2
+#define ZMQ_BRIDGE_OPT_SNDBUF 3
+#define ZMQ_BRIDGE_OPT_RCVBUF 4
+#define ZMQ_BRIDGE_OPT_LINGER 5
+#define ZMQ_BRIDGE_OPT_CONFLATE 6
+#define ZMQ_BRIDGE_OPT_IMMEDIATE 7
+#define ZMQ_BRIDGE_OPT_TCP_KEEPALIVE 8
+#define ZMQ_BRIDGE_OPT_TCP_KEEPALIVE_IDLE 9
+#define ZMQ_BRIDGE_OPT_TCP_KEEPALIVE_INTVL 10
+#define ZMQ_BRIDGE_OPT_TCP_KEEPALIVE_CNT 11
+#define ZMQ_BRIDGE_OPT_AFFINITY 12
+#define ZMQ_BRIDGE_OPT_SNDTIMEO 13
+#define ZMQ_BRIDGE_OPT_RCVTIMEO 14
+
+// Flags de cada frame recebido
+#define ZMQ_BRIDGE_MSG_MORE 0x1      // seguem-se mais frames da mesma mensagem
+#define ZMQ_BRIDGE_MSG_TRUNCATED 0x2 // o frame não coube no buffer
+
+// Opções de zmq_bridge_receive_ex
+#define ZMQ_BRIDGE_RECV_TRUNCATE 0x1 // trunca em vez de deixar o frame pendente
+
+// Eventos de zmq_bridge_poller_* (iguais a ZMQ_POLLIN/ZMQ_POLLOUT)
+#define ZMQ_BRIDGE_POLLIN 1
+#define ZMQ_BRIDGE_POLLOUT 2
+
+// Flags de zmq_bridge_latest_create
+#define ZMQ_BRIDGE_LATEST_SINGLE_FRAME 0x1 // envia [tópico + dados] num só frame
+
+// Flags de zmq_bridge_scheduler_add_topic
+#define ZMQ_BRIDGE_SCHEDULE_REPEAT 0x1 // sem frame novo, repete o último a cada tick
+
+// Codecs de zmq_bridge_set_topic_codec (LZ4, zstd e JPEG são opcionais na build)
+#define ZMQ_BRIDGE_CODEC_NONE 0
+#define ZMQ_BRIDGE_CODEC_LZ4 1
+#define ZMQ_BRIDGE_CODEC_ZSTD 2
+#define ZMQ_BRIDGE_CODEC_JPEG 3
+
+// topic_id de mensagens cujo tópico não está registado
+#define ZMQ_BRIDGE_TOPIC_NONE -1
+
+// Registos binários: cabeçalho "ZR", u16 schema_id, u32 tamanho dos campos
+#define ZMQ_BRIDGE_RECORD_HEADER_SIZE 8
+
+// Envelope de rastreio (zmq_bridge_set_envelope): frame "ZBE1", u32 emissor,
+// u64 número de sequência, i64 instante de envio em ns (steady clock)
+#define ZMQ_BRIDGE_ENVELOPE_SIZE 24
+
+// Fluxos de envelope seguidos por socket, em cada sentido (ver
+// zmq_bridge_set_envelope)
+#define ZMQ_BRIDGE_ENVELOPE_MAX_STREAMS 4096
+
+// Pedidos RPC (zmq_bridge_rpc_*): [cabeçalho][dados], com cabeçalho "ZBQ1"
+// (pedido) ou "ZBP1" (resposta), u32 timeout_ms e u64 ID de correlação
+#define ZMQ_BRIDGE_RPC_HEADER_SIZE 16
+
+// Memória partilhada (zmq_bridge_shm_*). Notificação: "ZBN1", u32 slot,
+// u64 sequência, u64 token do segmento, u32 tamanho, u16 tamanho do nome,
+// u16 reservado, seguidos do nome do segmento
+#define ZMQ_BRIDGE_SHM_NOTIFY_HEADER_SIZE 32
+#define ZMQ_BRIDGE_SHM_ALWAYS 0x1 // usa o segmento mesmo com endpoints tcp remotos
+#define ZMQ_BRIDGE_SHM_INLINE 2   // o frame já contém os dados (não é notificação)
+
 extern "C" {
+
+// Função chamada quando o libzmq deixa de precisar de um buffer enviado
+// sem cópia (pode ser chamada a partir de uma thread de I/O do ZeroMQ)
+typedef void (*zmq_bridge_free_fn)(void* data, void* hint);
+
+// Callback de zmq_bridge_set_callback: os frames da mensagem ficam
+// contíguos em data (como em zmq_bridge_receive_multipart) e só são
+// válidos durante a chamada
+typedef void (*zmq_bridge_message_callback)(int socket_id, const void* data,
+                                            const int* frame_sizes,
+                                            int frame_count, void* user_data);
+
+// Posição de um frame dentro do buffer de zmq_bridge_receive_batch
+typedef struct zmq_bridge_batch_entry {
+    int offset;
+    int size;
+    int flags;
+} zmq_bridge_batch_entry;
+
+// Item de zmq_bridge_publish_batch (topic NULL envia só os dados)
+typedef struct zmq_bridge_publish_item {
+    int socket_id;
+    const char* topic;
+    const void* data;
+    int size;
+} zmq_bridge_publish_item;
+
+// Socket pronto devolvido por zmq_bridge_poller_wait
+typedef struct zmq_bridge_poll_event {
+    int socket_id;
+    int events;
+} zmq_bridge_poll_event;
+
+// Contadores de zmq_bridge_latest_get_stats
+typedef struct zmq_bridge_latest_stats {
+    long long published;   // frames entregues a zmq_bridge_latest_publish
+    long long sent;        // frames entregues ao socket (um PUB no HWM descarta-os
+                           // em silêncio e contam aqui)
+    long long overwritten; // substituídos por um mais recente antes do envio
+    long long dropped;     // não enviados: socket fechado, erro de envio, ou
+                           // EAGAIN em sockets que não sejam PUB
+} zmq_bridge_latest_stats;
+
+// Distribuição de tempos (ns) de zmq_bridge_socket_stats. Os percentis vêm
+// de um histograma log-linear e têm um erro relativo de até 1/16.
+typedef struct zmq_bridge_time_stats {
+    long long count;
+    long long p50_ns;
+    long long p90_ns;
+    long long p99_ns;
+    long long p999_ns;
+    long long max_ns;
+} zmq_bridge_time_stats;
+
+// Contadores de um tópico de zmq_bridge_scheduler_get_stats
+typedef struct zmq_bridge_schedule_stats {
+    long long published;    // frames entregues a zmq_bridge_scheduler_publish
+    long long sent;         // frames aceites pelo socket
+    long long coalesced;    // substituídos por um mais recente antes do tick
+    long long idle_ticks;   // ticks sem frame para enviar
+    long long missed_ticks; // ticks saltados porque a thread chegou atrasada
+    long long dropped;      // recusados pelo socket (HWM atingido, socket fechado)
+    zmq_bridge_time_stats jitter; // atraso de cada tick em relação ao seu prazo
+} zmq_bridge_schedule_stats;
+
+// Contadores de zmq_bridge_get_stats, acumulados desde a criação do socket
+// (ou desde zmq_bridge_reset_stats)
+typedef struct zmq_bridge_socket_stats {
+    long long messages_sent;       // frames aceites pelo libzmq
+    long long bytes_sent;
+    long long messages_received;   // frames lidos do libzmq
+    long long bytes_received;
+    long long send_would_block;    // envios recusados com EAGAIN (HWM, sem peers)
+    long long receive_would_block; // leituras sem mensagem disponível
+    long long send_errors;
+    long long receive_errors;
+    long long truncated;           // frames entregues truncados
+    long long pending_frames;      // lidos do libzmq e ainda não entregues
+    long long reactor_outgoing;    // frames na fila de saída do reactor
+    long long reactor_incoming;    // frames na fila de entrada do reactor
+    zmq_bridge_time_stats send_time;    // tempo dentro de zmq_send
+    zmq_bridge_time_stats receive_time; // tempo dentro de zmq_recv (com mensagem)
+    // Só com zmq_bridge_set_envelope no socket que recebe
+    long long envelopes_received;
+    long long sequence_lost;       // números de sequência em falta
+    long long sequence_reordered;  // fora de ordem ou repetidos
+    zmq_bridge_time_stats latency; // envio -> receção, entre processos do mesmo host
+} zmq_bridge_socket_stats;
+
+// Contadores de zmq_bridge_get_pool_stats
+typedef struct zmq_bridge_pool_stats {
+    long long hits;          // buffers servidos pela cache do pool
+    long long misses;        // buffers alocados de novo
+    long long returned;      // buffers devolvidos à cache
+    long long released;      // buffers libertados (cache cheia ou fora das classes)
+    long long cached_bytes;  // memória guardada na cache
+    long long in_use;        // buffers entregues e ainda não devolvidos
+    long long handle_hits;   // mensagens de receive_borrowed reutilizadas
+    long long handle_misses; // mensagens de receive_borrowed alocadas de novo
+} zmq_bridge_pool_stats;
+
+// Configuração do contexto para zmq_bridge_init_ex. Os campos a -1 mantêm
+// o valor padrão (use zmq_bridge_config_init); no retorno, io_threads,
+// max_sockets, thread_sched_policy e thread_priority têm os valores efetivos.
+typedef struct zmq_bridge_config {
+    int io_threads;          // threads de I/O do libzmq (padrão: 1)
+    int max_sockets;         // limitado à capacidade da bridge (4096)
+    int thread_sched_policy; // ex.: SCHED_FIFO, para as threads de I/O
+    int thread_priority;
+    const int* affinity_cpus; // CPUs permitidos às threads de I/O (NULL: todos)
+    int affinity_cpu_count;
+} zmq_bridge_config;
+
+// Opções aplicadas na criação do socket, antes de bind/connect. Os campos
+// a -1 mantêm o valor padrão (use zmq_bridge_socket_options_init).
+typedef struct zmq_bridge_socket_options {
+    int sndhwm;
+    int rcvhwm;
+    int sndbuf;
+    int rcvbuf;
+    int linger;      // padrão da bridge: 0
+    int conflate;
+    int immediate;
+    int tcp_keepalive;
+    int tcp_keepalive_idle;
+    int tcp_keepalive_intvl;
+    int tcp_keepalive_cnt;
+    int sndtimeo;
+    int rcvtimeo;
+    long long affinity; // máscara de threads de I/O do contexto
+} zmq_bridge_socket_options;
+
+// Cabeçalho de um frame comprimido (ver zmq_bridge_decode_info)
+typedef struct zmq_bridge_frame_info {
+    int codec;
+    int width;
+    int height;
+    int channels;
+    int raw_size; // bytes depois de descomprimir
+} zmq_bridge_frame_info;
+
+// Dados de um slot de memória partilhada (ver zmq_bridge_shm_resolve)
+typedef struct zmq_bridge_shm_view {
+    const void* data; // dentro do segmento mapeado, só de leitura
+    int size;
+    int slot;           // -1 para frames com os dados no próprio frame
+    long long sequence;
+    const void* internal;
+} zmq_bridge_shm_view;
+
+// Contadores de um gravador ou de uma reprodução (zmq_bridge_recorder_*,
+// zmq_bridge_replayer_*)
+typedef struct zmq_bridge_log_stats {
+    long long messages;
+    long long bytes;    // payload, sem cabeçalhos
+    long long dropped;  // não gravadas, ou recusadas pelo socket de destino
+    long long segments;
+} zmq_bridge_log_stats;
  
 EXPORT_API int zmq_bridge_init();
+// Como zmq_bridge_init, mas com a configuração do contexto (config pode ser
+// NULL). Se o contexto já existir, a configuração é ignorada e são
+// devolvidos os valores em uso.
+EXPORT_API void zmq_bridge_config_init(zmq_bridge_config* config);
+EXPORT_API int zmq_bridge_init_ex(zmq_bridge_config* config);
 EXPORT_API void zmq_bridge_shutdown();
 
  
 EXPORT_API int zmq_bridge_create_publisher(const char* endpoint);
 EXPORT_API int zmq_bridge_create_subscriber(const char* endpoint,
                                             const char* topic);
+// Subscritor com ZMQ_CONFLATE: guarda apenas a última mensagem recebida.
+// O ZeroMQ não suporta CONFLATE com mensagens de vários frames, por isso o
+// publicador deve usar ZMQ_BRIDGE_LATEST_SINGLE_FRAME (o tópico fica no
+// início do próprio frame).
+EXPORT_API int zmq_bridge_create_subscriber_conflate(const char* endpoint,
+                                                     const char* topic);
+// Subscrições adicionais (ou removidas) num subscritor já criado; uma só
+// ligação pode assim transportar vários tópicos
+EXPORT_API int zmq_bridge_subscribe(int socket_id, const char* topic);
+EXPORT_API int zmq_bridge_unsubscribe(int socket_id, const char* topic);
 EXPORT_API int zmq_bridge_create_request(const char* endpoint);
 EXPORT_API int zmq_bridge_create_reply(const char* endpoint);
 EXPORT_API int zmq_bridge_create_push(const char* endpoint);
 EXPORT_API int zmq_bridge_create_pull(const char* endpoint);
 
+// Cria um socket de qualquer tipo ZMQ_BRIDGE_SOCKET_* aplicando options
+// (pode ser NULL) antes de bind (bind != 0) ou connect. topic só é usado
+// por sockets SUB (NULL subscreve tudo).
+EXPORT_API void zmq_bridge_socket_options_init(zmq_bridge_socket_options* options);
+EXPORT_API int zmq_bridge_create_socket_ex(int socket_type, const char* endpoint,
+                                           int bind,
+                                           const zmq_bridge_socket_options* options,
+                                           const char* topic);
+
+// Opções de um socket existente. HWM, buffers e IMMEDIATE só afetam as
+// ligações estabelecidas depois da alteração; para as aplicar a todas, use
+// as opções de zmq_bridge_create_socket_ex.
+EXPORT_API int zmq_bridge_set_option(int socket_id, int option, long long value);
+EXPORT_API int zmq_bridge_get_option(int socket_id, int option, long long* value);
+
  EXPORT_API int zmq_bridge_send(int socket_id, const void* data, int size);
 EXPORT_API int zmq_bridge_send_string(int socket_id, const char* message);
 EXPORT_API int zmq_bridge_publish(int socket_id, const char* topic,
                                   const void* data, int size);
 
- EXPORT_API int zmq_bridge_receive(int socket_id, void* buffer, int buffer_size,
+// Envia uma mensagem de frame_count frames, concatenados em data pela
+// ordem de envio; frame_sizes[i] é o tamanho do frame i. Todos os frames
+// são enviados com um único lock (o ZeroMQ entrega-os juntos ou nenhum).
+EXPORT_API int zmq_bridge_send_multipart(int socket_id, const void* data,
+                                         const int* frame_sizes,
+                                         int frame_count);
+
+// Publica vários (tópico, dados) de uma vez; itens consecutivos do mesmo
+// socket são enviados com um único lookup/lock. *items_sent indica quantos
+// foram enviados antes de um eventual erro.
+EXPORT_API int zmq_bridge_publish_batch(const zmq_bridge_publish_item* items,
+                                        int count, int* items_sent);
+
+// Envio sem cópia: a posse de data passa sempre para a biblioteca, mesmo
+// em caso de erro (size negativo, data NULL com size > 0, topic NULL), e
+// free_fn(data, hint) é chamada quando o libzmq terminar, ou logo no erro.
+// Com free_fn NULL, data tem de ter sido obtido com zmq_bridge_alloc_buffer.
+// Os buffers vêm de um pool por classes de tamanho, também usado pelas
+// cópias de 1 KB ou mais feitas nos envios normais; ao voltarem ao pool são
+// reutilizados em vez de passarem por malloc/free. O pool guarda no máximo
+// 64 MB e liberta as classes que deixam de ser usadas.
+EXPORT_API void* zmq_bridge_alloc_buffer(int size);
+EXPORT_API void zmq_bridge_free_buffer(void* buffer);
+EXPORT_API void zmq_bridge_get_pool_stats(zmq_bridge_pool_stats* stats);
+// Liberta a memória guardada pelo pool (também feito por zmq_bridge_shutdown)
+EXPORT_API void zmq_bridge_pool_trim();
+EXPORT_API int zmq_bridge_send_zero_copy(int socket_id, void* data, int size,
+                                         zmq_bridge_free_fn free_fn,
+                                         void* hint);
+EXPORT_API int zmq_bridge_publish_zero_copy(int socket_id, const char* topic,
+                                            void* data, int size,
+                                            zmq_bridge_free_fn free_fn,
+                                            void* hint);
+
+ // Truncam o frame ao tamanho do buffer sem o indicar; use
+// zmq_bridge_receive_ex para saber o tamanho real
+EXPORT_API int zmq_bridge_receive(int socket_id, void* buffer, int buffer_size,
                                   int* bytes_received);
 EXPORT_API int zmq_bridge_receive_string(int socket_id, char* buffer,
                                          int buffer_size);
+
+// Tamanho do próximo frame sem o consumir (ZMQ_BRIDGE_NO_MESSAGE se não
+// houver nenhum)
+EXPORT_API int zmq_bridge_peek_size(int socket_id, int* size);
+
+// Recebe o próximo frame; *message_size é sempre o tamanho completo e
+// *flags tem ZMQ_BRIDGE_MSG_*. Se o frame não couber em buffer, devolve
+// ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL e o frame fica para a chamada
+// seguinte; com ZMQ_BRIDGE_RECV_TRUNCATE em options, é entregue truncado
+// com ZMQ_BRIDGE_MSG_TRUNCATED.
+EXPORT_API int zmq_bridge_receive_ex(int socket_id, void* buffer,
+                                     int buffer_size, int options,
+                                     int* message_size, int* flags);
+
+// Recebe sem cópia: *data/*size apontam para o buffer do libzmq e
+// continuam válidos até zmq_bridge_release_message(*message)
+EXPORT_API int zmq_bridge_receive_borrowed(int socket_id, void** message,
+                                           const void** data, int* size);
+EXPORT_API void zmq_bridge_release_message(void* message);
+
+// Recebe até max_messages frames pendentes de uma vez, copiados em
+// sequência para buffer. Um frame que já não caiba fica para a chamada
+// seguinte; só o primeiro pode ser truncado (ZMQ_BRIDGE_MSG_TRUNCATED).
+EXPORT_API int zmq_bridge_receive_batch(int socket_id, void* buffer,
+                                        int buffer_size,
+                                        zmq_bridge_batch_entry* entries,
+                                        int max_messages,
+                                        int* messages_received);
+
+// Recebe todos os frames da próxima mensagem (ex.: [tópico][dados] de
+// zmq_bridge_publish), concatenados em buffer; frame_sizes[i] recebe o
+// tamanho do frame i e *total_size a soma dos tamanhos. Se a mensagem não
+// couber em buffer ou em max_frames, devolve
+// ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL com *frame_count e *total_size
+// necessários e a mensagem fica para a chamada seguinte.
+EXPORT_API int zmq_bridge_receive_multipart(int socket_id, void* buffer,
+                                            int buffer_size, int* frame_sizes,
+                                            int max_frames, int* frame_count,
+                                            int* total_size);
+
+// Tópicos como IDs inteiros: zmq_bridge_topic_register devolve um ID
+// pequeno (>= 0, o mesmo se o tópico já existir) e os IDs valem para todos
+// os sockets, como os esquemas. O tópico de uma mensagem é resolvido numa
+// trie de prefixos: conta o tópico registado mais longo que é prefixo do
+// frame de tópico (a regra das subscrições do ZeroMQ), ou
+// ZMQ_BRIDGE_TOPIC_NONE se nenhum for.
+EXPORT_API int zmq_bridge_topic_register(const char* topic);
+// Copia o nome do tópico com o terminador; devolve o seu tamanho
+EXPORT_API int zmq_bridge_topic_name(int topic_id, char* buffer, int buffer_size);
+// ID do tópico no início de data (ex.: frame de um callback)
+EXPORT_API int zmq_bridge_topic_match(const void* data, int size, int* topic_length);
+// Recebe [tópico][dados] com o ID do tópico em vez do texto; os dados
+// (frames seguintes, concatenados) vão para buffer. Numa mensagem de um só
+// frame, o tópico registado no início do frame é retirado dos dados. Se os
+// dados não couberem, devolve ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL com
+// *message_size necessário e a mensagem fica para a chamada seguinte.
+EXPORT_API int zmq_bridge_receive_topic(int socket_id, int* topic_id, void* buffer,
+                                        int buffer_size, int* message_size);
+
+// RPC assíncrono sobre DEALER/ROUTER, sem o passo fixo de REQ/REP: um
+// cliente pode ter muitos pedidos em curso e o servidor responde-lhes por
+// qualquer ordem. Também funciona com sockets DEALER/ROUTER criados por
+// zmq_bridge_create_socket_ex.
+EXPORT_API int zmq_bridge_create_rpc_client(const char* endpoint); // DEALER, connect
+EXPORT_API int zmq_bridge_create_rpc_server(const char* endpoint); // ROUTER, bind
+// Envia um pedido sem bloquear e devolve o seu ID em *request_id. Com
+// timeout_ms > 0, se a resposta não chegar a tempo o pedido é dado como
+// expirado e uma resposta tardia é descartada; o servidor também deixa de
+// o poder responder.
+EXPORT_API int zmq_bridge_rpc_request(int socket_id, const void* data, int size,
+                                      int timeout_ms, long long* request_id);
+// Próxima resposta (ZMQ_BRIDGE_OK), um pedido expirado
+// (ZMQ_BRIDGE_ERROR_TIMEOUT, indicado uma só vez) ou ZMQ_BRIDGE_NO_MESSAGE.
+// Se a resposta não couber, devolve ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL com
+// o tamanho em *reply_size e a resposta fica para a chamada seguinte.
+EXPORT_API int zmq_bridge_rpc_receive_reply(int socket_id, long long* request_id,
+                                            void* buffer, int buffer_size,
+                                            int* reply_size);
+// Desiste de um pedido em curso: deixa de contar para o limite de pedidos
+// pendentes (65536) e uma resposta tardia é descartada. Pedidos sem
+// timeout cuja resposta se perdeu (ex.: servidor reiniciado) só saem assim.
+// ZMQ_BRIDGE_ERROR_INVALID_HANDLE se o pedido já não estiver pendente.
+EXPORT_API int zmq_bridge_rpc_cancel(int socket_id, long long request_id);
+// Lado do servidor: *request_handle identifica o pedido em zmq_bridge_rpc_reply,
+// que pode ser chamada mais tarde e a partir de qualquer thread
+EXPORT_API int zmq_bridge_rpc_receive_request(int socket_id, long long* request_handle,
+                                              void* buffer, int buffer_size,
+                                              int* request_size);
+// ZMQ_BRIDGE_ERROR_TIMEOUT se o pedido já expirou ou já foi respondido
+EXPORT_API int zmq_bridge_rpc_reply(int socket_id, long long request_handle,
+                                    const void* data, int size);
+
 EXPORT_API int zmq_bridge_check_message(int socket_id); 
 
 
 EXPORT_API int zmq_bridge_poll(int socket_id, int timeout_ms);
 
 
+// Poller: espera por vários sockets com uma única chamada (zmq_poller).
+// zmq_bridge_poller_wait devolve o número de eventos escritos (0 no
+// timeout) ou um código de erro negativo. A espera não bloqueia os sockets:
+// enquanto um socket estiver num poller, só a thread que chama
+// zmq_bridge_poller_wait o deve usar (o libzmq não admite o mesmo socket em
+// duas threads ao mesmo tempo). Alterar o poller, ou fechar um dos seus
+// sockets, acorda uma espera em curso, que regressa com 0 eventos.
+EXPORT_API int zmq_bridge_poller_create();
+EXPORT_API int zmq_bridge_poller_add(int poller_id, int socket_id, int events);
+EXPORT_API int zmq_bridge_poller_modify(int poller_id, int socket_id,
+                                        int events);
+EXPORT_API int zmq_bridge_poller_remove(int poller_id, int socket_id);
+EXPORT_API int zmq_bridge_poller_wait(int poller_id,
+                                      zmq_bridge_poll_event* events,
+                                      int max_events, int timeout_ms);
+EXPORT_API void zmq_bridge_poller_destroy(int poller_id);
+
+
+// Reactor: uma thread de I/O dedicada faz os send/recv dos sockets ligados
+// e o chamador só usa filas SPSC (um produtor e um consumidor por sentido
+// e por socket; chamadas de várias threads ao mesmo socket são
+// serializadas por um mutex de cada sentido). Os frames novos são enviados no máximo ao fim de
+// idle_timeout_ms. zmq_bridge_reactor_send/publish devolvem
+// ZMQ_BRIDGE_ERROR_QUEUE_FULL se a fila de saída estiver cheia.
+EXPORT_API int zmq_bridge_reactor_start(int idle_timeout_ms);
+EXPORT_API void zmq_bridge_reactor_stop();
+EXPORT_API int zmq_bridge_reactor_attach(int socket_id, int queue_capacity);
+EXPORT_API int zmq_bridge_reactor_detach(int socket_id);
+EXPORT_API int zmq_bridge_reactor_send(int socket_id, const void* data,
+                                       int size);
+EXPORT_API int zmq_bridge_reactor_publish(int socket_id, const char* topic,
+                                          const void* data, int size);
+EXPORT_API int zmq_bridge_reactor_receive(int socket_id, void* buffer,
+                                          int buffer_size,
+                                          int* bytes_received, int* flags);
+// Tamanho do próximo frame da fila de entrada, sem o retirar
+EXPORT_API int zmq_bridge_reactor_peek_size(int socket_id, int* size);
+
+
+// Entrega por callback: uma thread nativa espera por todos os sockets com
+// callback e chama fn assim que uma mensagem completa chega, em vez de o
+// chamador fazer polling. fn corre nessa thread, sem o mutex do socket, e
+// deve regressar depressa (copiar os dados e sair). fn NULL remove o
+// callback; ao regressar, o callback anterior já não volta a ser chamado.
+// Um socket com callback não deve ser lido com zmq_bridge_receive* nem
+// ligado ao reactor; pode enviar a partir de outras threads (a thread só o
+// lê com o mutex do socket), mas um envio concorrente pode atrasar a
+// entrega de uma mensagem até 10 ms. Frames deixados por
+// zmq_bridge_receive_ex ou zmq_bridge_peek_size são entregues de imediato.
+// Fechar o socket remove o callback.
+EXPORT_API int zmq_bridge_set_callback(int socket_id,
+                                       zmq_bridge_message_callback fn,
+                                       void* user_data);
+
+
+// Publicação "último valor": por tópico só o frame mais recente fica à
+// espera de envio (triple buffer); os anteriores são substituídos em vez de
+// ficarem em fila. Uma thread própria envia para socket_id (ex.: um socket
+// de zmq_bridge_create_publisher). zmq_bridge_latest_create devolve um ID
+// ou um código de erro negativo. Isto limita a espera só do lado do
+// publicador: o PUB e os SUB continuam a ter as suas filas (HWM), e um
+// PUB cheio descarta sem avisar. Para que o subscritor também veja só o
+// valor mais recente, usar ZMQ_BRIDGE_LATEST_SINGLE_FRAME e
+// zmq_bridge_create_subscriber_conflate do lado que recebe.
+EXPORT_API int zmq_bridge_latest_create(int socket_id, int flags);
+EXPORT_API int zmq_bridge_latest_publish(int latest_id, const char* topic,
+                                         const void* data, int size);
+// Contadores de um tópico, ou de todos se topic for NULL
+EXPORT_API int zmq_bridge_latest_get_stats(int latest_id, const char* topic,
+                                           zmq_bridge_latest_stats* stats);
+EXPORT_API void zmq_bridge_latest_destroy(int latest_id);
+
+
+// Publicação a ritmo fixo: cada tópico registado com
+// zmq_bridge_scheduler_add_topic (ex.: "imu" a 200 Hz, "camera" a 30 Hz) é
+// enviado para socket_id por uma thread própria, em prazos absolutos
+// alinhados entre tópicos, em vez de ao ritmo do produtor.
+// zmq_bridge_scheduler_publish só substitui o último frame do tópico; cada
+// tick envia o mais recente, se houver um novo. rate_hz vai até 10000;
+// registar de novo um tópico muda o ritmo. zmq_bridge_scheduler_create
+// devolve um ID ou um código de erro negativo.
+EXPORT_API int zmq_bridge_scheduler_create(int socket_id);
+EXPORT_API int zmq_bridge_scheduler_add_topic(int scheduler_id, const char* topic,
+                                              double rate_hz, int flags);
+// ZMQ_BRIDGE_ERROR_TOPIC se o tópico não tiver sido registado
+EXPORT_API int zmq_bridge_scheduler_publish(int scheduler_id, const char* topic,
+                                            const void* data, int size);
+EXPORT_API int zmq_bridge_scheduler_get_stats(int scheduler_id, const char* topic,
+                                              zmq_bridge_schedule_stats* stats);
+EXPORT_API void zmq_bridge_scheduler_destroy(int scheduler_id);
+
+
+// Compressão assíncrona: zmq_bridge_publish_image copia o frame e regressa;
+// um pool de threads comprime-o com o codec do tópico e publica
+// [tópico][cabeçalho + dados comprimidos]. Os frames de um mesmo tópico
+// saem pela ordem de publicação. worker_threads <= 0 usa o número de
+// núcleos menos um; queue_capacity é o limite de frames em fila por thread
+// (ZMQ_BRIDGE_ERROR_QUEUE_FULL quando excedido).
+EXPORT_API int zmq_bridge_codec_available(int codec);
+EXPORT_API int zmq_bridge_encoder_start(int worker_threads, int queue_capacity);
+EXPORT_API void zmq_bridge_encoder_stop();
+// quality: 1-100 para JPEG, nível para zstd (<= 0 usa o padrão). O
+// socket tem de existir; fechá-lo esquece os codecs dos seus tópicos.
+EXPORT_API int zmq_bridge_set_topic_codec(int socket_id, const char* topic,
+                                          int codec, int quality);
+// size = width * height * channels (1, 3 ou 4 canais de 8 bits), até
+// INT_MAX bytes; fora disso devolve ZMQ_BRIDGE_ERROR_CODEC sem enfileirar
+EXPORT_API int zmq_bridge_publish_image(int socket_id, const char* topic,
+                                        const void* pixels, int width,
+                                        int height, int channels);
+
+// Lado do subscritor: lê o cabeçalho e descomprime um frame recebido
+EXPORT_API int zmq_bridge_decode_info(const void* frame, int size,
+                                      zmq_bridge_frame_info* info);
+EXPORT_API int zmq_bridge_decode(const void* frame, int size, void* buffer,
+                                 int buffer_size, int* bytes_written);
+
+
+// Registos binários de layout fixo (alternativa a JSON para telemetria).
+// Um esquema descreve os campos como "nome:tipo,..." com tipos u8, i8, u16,
+// i16, u32, i32, u64, i64, f32 e f64; cada registo é o cabeçalho seguido dos
+// campos em little-endian, sem padding. Emissor e recetor registam o mesmo
+// layout com o mesmo schema_id (1-65535). encode/decode trocam um double
+// por campo, pela ordem do esquema, sem alocar memória. Valores fora do
+// intervalo de um campo inteiro ficam no limite do tipo e NaN passa a 0;
+// u64/i64 acima de 2^53 perdem precisão no double (usar
+// zmq_bridge_record_set_int/get_int).
+EXPORT_API int zmq_bridge_schema_register(int schema_id, const char* layout);
+// Tamanho do registo com cabeçalho, ou código de erro negativo
+EXPORT_API int zmq_bridge_schema_record_size(int schema_id);
+EXPORT_API int zmq_bridge_schema_field_count(int schema_id);
+EXPORT_API int zmq_bridge_record_encode(int schema_id, const double* values,
+                                        int count, void* buffer,
+                                        int buffer_size, int* bytes_written);
+EXPORT_API int zmq_bridge_record_decode(const void* record, int size,
+                                        int* schema_id, double* values,
+                                        int max_values, int* count);
+// Lê ou escreve o campo field (índice no esquema) de um registo já
+// codificado como inteiro de 64 bits, sem passar por double (ex.:
+// timestamps em ns). Em campos u64, value leva o padrão de bits; campos
+// mais estreitos ficam no limite do tipo e campos f32/f64 são convertidos.
+EXPORT_API int zmq_bridge_record_set_int(void* record, int size, int field,
+                                         long long value);
+EXPORT_API int zmq_bridge_record_get_int(const void* record, int size, int field,
+                                         long long* value);
+// Codifica e publica [tópico][registo] (só [registo] se topic for NULL)
+EXPORT_API int zmq_bridge_publish_record(int socket_id, const char* topic,
+                                         int schema_id, const double* values,
+                                         int count);
+
+
+// Envelope de rastreio (opcional, por socket). Com enabled != 0, cada
+// mensagem enviada leva um frame de envelope antes do último frame
+// ([tópico][envelope][dados], ou [envelope][dados] sem tópico) e, ao
+// receber, o envelope é retirado e contabilizado em
+// zmq_bridge_socket_stats (latência num sentido e falhas na sequência).
+// A sequência conta por fluxo, identificado pelo primeiro frame da
+// mensagem: por tópico em PUB/SUB (um SUB que só subscreve alguns tópicos
+// não vê falhas nos outros) e por destino em respostas de ROUTER. Em
+// PUSH, ou DEALER ligado a vários pares, as mensagens de um fluxo são
+// repartidas e cada recetor conta como perdidas as que foram para os
+// outros; aí sequence_lost só é fiável com um recetor por emissor.
+// Emissor e recetor têm de o ativar. O instante de envio usa o
+// relógio monotónico do sistema, por isso a latência só faz sentido entre
+// processos do mesmo host. Não usar com ZMQ_CONFLATE, nem em sockets PUB
+// com mensagens sem tópico (o envelope passaria a ser o primeiro frame).
+// Cada socket segue no máximo ZMQ_BRIDGE_ENVELOPE_MAX_STREAMS fluxos por
+// sentido (ex.: um ROUTER vê uma identidade nova por ligação de DEALER).
+// Ao receber, os fluxos menos usados são esquecidos e recomeçam sem
+// contar perdas; ao enviar, o emissor muda de ID e todos os fluxos
+// recomeçam, como se o socket fosse reaberto.
+EXPORT_API int zmq_bridge_set_envelope(int socket_id, int enabled);
+
+
+// Transporte por memória partilhada para payloads grandes no mesmo host.
+// zmq_bridge_shm_create cria um segmento com nome (shm_open em POSIX,
+// CreateFileMapping no Windows) com slot_count slots de slot_size bytes,
+// usados em anel, e devolve um ID ou um código de erro negativo.
+// zmq_bridge_shm_publish copia os dados para o próximo slot e publica em
+// socket_id só uma notificação com o slot, a sequência e o tamanho. Se o
+// endpoint do socket não for local (ipc, inproc ou tcp em loopback, salvo
+// com ZMQ_BRIDGE_SHM_ALWAYS) ou a mensagem não couber num slot, os dados
+// seguem no frame, como em zmq_bridge_publish.
+EXPORT_API int zmq_bridge_shm_create(int socket_id, const char* name,
+                                     int slot_count, int slot_size, int flags);
+EXPORT_API int zmq_bridge_shm_publish(int shm_id, const char* topic,
+                                      const void* data, int size);
+EXPORT_API void zmq_bridge_shm_destroy(int shm_id);
+
+// Lado do subscritor: resolve um frame recebido. Devolve ZMQ_BRIDGE_OK com
+// view a apontar para o slot (sem cópia), ZMQ_BRIDGE_SHM_INLINE se o frame
+// não for uma notificação (view aponta para o frame) ou
+// ZMQ_BRIDGE_ERROR_SHM se o segmento não existir neste host ou o slot já
+// tiver sido reescrito. O anel não espera pelos leitores: depois de usar
+// os dados, zmq_bridge_shm_valid confirma que o slot não foi reescrito
+// entretanto (devolve 1, ou 0 e os dados lidos devem ser descartados).
+// Só são mapeados até 64 segmentos, com nomes válidos para
+// zmq_bridge_shm_create. Quando um segmento é recriado com o mesmo nome, as
+// vistas do anterior só podem ser usadas durante mais 10 s.
+EXPORT_API int zmq_bridge_shm_resolve(const void* frame, int size,
+                                      zmq_bridge_shm_view* view);
+EXPORT_API int zmq_bridge_shm_valid(const zmq_bridge_shm_view* view);
+
+// Gravação de sessões num log segmentado (<path>.000000.zbl, ...) com um
+// índice por instante (<path>.zbi). segment_size é o tamanho de cada
+// segmento mapeado em memória (de 64 KiB a 4 GiB); devolve um ID ou um código
+// de erro negativo. Cada socket é gravado num canal (0-65535):
+// zmq_bridge_recorder_tap grava as mensagens enviadas por socket_id, na
+// thread que envia; zmq_bridge_recorder_attach grava as recebidas, através
+// do callback do dispatcher (substitui um callback já definido).
+EXPORT_API int zmq_bridge_recorder_open(const char* path, long long segment_size);
+EXPORT_API int zmq_bridge_recorder_tap(int recorder_id, int socket_id, int channel);
+EXPORT_API int zmq_bridge_recorder_attach(int recorder_id, int socket_id, int channel);
+EXPORT_API int zmq_bridge_recorder_get_stats(int recorder_id, zmq_bridge_log_stats* stats);
+EXPORT_API void zmq_bridge_recorder_close(int recorder_id);
+
+// Reprodução de um log gravado: cada canal é enviado para o socket
+// indicado em zmq_bridge_replayer_route, numa thread própria. speed 1
+// respeita os intervalos gravados, 2 é duas vezes mais rápido e <= 0 envia
+// tão depressa quanto possível. start_ns > 0 salta para o primeiro registo
+// gravado a partir desse instante (ns desde o início da gravação). Com
+// speed > 0, as mensagens recusadas pelo socket (sem bloquear) contam em
+// dropped; com speed <= 0 a reprodução espera que o socket as aceite.
+EXPORT_API int zmq_bridge_replayer_open(const char* path);
+EXPORT_API int zmq_bridge_replayer_route(int replayer_id, int channel, int socket_id);
+EXPORT_API int zmq_bridge_replayer_start(int replayer_id, double speed, long long start_ns);
+EXPORT_API void zmq_bridge_replayer_stop(int replayer_id);
+// 1 enquanto houver registos por enviar
+EXPORT_API int zmq_bridge_replayer_is_running(int replayer_id);
+EXPORT_API int zmq_bridge_replayer_get_stats(int replayer_id, zmq_bridge_log_stats* stats);
+EXPORT_API void zmq_bridge_replayer_close(int replayer_id);
+
+// Métricas de um socket. Só lê contadores atómicos, sem bloquear o socket,
+// pelo que pode ser chamada a cada frame.
+EXPORT_API int zmq_bridge_get_stats(int socket_id, zmq_bridge_socket_stats* stats);
+EXPORT_API int zmq_bridge_reset_stats(int socket_id);
+
+
 EXPORT_API void zmq_bridge_close_socket(int socket_id);
 
 
+// Último erro da thread que chama. É guardado por thread, para que chamadas
+// concorrentes não troquem as mensagens umas das outras; por isso os erros
+// das threads internas (dispatcher, reactor, encoder, publicadores,
+// scheduler, reprodução) não aparecem aqui.
 EXPORT_API const char* zmq_bridge_get_last_error();
+// Último erro de uma thread interna (ex.: "reactor: Reactor send error:
+// ..."), copiado para buffer (truncado se não couber) e esquecido.
+// ZMQ_BRIDGE_NO_MESSAGE se não houver nenhum desde a última chamada.
+EXPORT_API int zmq_bridge_get_background_error(char* buffer, int buffer_size);
 }
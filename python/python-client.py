@@ -1,36 +1,591 @@
 import zmq
+import heapq
 import json
+import os
+import queue
 import time
+import random
+import re
+import struct
 import numpy as np
-from threading import Thread, Event
+from collections import deque
+from concurrent.futures import Future
+from threading import Thread, Event, Lock
 from typing import Callable, Dict, Any, Optional, List, Tuple
 
+# Frames comprimidos pela bridge (zmq_bridge_publish_image): cabeçalho
+# "ZBC1", codec, canais, largura, altura e tamanho original, seguido dos dados
+ENCODED_FRAME_MAGIC = b"ZBC1"
+ENCODED_FRAME_HEADER = struct.Struct("<4sBBHIII")
+
+CODEC_NONE = 0
+CODEC_LZ4 = 1
+CODEC_ZSTD = 2
+CODEC_JPEG = 3
+
+
+def is_encoded_frame(data: bytes) -> bool:
+    """Indica se data é um frame produzido por zmq_bridge_publish_image"""
+    return len(data) >= ENCODED_FRAME_HEADER.size and data[:4] == ENCODED_FRAME_MAGIC
+
+
+def decode_frame(data: bytes) -> Dict[str, Any]:
+    """
+    Descomprime um frame produzido por zmq_bridge_publish_image
+    
+    LZ4, zstd e JPEG precisam dos pacotes lz4, zstandard e Pillow,
+    respetivamente (importados apenas quando usados).
+    
+    Returns:
+        Dict com 'codec', 'width', 'height', 'channels' e 'image' (array
+        NumPy height x width x channels de uint8)
+    """
+    _, codec, channels, _, width, height, raw_size = ENCODED_FRAME_HEADER.unpack_from(data)
+    payload = memoryview(data)[ENCODED_FRAME_HEADER.size:]
+    
+    if codec == CODEC_NONE:
+        raw = bytes(payload)
+    elif codec == CODEC_LZ4:
+        import lz4.block
+        raw = lz4.block.decompress(payload, uncompressed_size=raw_size)
+    elif codec == CODEC_ZSTD:
+        import zstandard
+        raw = zstandard.ZstdDecompressor().decompress(payload, max_output_size=raw_size)
+    elif codec == CODEC_JPEG:
+        import io
+        from PIL import Image
+        raw = Image.open(io.BytesIO(payload)).tobytes()
+    else:
+        raise ValueError(f"Unknown codec {codec}")
+    
+    if len(raw) != raw_size:
+        raise ValueError("Decoded frame has unexpected size")
+    
+    image = np.frombuffer(raw, dtype=np.uint8)
+    if width > 0 and height > 0 and channels > 0 and raw_size == width * height * channels:
+        image = image.reshape((height, width, channels))
+    
+    return {'codec': codec, 'width': width, 'height': height, 'channels': channels, 'image': image}
+
+
+# Registos binários da bridge (zmq_bridge_publish_record): cabeçalho "ZR",
+# u16 schema_id e u32 tamanho dos campos, seguido dos campos em little-endian
+RECORD_MAGIC = b"ZR"
+RECORD_HEADER = struct.Struct("<2sHI")
+
+_FIELD_TYPES = {
+    'u8': '<u1', 'i8': '<i1', 'u16': '<u2', 'i16': '<i2', 'u32': '<u4',
+    'i32': '<i4', 'u64': '<u8', 'i64': '<i8', 'f32': '<f4', 'f64': '<f8',
+}
+
+# Esquemas dos registos (iguais em samples/server.cpp e samples/client.cpp)
+VEHICLE_SCHEMA = 1
+VEHICLE_LAYOUT = ("position_x:f64,position_y:f64,position_z:f64,"
+                  "speed:f32,throttle:f32,steering:f32,brake:f32")
+CONTROL_SCHEMA = 2
+CONTROL_LAYOUT = "throttle:f32,steering:f32,brake:f32"
+
+
+def schema_dtype(layout: str) -> np.dtype:
+    """Converte um layout "nome:tipo,..." num dtype estruturado NumPy empacotado"""
+    fields = []
+    for field in layout.split(','):
+        name, type_name = (part.strip() for part in field.split(':'))
+        fields.append((name, _FIELD_TYPES[type_name]))
+    return np.dtype(fields)
+
+
+# Esquemas conhecidos: schema_id -> dtype
+schemas: Dict[int, np.dtype] = {
+    VEHICLE_SCHEMA: schema_dtype(VEHICLE_LAYOUT),
+    CONTROL_SCHEMA: schema_dtype(CONTROL_LAYOUT),
+}
+
+
+def register_schema(schema_id: int, layout: str) -> np.dtype:
+    """Regista um esquema (o mesmo layout usado com zmq_bridge_schema_register)"""
+    schemas[schema_id] = schema_dtype(layout)
+    return schemas[schema_id]
+
+
+def is_record(data: bytes) -> bool:
+    """Indica se data é um registo binário da bridge"""
+    return len(data) >= RECORD_HEADER.size and data[:2] == RECORD_MAGIC
+
+
+def decode_record(data: bytes) -> Tuple[int, np.void]:
+    """
+    Lê um registo binário sem copiar os campos
+    
+    Returns:
+        (schema_id, registo) onde registo é uma vista np.void sobre data;
+        os campos acedem-se por nome, ex.: registo['speed']
+    """
+    _, schema_id, payload_size = RECORD_HEADER.unpack_from(data)
+    dtype = schemas[schema_id]
+    if payload_size != dtype.itemsize:
+        raise ValueError(f"Record does not match schema {schema_id}")
+    return schema_id, np.frombuffer(data, dtype=dtype, count=1, offset=RECORD_HEADER.size)[0]
+
+
+def encode_record(schema_id: int, *values) -> bytes:
+    """Cria um registo binário com os valores pela ordem do esquema"""
+    dtype = schemas[schema_id]
+    record = np.array([tuple(values)], dtype=dtype)
+    return RECORD_HEADER.pack(RECORD_MAGIC, schema_id, dtype.itemsize) + record.tobytes()
+
+
+# Envelope de rastreio (zmq_bridge_set_envelope): frame antes do último frame
+# com "ZBE1", u32 emissor, u64 número de sequência e i64 instante de envio em
+# ns. time.perf_counter_ns usa o mesmo relógio que std::chrono::steady_clock
+# (CLOCK_MONOTONIC no Linux, QueryPerformanceCounter no Windows), por isso a
+# latência só é válida entre processos do mesmo host.
+ENVELOPE_MAGIC = b"ZBE1"
+ENVELOPE = struct.Struct("<4sIQq")
+
+# Fluxos seguidos em cada sentido (ZMQ_BRIDGE_ENVELOPE_MAX_STREAMS)
+ENVELOPE_MAX_STREAMS = 4096
+
+
+class EnvelopeTracker:
+    """
+    Cria envelopes para os envios e contabiliza os recebidos
+    
+    A latência guarda as últimas `window` amostras; as perdas e as mensagens
+    fora de ordem são contadas por fluxo (emissor e primeiro frame da
+    mensagem, ex.: o tópico), como na bridge. Como na bridge, seguem-se no
+    máximo ENVELOPE_MAX_STREAMS fluxos em cada sentido.
+    """
+    
+    def __init__(self, window: int = 10000):
+        self.sender = random.getrandbits(32) or 1
+        self.sequence: Dict[bytes, int] = {}
+        self.lock = Lock()
+        self.latencies = deque(maxlen=window)
+        self.last_sequence: Dict[Tuple[int, bytes], int] = {}
+        self.received = 0
+        self.lost = 0
+        self.reordered = 0
+    
+    def make(self, key: bytes = b"") -> bytes:
+        """Envelope da próxima mensagem enviada no fluxo key (primeiro frame)"""
+        with self.lock:
+            if key not in self.sequence and len(self.sequence) >= ENVELOPE_MAX_STREAMS:
+                # Recomeça todos os fluxos com outro emissor
+                self.sequence.clear()
+                self.sender = random.getrandbits(32) or 1
+            sequence = self.sequence.get(key, 0)
+            self.sequence[key] = sequence + 1
+            sender = self.sender
+        return ENVELOPE.pack(ENVELOPE_MAGIC, sender, sequence, time.perf_counter_ns())
+    
+    def strip(self, frames: List[bytes]) -> List[bytes]:
+        """Retira e contabiliza o envelope (se existir) de uma mensagem multipart"""
+        if len(frames) < 2:
+            return frames
+        
+        envelope = frames[-2]
+        if len(envelope) != ENVELOPE.size or envelope[:4] != ENVELOPE_MAGIC:
+            return frames
+        
+        _, sender, sequence, sent_ns = ENVELOPE.unpack(envelope)
+        stream = (sender, frames[0] if len(frames) > 2 else b"")
+        latency = time.perf_counter_ns() - sent_ns
+        
+        with self.lock:
+            self.received += 1
+            if latency >= 0:
+                self.latencies.append(latency)
+            
+            # Ordem de inserção = ordem de uso: o fluxo vai para o fim e,
+            # com fluxos a mais, esquece-se o usado há mais tempo
+            last = self.last_sequence.pop(stream, None)
+            if last is None and len(self.last_sequence) >= ENVELOPE_MAX_STREAMS:
+                del self.last_sequence[next(iter(self.last_sequence))]
+            if last is None or sequence > last:
+                if last is not None:
+                    self.lost += sequence - last - 1
+                self.last_sequence[stream] = sequence
+            else:
+                self.reordered += 1
+                self.last_sequence[stream] = last
+        
+        return frames[:-2] + frames[-1:]
+    
+    def stats(self) -> Dict[str, Any]:
+        """Contadores e percentis da latência (ns), como em zmq_bridge_socket_stats"""
+        with self.lock:
+            latencies = np.array(self.latencies, dtype=np.int64)
+            stats = {'received': self.received, 'lost': self.lost, 'reordered': self.reordered}
+        
+        if latencies.size:
+            p50, p90, p99, p999 = np.percentile(latencies, [50, 90, 99, 99.9])
+            stats.update(p50_ns=int(p50), p90_ns=int(p90), p99_ns=int(p99),
+                         p999_ns=int(p999), max_ns=int(latencies.max()))
+        return stats
+
+
+class TopicTrie:
+    """
+    Tópicos registados como IDs pequenos, numa trie de prefixos
+    
+    match() devolve o tópico registado mais longo que é prefixo do tópico
+    recebido, a regra das subscrições do ZeroMQ (como zmq_bridge_topic_match).
+    """
+    
+    def __init__(self):
+        self.root: Dict[Any, Any] = {}
+        self.names: List[bytes] = []
+    
+    def register(self, topic: bytes) -> int:
+        """ID do tópico (o mesmo se já estiver registado)"""
+        node = self.root
+        for byte in topic:
+            node = node.setdefault(byte, {})
+        if None not in node:
+            node[None] = len(self.names)
+            self.names.append(topic)
+        return node[None]
+    
+    def match(self, topic: bytes) -> Tuple[int, int]:
+        """(ID, tamanho do tópico registado) ou (-1, 0) se nenhum for prefixo"""
+        node = self.root
+        best = (node.get(None, -1), 0)
+        for length, byte in enumerate(topic, 1):
+            node = node.get(byte)
+            if node is None:
+                break
+            if None in node:
+                best = (node[None], length)
+        return best
+
+
+# Memória partilhada da bridge (zmq_bridge_shm_publish): a mensagem só leva
+# uma notificação "ZBN1", u32 slot, u64 sequência, u64 token, u32 tamanho,
+# u16 tamanho do nome e u16 reservado, seguidos do nome do segmento. O
+# segmento começa com "ZBS1", u32 slots, u32 tamanho do slot, u32 distância
+# entre slots e u64 token; cada slot começa com a sua sequência (u64, ímpar
+# durante a escrita) e tem os dados a partir do byte 64.
+SHM_NOTIFY_MAGIC = b"ZBN1"
+SHM_NOTIFY = struct.Struct("<4sIQQIHH")
+SHM_SEGMENT_MAGIC = b"ZBS1"
+SHM_SEGMENT = struct.Struct("<4sIIIQ")
+SHM_SEQUENCE = struct.Struct("<Q")
+SHM_HEADER_SIZE = 64
+SHM_SLOT_HEADER_SIZE = 64
+# Limites do leitor, como em ShmReaders (os nomes vêm da rede)
+SHM_NAME_PATTERN = re.compile(r"[A-Za-z0-9_.-]{1,64}")
+SHM_MAX_MAPPINGS = 64
+SHM_MAX_RETIRED = 16
+SHM_RETIRED_SECONDS = 10.0
+
+
+def is_shm_notification(data: bytes) -> bool:
+    """Indica se data é uma notificação de zmq_bridge_shm_publish"""
+    return len(data) >= SHM_NOTIFY.size and data[:4] == SHM_NOTIFY_MAGIC
+
+
+class SharedMemoryReader:
+    """
+    Lê sem cópia os slots referidos pelas notificações de memória partilhada
+    
+    Cada segmento é mapeado uma vez, pelo nome. O publicador não espera
+    pelos leitores: a vista devolvida por resolve() só é fiável enquanto
+    valid() for True, por isso deve ser verificada depois de usar os dados.
+    """
+    
+    def __init__(self):
+        # nome -> (segmento, token, slots, tamanho do slot, distância entre slots)
+        self.segments: Dict[str, Tuple[Any, int, int, int, int]] = {}
+        # (instante, segmento) dos segmentos recriados com o mesmo nome;
+        # pode haver vistas para eles durante SHM_RETIRED_SECONDS
+        self.retired: List[Tuple[float, Any]] = []
+    
+    def _open(self, name: str, token: int):
+        from multiprocessing import shared_memory
+        
+        try:
+            # track=False (Python 3.13+): o resource_tracker não remove o
+            # segmento do publicador quando este processo termina
+            segment = shared_memory.SharedMemory(name=name, create=False, track=False)
+        except TypeError:
+            segment = shared_memory.SharedMemory(name=name, create=False)
+            if os.name != 'nt':
+                from multiprocessing import resource_tracker
+                resource_tracker.unregister(segment._name, "shared_memory")
+        
+        if segment.size < SHM_HEADER_SIZE:
+            segment.close()
+            return None
+        
+        magic, count, slot_size, stride, segment_token = SHM_SEGMENT.unpack_from(segment.buf)
+        if (magic != SHM_SEGMENT_MAGIC or segment_token != token
+                or segment.size < SHM_HEADER_SIZE + count * stride):
+            # Outro segmento com o mesmo nome (o publicador está noutro host)
+            segment.close()
+            return None
+        
+        return segment, segment_token, count, slot_size, stride
+    
+    def resolve(self, data: bytes) -> Optional[Tuple[np.ndarray, Callable[[], bool]]]:
+        """
+        Resolve uma notificação
+        
+        Returns:
+            (vista uint8 sobre o slot, valid) ou None se o segmento não
+            existir neste host ou o slot já tiver sido reescrito
+        """
+        _, slot, sequence, token, length, name_length, _ = SHM_NOTIFY.unpack_from(data)
+        if len(data) != SHM_NOTIFY.size + name_length:
+            return None
+        name = bytes(data[SHM_NOTIFY.size:]).decode('ascii', errors='replace')
+        
+        mapping = self.segments.get(name)
+        if mapping is None or mapping[1] != token:
+            if not SHM_NAME_PATTERN.fullmatch(name):
+                return None
+            self._expire_retired()
+            if mapping is None and len(self.segments) >= SHM_MAX_MAPPINGS:
+                return None
+            if mapping is not None and len(self.retired) >= SHM_MAX_RETIRED:
+                return None
+            try:
+                opened = self._open(name, token)
+            except (OSError, ValueError):
+                opened = None
+            if opened is None:
+                return None
+            # Só um segmento novo válido substitui o atual
+            if mapping is not None:
+                self.retired.append((time.monotonic(), mapping[0]))
+            mapping = opened
+            self.segments[name] = mapping
+        
+        segment, _, count, slot_size, stride = mapping
+        if slot >= count or length > slot_size:
+            return None
+        
+        base = SHM_HEADER_SIZE + slot * stride
+        
+        def valid() -> bool:
+            return SHM_SEQUENCE.unpack_from(segment.buf, base)[0] == sequence
+        
+        if not valid():
+            return None
+        
+        view = np.frombuffer(segment.buf, dtype=np.uint8, count=length,
+                             offset=base + SHM_SLOT_HEADER_SIZE)
+        return view, valid
+    
+    def _expire_retired(self):
+        """Desmapeia os segmentos retirados há mais de SHM_RETIRED_SECONDS"""
+        now = time.monotonic()
+        kept = []
+        for retired_at, segment in self.retired:
+            if now - retired_at < SHM_RETIRED_SECONDS:
+                kept.append((retired_at, segment))
+                continue
+            try:
+                segment.close()
+            except BufferError:
+                # Ainda há vistas NumPy para o segmento
+                kept.append((retired_at, segment))
+        self.retired = kept
+    
+    def close(self):
+        """Desmapeia os segmentos (os que ainda têm vistas ficam mapeados)"""
+        retired = [segment for _, segment in self.retired]
+        for segment in [mapping[0] for mapping in self.segments.values()] + retired:
+            try:
+                segment.close()
+            except BufferError:
+                pass
+        self.segments.clear()
+        self.retired.clear()
+
+
+# RPC da bridge (zmq_bridge_create_rpc_server): [cabeçalho][dados], com
+# cabeçalho "ZBQ1" (pedido) ou "ZBP1" (resposta), u32 timeout_ms e u64 ID
+RPC_REQUEST_MAGIC = b"ZBQ1"
+RPC_REPLY_MAGIC = b"ZBP1"
+RPC_HEADER = struct.Struct("<4sIQ")
+
+
+class RpcClient:
+    """
+    Pedidos assíncronos a um servidor RPC da bridge (socket DEALER)
+    
+    call() regressa logo com um Future; podem estar muitos pedidos em curso
+    e as respostas chegam por qualquer ordem. Um pedido sem resposta dentro
+    do prazo termina com TimeoutError e uma resposta tardia é descartada.
+    O DEALER só é usado pela thread interna; call() passa-lhe os pedidos por
+    um socket inproc.
+    """
+    
+    def __init__(self, context: zmq.Context, endpoint: str):
+        self.context = context
+        self.endpoint = endpoint
+        self.lock = Lock()
+        self.next_id = 1
+        self.pending: Dict[int, Future] = {}
+        self.stop_event = Event()
+        
+        # Tem de existir antes de a thread ligar a outra ponta
+        self.pipe_endpoint = f"inproc://rpc-client-{id(self)}"
+        self.pipe = context.socket(zmq.PAIR)
+        self.pipe.bind(self.pipe_endpoint)
+        
+        self.thread = Thread(target=self._run, daemon=True)
+        self.thread.start()
+    
+    def call(self, data: bytes, timeout: float = 1.0) -> Future:
+        """
+        Envia um pedido
+        
+        Args:
+            data: Dados do pedido
+            timeout: Prazo em segundos (0 ou None: sem prazo)
+            
+        Returns:
+            Future com os dados da resposta
+        """
+        future: Future = Future()
+        future.set_running_or_notify_cancel()
+        timeout_ms = int(timeout * 1000) if timeout else 0
+        
+        with self.lock:
+            if self.stop_event.is_set():
+                future.set_exception(RuntimeError("RPC client closed"))
+                return future
+            request_id = self.next_id
+            self.next_id += 1
+            self.pending[request_id] = future
+            self.pipe.send_multipart([RPC_HEADER.pack(RPC_REQUEST_MAGIC, timeout_ms, request_id), data])
+        return future
+    
+    def _complete(self, request_id: int, result: Any = None, error: Optional[BaseException] = None):
+        with self.lock:
+            future = self.pending.pop(request_id, None)
+        if future is None:
+            # Resposta tardia de um pedido que já expirou
+            return
+        if error is not None:
+            future.set_exception(error)
+        else:
+            future.set_result(result)
+    
+    def _run(self):
+        dealer = self.context.socket(zmq.DEALER)
+        dealer.setsockopt(zmq.LINGER, 0)
+        dealer.connect(self.endpoint)
+        
+        pipe = self.context.socket(zmq.PAIR)
+        pipe.connect(self.pipe_endpoint)
+        
+        poller = zmq.Poller()
+        poller.register(dealer, zmq.POLLIN)
+        poller.register(pipe, zmq.POLLIN)
+        
+        # (prazo, ID) por ordem de prazo
+        deadlines: List[Tuple[float, int]] = []
+        
+        while not self.stop_event.is_set():
+            timeout_ms = 100
+            if deadlines:
+                timeout_ms = min(timeout_ms, max(0, int((deadlines[0][0] - time.monotonic()) * 1000) + 1))
+            
+            events = dict(poller.poll(timeout=timeout_ms))
+            
+            if pipe in events:
+                while True:
+                    try:
+                        frames = pipe.recv_multipart(zmq.NOBLOCK)
+                    except zmq.Again:
+                        break
+                    _, timeout_ms, request_id = RPC_HEADER.unpack(frames[0])
+                    try:
+                        # Sem servidor ligado, o DEALER bloquearia
+                        dealer.send_multipart(frames, zmq.NOBLOCK)
+                    except zmq.ZMQError as e:
+                        self._complete(request_id, error=ConnectionError(f"RPC request not sent: {e}"))
+                        continue
+                    if timeout_ms:
+                        heapq.heappush(deadlines, (time.monotonic() + timeout_ms / 1000.0, request_id))
+            
+            if dealer in events:
+                while True:
+                    try:
+                        frames = dealer.recv_multipart(zmq.NOBLOCK)
+                    except zmq.Again:
+                        break
+                    if len(frames) != 2 or len(frames[0]) != RPC_HEADER.size:
+                        continue
+                    magic, _, request_id = RPC_HEADER.unpack(frames[0])
+                    if magic == RPC_REPLY_MAGIC:
+                        self._complete(request_id, result=frames[1])
+            
+            now = time.monotonic()
+            while deadlines and deadlines[0][0] <= now:
+                _, request_id = heapq.heappop(deadlines)
+                self._complete(request_id, error=TimeoutError(f"RPC request {request_id} timed out"))
+        
+        dealer.close()
+        pipe.close()
+    
+    def close(self):
+        """Para a thread; os pedidos em curso terminam com erro"""
+        with self.lock:
+            self.stop_event.set()
+        self.thread.join(timeout=1.0)
+        self.pipe.close()
+        
+        with self.lock:
+            pending, self.pending = self.pending, {}
+        for future in pending.values():
+            future.set_exception(RuntimeError("RPC client closed"))
+
+
 class SimulatorClient:
     """
     Cliente Python para comunicação com o simulador Unity via ZeroMQ
     """
     
-    def __init__(self, host: str = "localhost"):
+    def __init__(self, host: str = "localhost", envelope: bool = False):
         """
         Inicializa o cliente do simulador
         
         Args:
             host: Endereço do servidor (por padrão, localhost)
+            envelope: Usa o envelope de rastreio nos envios e receções; os
+                sockets do simulador também o têm de ativar
         """
         self.context = zmq.Context()
         self.host = host
-        self.subscribers = {}
         self.running = True
         
         # Flag para indicar que o cliente está conectado
         self.connected = False
         
-        # Dicionário para armazenar os callbacks de mensagens
-        self.message_callbacks = {}
+        # Tópicos registados e callbacks por ID de tópico
+        self.topics = TopicTrie()
+        self.message_callbacks: Dict[int, Callable] = {}
         
-        # Threads de polling
-        self.polling_threads = {}
-        self.stop_events = {}
+        # Uma única thread e um único SUB para todos os tópicos; os sockets
+        # só são usados nessa thread, que aplica as (des)subscrições pedidas
+        self.polling_thread: Optional[Thread] = None
+        self.stop_event = Event()
+        self.subscription_changes: "queue.Queue[Tuple[str, str, bool]]" = queue.Queue()
+        
+        # Envelope de rastreio (latência e perdas)
+        self.envelope = EnvelopeTracker() if envelope else None
+        
+        # Serviços do simulador (RPC), criado na primeira chamada
+        self.rpc: Optional[RpcClient] = None
+        
+        # Mensagens por memória partilhada (zmq_bridge_shm_publish)
+        self.shm_reader = SharedMemoryReader()
+        self.shm_dropped = 0
+        self.shm_overwritten = 0
     
     def connect(self) -> bool:
         """
@@ -58,88 +613,171 @@ class SimulatorClient:
             print(f"Failed to connect to simulator: {e}")
             return False
     
-    def subscribe(self, topic: str, callback: Callable[[Dict[str, Any]], None]) -> bool:
+    def subscribe(self, topic: str, callback: Callable[[Dict[str, Any]], None],
+                  conflate: bool = False) -> bool:
         """
         Subscreve a um tópico do simulador
         
+        Todos os tópicos partilham uma ligação; cada mensagem vai para o
+        callback do tópico subscrito mais longo que é prefixo do seu tópico.
+        
         Args:
             topic: Nome do tópico (ex: "camera", "vehicle", etc.)
             callback: Função de callback para processar as mensagens recebidas
+            conflate: Guarda só a última mensagem (ZMQ_CONFLATE); o simulador
+                deve publicar o tópico com ZMQ_BRIDGE_LATEST_SINGLE_FRAME. O
+                CONFLATE vale para o socket inteiro, por isso estes tópicos
+                usam um socket próprio
             
         Returns:
-            bool: True se a subscrição foi bem-sucedida, False caso contrário
+            bool: True se a subscrição foi pedida, False caso contrário
         """
-        try:
-            if topic in self.subscribers:
-                # Já existe uma subscrição para este tópico
-                self.message_callbacks[topic] = callback
-                return True
-            
-            # Cria um novo socket subscriber
-            subscriber = self.context.socket(zmq.SUB)
-            subscriber.connect(f"tcp://{self.host}:5555")
-            subscriber.setsockopt_string(zmq.SUBSCRIBE, topic)
-            
-            # Armazena o socket
-            self.subscribers[topic] = subscriber
-            
-            # Registra o callback
-            self.message_callbacks[topic] = callback
-            
-            # Inicia uma thread para polling deste tópico
-            stop_event = Event()
-            self.stop_events[topic] = stop_event
-            
-            thread = Thread(target=self._polling_thread, args=(topic, subscriber, callback, stop_event))
-            thread.daemon = True
-            thread.start()
-            
-            self.polling_threads[topic] = thread
-            
-            print(f"Subscribed to topic '{topic}'")
-            return True
-        except zmq.ZMQError as e:
-            print(f"Failed to subscribe to topic '{topic}': {e}")
+        topic_id = self.topics.register(topic.encode('utf-8'))
+        already_subscribed = topic_id in self.message_callbacks
+        self.message_callbacks[topic_id] = callback
+        
+        if not already_subscribed:
+            self.subscription_changes.put(('subscribe', topic, conflate))
+        
+        if self.polling_thread is None:
+            self.polling_thread = Thread(target=self._polling_thread, daemon=True)
+            self.polling_thread.start()
+        
+        print(f"Subscribed to topic '{topic}'")
+        return True
+    
+    def unsubscribe(self, topic: str) -> bool:
+        """
+        Cancela a subscrição de um tópico
+        
+        Returns:
+            bool: False se o tópico não estava subscrito
+        """
+        topic_id, length = self.topics.match(topic.encode('utf-8'))
+        if length != len(topic.encode('utf-8')) or self.message_callbacks.pop(topic_id, None) is None:
             return False
+        
+        self.subscription_changes.put(('unsubscribe', topic, False))
+        return True
     
-    def _polling_thread(self, topic: str, socket: zmq.Socket, callback: Callable, stop_event: Event):
+    def _apply_subscription_changes(self, subscriber: zmq.Socket, poller: zmq.Poller,
+                                    conflated: Dict[zmq.Socket, int]):
+        """Aplica na thread de polling as (des)subscrições pedidas"""
+        while True:
+            try:
+                action, topic, conflate = self.subscription_changes.get_nowait()
+            except queue.Empty:
+                return
+            
+            topic_bytes = topic.encode('utf-8')
+            try:
+                if action == 'subscribe' and conflate:
+                    socket = self.context.socket(zmq.SUB)
+                    # Tem de ser definido antes de connect
+                    socket.setsockopt(zmq.CONFLATE, 1)
+                    socket.connect(f"tcp://{self.host}:5555")
+                    socket.setsockopt(zmq.SUBSCRIBE, topic_bytes)
+                    poller.register(socket, zmq.POLLIN)
+                    conflated[socket] = self.topics.register(topic_bytes)
+                elif action == 'subscribe':
+                    subscriber.setsockopt(zmq.SUBSCRIBE, topic_bytes)
+                else:
+                    subscriber.setsockopt(zmq.UNSUBSCRIBE, topic_bytes)
+                    for socket, topic_id in list(conflated.items()):
+                        if self.topics.names[topic_id] == topic_bytes:
+                            poller.unregister(socket)
+                            socket.close()
+                            del conflated[socket]
+            except zmq.ZMQError as e:
+                print(f"Failed to {action} topic '{topic}': {e}")
+    
+    def _decode_message(self, data: bytes) -> Dict[str, Any]:
+        """Converte os dados de uma mensagem no dicionário passado ao callback"""
+        if is_record(data):
+            # Registo binário: campos lidos diretamente do frame
+            schema_id, record = decode_record(data)
+            return {'schema_id': schema_id, 'record': record}
+        if is_encoded_frame(data):
+            # Frame comprimido pela bridge
+            return decode_frame(data)
+        # Tenta decodificar como JSON
+        try:
+            return json.loads(data)
+        except (json.JSONDecodeError, UnicodeDecodeError):
+            # Não é JSON, trata como dados binários
+            return {'raw_data': data}
+    
+    def _deliver_shared(self, callback: Callable, data: bytes):
         """
-        Thread interna para polling de mensagens de um tópico
+        Entrega os dados de um slot de memória partilhada sem os copiar
         
-        Args:
-            topic: Nome do tópico
-            socket: Socket ZeroMQ
-            callback: Função de callback
-            stop_event: Evento para sinalizar parada da thread
+        O callback recebe {'raw_data': vista NumPy sobre o slot, 'shared':
+        True, 'valid': função}. A vista só pode ser usada durante o
+        callback (copiar com .copy() para a guardar) e valid() indica se o
+        slot ainda não foi reescrito pelo publicador.
+        """
+        resolved = self.shm_reader.resolve(data)
+        if resolved is None:
+            # Segmento noutro host, ou slot já reescrito antes da leitura
+            self.shm_dropped += 1
+            return
+        
+        view, valid = resolved
+        callback({'raw_data': view, 'shared': True, 'valid': valid})
+        if not valid():
+            self.shm_overwritten += 1
+    
+    def _polling_thread(self):
+        """
+        Thread interna que recebe as mensagens de todos os tópicos
+        
+        O tópico de cada mensagem é resolvido para um ID na trie, sem
+        decodificar nem comparar strings.
         """
+        subscriber = self.context.socket(zmq.SUB)
+        subscriber.connect(f"tcp://{self.host}:5555")
+        
         poller = zmq.Poller()
-        poller.register(socket, zmq.POLLIN)
+        poller.register(subscriber, zmq.POLLIN)
+        
+        # Sockets com CONFLATE -> ID do seu tópico
+        conflated: Dict[zmq.Socket, int] = {}
         
-        while not stop_event.is_set():
-            socks = dict(poller.poll(timeout=100))
+        while not self.stop_event.is_set():
+            self._apply_subscription_changes(subscriber, poller, conflated)
             
-            if socket in socks and socks[socket] == zmq.POLLIN:
+            for socket, _ in poller.poll(timeout=100):
                 try:
-                    # Recebe a mensagem
-                    topic_recv, data = socket.recv_multipart()
-                    
-                    # Decodifica o tópico
-                    topic_str = topic_recv.decode('utf-8')
+                    if socket in conflated:
+                        # Um só frame [tópico + dados]
+                        topic_id = conflated[socket]
+                        frame = socket.recv()
+                        data = frame[len(self.topics.names[topic_id]):]
+                    else:
+                        frames = socket.recv_multipart()
+                        if self.envelope:
+                            frames = self.envelope.strip(frames)
+                        topic_id, _ = self.topics.match(frames[0])
+                        data = frames[-1]
                     
-                    # Tenta decodificar como JSON
-                    try:
-                        message = json.loads(data)
-                    except json.JSONDecodeError:
-                        # Não é JSON, trata como dados binários
-                        message = {'raw_data': data}
+                    callback = self.message_callbacks.get(topic_id)
+                    if callback is None:
+                        continue
                     
-                    # Chama o callback
-                    callback(message)
+                    if is_shm_notification(data):
+                        self._deliver_shared(callback, data)
+                    else:
+                        callback(self._decode_message(data))
                 except zmq.ZMQError as e:
                     if self.running:
-                        print(f"Error receiving message on topic '{topic}': {e}")
+                        print(f"Error receiving message: {e}")
                 except Exception as e:
-                    print(f"Error processing message on topic '{topic}': {e}")
+                    print(f"Error processing message: {e}")
+        
+        subscriber.close()
+        for socket in conflated:
+            socket.close()
+        self.shm_reader.close()
     
     def send_command(self, command: str, params: Optional[Dict[str, Any]] = None) -> bool:
         """
@@ -166,7 +804,7 @@ class SimulatorClient:
             }
             
             json_message = json.dumps(message)
-            self.command_socket.send_multipart([b"command", json_message.encode('utf-8')])
+            self.command_socket.send_multipart(self._frames(b"command", json_message.encode('utf-8')))
             return True
         except zmq.ZMQError as e:
             print(f"Failed to send command '{command}': {e}")
@@ -189,36 +827,71 @@ class SimulatorClient:
             return False
         
         try:
-            control = {
-                'throttle': float(throttle),
-                'steering': float(steering),
-                'brake': float(brake)
-            }
-            
-            json_control = json.dumps(control)
-            self.control_socket.send_string(json_control)
+            record = encode_record(CONTROL_SCHEMA, throttle, steering, brake)
+            self.control_socket.send_multipart(self._frames(record))
             return True
         except zmq.ZMQError as e:
             print(f"Failed to send vehicle control: {e}")
             return False
     
+    def call_service(self, service: str, params: Optional[Dict[str, Any]] = None,
+                     timeout: float = 1.0) -> Future:
+        """
+        Chama um serviço do simulador (ex.: spawn de atores, raycasts) sem
+        esperar pelos pedidos anteriores
+        
+        Args:
+            service: Nome do serviço
+            params: Parâmetros do serviço (opcional)
+            timeout: Prazo em segundos
+            
+        Returns:
+            Future com a resposta (JSON decodificado, ou bytes)
+        """
+        if self.rpc is None:
+            self.rpc = RpcClient(self.context, f"tcp://{self.host}:5558")
+        
+        request = json.dumps({'service': service, 'params': params or {}}).encode('utf-8')
+        reply: Future = Future()
+        reply.set_running_or_notify_cancel()
+        
+        def on_done(future: Future):
+            error = future.exception()
+            if error is not None:
+                reply.set_exception(error)
+                return
+            try:
+                reply.set_result(json.loads(future.result()))
+            except (json.JSONDecodeError, UnicodeDecodeError):
+                reply.set_result(future.result())
+        
+        self.rpc.call(request, timeout).add_done_callback(on_done)
+        return reply
+    
+    def _frames(self, *frames: bytes) -> List[bytes]:
+        """Frames a enviar, com o envelope antes do último se estiver ativo"""
+        if not self.envelope:
+            return list(frames)
+        key = frames[0] if len(frames) > 1 else b""
+        return list(frames[:-1]) + [self.envelope.make(key), frames[-1]]
+    
+    def envelope_stats(self) -> Dict[str, Any]:
+        """Latência e perdas das mensagens recebidas com envelope"""
+        return self.envelope.stats() if self.envelope else {}
+    
     def close(self):
         """
         Fecha a conexão com o simulador
         """
         self.running = False
         
-        # Para todas as threads de polling
-        for topic, event in self.stop_events.items():
-            event.set()
+        # Para a thread de polling (fecha os sockets de subscrição)
+        self.stop_event.set()
+        if self.polling_thread is not None:
+            self.polling_thread.join(timeout=1.0)
         
-        # Aguarda as threads terminarem
-        for topic, thread in self.polling_threads.items():
-            thread.join(timeout=1.0)
-        
-        # Fecha todos os sockets
-        for topic, socket in self.subscribers.items():
-            socket.close()
+        if self.rpc is not None:
+            self.rpc.close()
         
         if hasattr(self, 'command_socket'):
             self.command_socket.close()
@@ -241,7 +914,10 @@ if __name__ == "__main__":
         try:
             # Callback para dados da câmera
             def on_camera_data(data):
-                if 'raw_data' in data:
+                if 'image' in data:
+                    # Imagem descomprimida (zmq_bridge_publish_image)
+                    print(f"Received camera frame: {data['width']}x{data['height']}x{data['channels']}")
+                elif 'raw_data' in data:
                     # Dados binários da imagem
                     print(f"Received camera data: {len(data['raw_data'])} bytes")
                 else:
@@ -249,7 +925,12 @@ if __name__ == "__main__":
             
             # Callback para dados do veículo
             def on_vehicle_data(data):
-                print(f"Received vehicle data: {data}")
+                if 'record' in data:
+                    record = data['record']
+                    print(f"Received vehicle data: position=({record['position_x']:.2f}, "
+                          f"{record['position_y']:.2f}), speed={record['speed']:.2f}")
+                else:
+                    print(f"Received vehicle data: {data}")
             
             # Subscreve aos tópicos
             client.subscribe("camera", on_camera_data)
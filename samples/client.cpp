@@ -3,9 +3,20 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <algorithm>
+#include <vector>
 #include <zmq.hpp>
 #include <ZMQBridge.h>
 
+// Esquemas dos registos binários (iguais em server.cpp e python-client.py)
+static const int kVehicleSchema = 1;
+static const char* kVehicleLayout =
+    "position_x:f64,position_y:f64,position_z:f64,"
+    "speed:f32,throttle:f32,steering:f32,brake:f32";
+
+static const int kControlSchema = 2;
+static const char* kControlLayout = "throttle:f32,steering:f32,brake:f32";
+
  
 int main(int argc, char* argv[])
 {
@@ -26,6 +37,9 @@ int main(int argc, char* argv[])
         return 1;
     }
 
+    zmq_bridge_schema_register(kVehicleSchema, kVehicleLayout);
+    zmq_bridge_schema_register(kControlSchema, kControlLayout);
+
     // Cria sockets de comunicação
     int sub_socket = zmq_bridge_create_subscriber(
         ("tcp://" + server_address + ":5555").c_str(),
@@ -50,28 +64,57 @@ int main(int argc, char* argv[])
 
     // Thread para receber dados
     std::thread recv_thread([&]() {
-        char buffer[8192];
+        std::vector<char> buffer(8192);
+        std::vector<int> frame_sizes(2);
 
         while (running)
         {
             // Verifica por mensagens
             if (zmq_bridge_poll(sub_socket, 100) > 0)
             {
-                if (zmq_bridge_receive_string(sub_socket, buffer,
-                                              sizeof(buffer))
-                    == 0)
+                // Recebe [tópico][dados] numa só chamada
+                int frame_count = 0;
+                int total_size = 0;
+
+                int result = zmq_bridge_receive_multipart(
+                    sub_socket, buffer.data(), static_cast<int>(buffer.size()) - 1,
+                    frame_sizes.data(), static_cast<int>(frame_sizes.size()),
+                    &frame_count, &total_size);
+
+                if (result == ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL)
+                {
+                    // A mensagem continua pendente: aumenta os buffers e tenta de novo
+                    buffer.resize(std::max(buffer.size(), static_cast<size_t>(total_size) + 1));
+                    frame_sizes.resize(std::max(frame_sizes.size(),
+                                                static_cast<size_t>(frame_count)));
+                    continue;
+                }
+
+                if (result != ZMQ_BRIDGE_OK || frame_count != 2)
                 {
-                    // O primeiro frame é o tópico
-                    std::string topic(buffer);
-
-                    // Recebe o segundo frame (dados)
-                    if (zmq_bridge_receive_string(sub_socket, buffer,
-                                                  sizeof(buffer))
-                        == 0)
-                    {
-                        std::cout << "Received data from topic '" << topic
-                                  << "': " << buffer << std::endl;
-                    }
+                    continue;
+                }
+
+                std::string topic(buffer.data(), frame_sizes[0]);
+                char* data = buffer.data() + frame_sizes[0];
+                int size = frame_sizes[1];
+
+                int schema_id = 0;
+                int count = 0;
+                double values[7];
+
+                if (zmq_bridge_record_decode(data, size, &schema_id, values, 7, &count)
+                        == ZMQ_BRIDGE_OK
+                    && schema_id == kVehicleSchema)
+                {
+                    std::cout << "Vehicle: position=(" << values[0] << ","
+                              << values[1] << "), speed=" << values[3] << std::endl;
+                }
+                else
+                {
+                    data[size] = '\0';
+                    std::cout << "Received data from topic '" << topic
+                              << "': " << data << std::endl;
                 }
             }
         }
@@ -141,15 +184,17 @@ int main(int argc, char* argv[])
                 continue;
             }
 
-            // Cria mensagem de controle
-            char control_msg[256];
-            snprintf(control_msg, sizeof(control_msg),
-                     "{\"throttle\":%.2f,\"steering\":%.2f,\"brake\":%.2f}",
-                     throttle, steering, brake);
-
-            // Envia controles
-            std::cout << "Sending control: " << control_msg << std::endl;
-            zmq_bridge_send_string(ctrl_socket, control_msg);
+            // Envia controles como registo binário
+            const double controls[] = { throttle, steering, brake };
+            char control_msg[64];
+            int size = 0;
+            zmq_bridge_record_encode(kControlSchema, controls, 3, control_msg,
+                                     sizeof(control_msg), &size);
+
+            std::cout << "Sending control: throttle=" << throttle
+                      << ", steering=" << steering << ", brake=" << brake
+                      << std::endl;
+            zmq_bridge_send(ctrl_socket, control_msg, size);
         } catch (const std::exception& e)
         {
             std::cerr << "Error: " << e.what() << std::endl;
@@ -6,19 +6,38 @@
 #include <zmq.hpp>
 #include <ZMQBridge.h>
 
+// Esquemas dos registos binários (iguais em client.cpp e python-client.py)
+static const int kVehicleSchema = 1;
+static const char* kVehicleLayout =
+    "position_x:f64,position_y:f64,position_z:f64,"
+    "speed:f32,throttle:f32,steering:f32,brake:f32";
+
+static const int kControlSchema = 2;
+static const char* kControlLayout = "throttle:f32,steering:f32,brake:f32";
+
 // Exemplo de servidor simulando um simulador Unity
 int main(int argc, char* argv[])
 {
     std::cout << "Starting ZeroMQ server example..." << std::endl;
 
-    // Inicializa a biblioteca
-    if (zmq_bridge_init() != 0)
+    // Inicializa a biblioteca com uma thread de I/O por núcleo disponível
+    zmq_bridge_config config;
+    zmq_bridge_config_init(&config);
+    config.io_threads = static_cast<int>(std::thread::hardware_concurrency());
+
+    if (zmq_bridge_init_ex(&config) != 0)
     {
         std::cerr << "Failed to initialize ZeroMQ bridge: "
                   << zmq_bridge_get_last_error() << std::endl;
         return 1;
     }
 
+    std::cout << "I/O threads: " << config.io_threads
+              << ", max sockets: " << config.max_sockets << std::endl;
+
+    zmq_bridge_schema_register(kVehicleSchema, kVehicleLayout);
+    zmq_bridge_schema_register(kControlSchema, kControlLayout);
+
     // Cria sockets de comunicação
     int pub_socket = zmq_bridge_create_publisher("tcp://*:5555");
     int cmd_socket = zmq_bridge_create_pull("tcp://*:5556");
@@ -48,89 +67,120 @@ int main(int argc, char* argv[])
     double position_y = 0.0;
     double speed = 0.0;
 
-    // Thread para receber comandos
-    std::thread cmd_thread([&]() {
-        char buffer[1024];
+    // Processa um comando recebido
+    auto handle_command = [&](const char* buffer) {
+        std::cout << "Received command: " << buffer << std::endl;
 
-        while (running)
+        // Processa o comando
+        std::string cmd(buffer);
+        if (cmd.find("reset") != std::string::npos)
         {
-            // Verifica por comandos
-            if (zmq_bridge_poll(cmd_socket, 100) > 0)
-            {
-                if (zmq_bridge_receive_string(cmd_socket, buffer,
-                                              sizeof(buffer))
-                    == 0)
-                {
-                    std::cout << "Received command: " << buffer << std::endl;
+            // Reseta a simulação
+            throttle = 0.0;
+            steering = 0.0;
+            brake = 0.0;
+            position_x = 0.0;
+            position_y = 0.0;
+            speed = 0.0;
+            std::cout << "Simulation reset" << std::endl;
+        }
+    };
+
+    // Processa um controle recebido
+    auto handle_control = [&](const char* buffer, int size) {
+        // Registo binário: leitura direta dos campos, sem parsing de texto
+        int schema_id = 0;
+        int count = 0;
+        double values[3];
+        if (zmq_bridge_record_decode(buffer, size, &schema_id, values, 3, &count)
+                == ZMQ_BRIDGE_OK
+            && schema_id == kControlSchema)
+        {
+            throttle = values[0];
+            steering = values[1];
+            brake = values[2];
+            return;
+        }
 
-                    // Processa o comando
-                    std::string cmd(buffer);
-                    if (cmd.find("reset") != std::string::npos)
-                    {
-                        // Reseta a simulação
-                        throttle = 0.0;
-                        steering = 0.0;
-                        brake = 0.0;
-                        position_x = 0.0;
-                        position_y = 0.0;
-                        speed = 0.0;
-                        std::cout << "Simulation reset" << std::endl;
-                    }
-                }
-            }
+        // Compatibilidade com clientes que ainda enviam JSON
+        std::string ctrl(buffer, size);
+        std::cout << "Received control: " << ctrl << std::endl;
+
+        // Extração simples de valores
+        size_t throttle_pos = ctrl.find("\"throttle\":");
+        size_t steering_pos = ctrl.find("\"steering\":");
+        size_t brake_pos = ctrl.find("\"brake\":");
+
+        if (throttle_pos != std::string::npos)
+        {
+            throttle_pos += 11; // Comprimento de "\"throttle\":"
+            throttle = std::stod(ctrl.substr(
+                throttle_pos, ctrl.find(',', throttle_pos) - throttle_pos));
         }
-    });
 
-    // Thread para receber controles
-    std::thread ctrl_thread([&]() {
-        char buffer[1024];
+        if (steering_pos != std::string::npos)
+        {
+            steering_pos += 11; // Comprimento de "\"steering\":"
+            steering = std::stod(ctrl.substr(
+                steering_pos, ctrl.find(',', steering_pos) - steering_pos));
+        }
 
-        while (running)
+        if (brake_pos != std::string::npos)
         {
-            // Verifica por controles
-            if (zmq_bridge_poll(ctrl_socket, 100) > 0)
-            {
-                if (zmq_bridge_receive_string(ctrl_socket, buffer,
-                                              sizeof(buffer))
-                    == 0)
-                {
-                    std::cout << "Received control: " << buffer << std::endl;
+            brake_pos += 8; // Comprimento de "\"brake\":"
+            brake = std::stod(
+                ctrl.substr(brake_pos, ctrl.find('}', brake_pos) - brake_pos));
+        }
+    };
 
-                    // Processa o controle
-                    std::string ctrl(buffer);
+    // Um único poller vigia os sockets de comandos e de controles
+    int poller = zmq_bridge_poller_create();
+    zmq_bridge_poller_add(poller, cmd_socket, ZMQ_BRIDGE_POLLIN);
+    zmq_bridge_poller_add(poller, ctrl_socket, ZMQ_BRIDGE_POLLIN);
 
-                    // Extração simples de valores
-                    size_t throttle_pos = ctrl.find("\"throttle\":");
-                    size_t steering_pos = ctrl.find("\"steering\":");
-                    size_t brake_pos = ctrl.find("\"brake\":");
+    // Thread para receber comandos e controles
+    std::thread recv_thread([&]() {
+        char buffer[1024];
+        zmq_bridge_poll_event events[2];
 
-                    if (throttle_pos != std::string::npos)
-                    {
-                        throttle_pos += 11; // Comprimento de "\"throttle\":"
-                        throttle = std::stod(ctrl.substr(
-                            throttle_pos,
-                            ctrl.find(',', throttle_pos) - throttle_pos));
-                    }
+        while (running)
+        {
+            int count = zmq_bridge_poller_wait(poller, events, 2, 100);
+
+            for (int i = 0; i < count; ++i)
+            {
+                int socket_id = events[i].socket_id;
 
-                    if (steering_pos != std::string::npos)
+                // Esvazia o socket pronto
+                int size = 0;
+                while (zmq_bridge_receive(socket_id, buffer, sizeof(buffer) - 1,
+                                          &size)
+                       == 0)
+                {
+                    if (socket_id == cmd_socket)
                     {
-                        steering_pos += 11; // Comprimento de "\"steering\":"
-                        steering = std::stod(ctrl.substr(
-                            steering_pos,
-                            ctrl.find(',', steering_pos) - steering_pos));
+                        buffer[size] = '\0';
+                        handle_command(buffer);
                     }
-
-                    if (brake_pos != std::string::npos)
+                    else
                     {
-                        brake_pos += 8; // Comprimento de "\"brake\":"
-                        brake = std::stod(ctrl.substr(
-                            brake_pos, ctrl.find('}', brake_pos) - brake_pos));
+                        handle_control(buffer, size);
                     }
                 }
             }
         }
     });
 
+    // A câmera sai a ritmo fixo pela thread do scheduler, com o frame mais
+    // recente em cada tick
+    int camera_scheduler = zmq_bridge_scheduler_create(pub_socket);
+    zmq_bridge_scheduler_add_topic(camera_scheduler, "camera", 10.0, 0);
+
+    // Passo da simulação com prazos absolutos: o tempo gasto em cada
+    // iteração não se acumula em deriva
+    const auto step = std::chrono::milliseconds(100);
+    auto next_step = std::chrono::steady_clock::now() + step;
+
     // Loop principal - simula e publica dados
     while (running)
     {
@@ -155,22 +205,17 @@ int main(int argc, char* argv[])
             position_x += speed * steering * 0.05;
             position_y += speed * 0.1;
 
-            // Prepara os dados do veículo
-            char vehicle_data[256];
-            snprintf(vehicle_data, sizeof(vehicle_data),
-                     "{\"position\":[%.2f,%.2f,0.0],\"speed\":%.2f,"
-                     "\"throttle\":%.2f,\"steering\":%.2f,\"brake\":%.2f}",
-                     position_x, position_y, speed, throttle, steering, brake);
-
-            // Publica os dados do veículo
-            zmq_bridge_publish(pub_socket, "vehicle", vehicle_data,
-                               strlen(vehicle_data));
+            // Publica os dados do veículo como registo binário
+            const double vehicle_state[] = { position_x, position_y, 0.0,   speed,
+                                             throttle,   steering,   brake };
+            zmq_bridge_publish_record(pub_socket, "vehicle", kVehicleSchema,
+                                      vehicle_state, 7);
 
             // Simula dados da câmera (apenas uma string simples neste exemplo)
             const char* camera_data = "Simulated camera data (would be binary "
                                       "image data in a real scenario)";
-            zmq_bridge_publish(pub_socket, "camera", camera_data,
-                               strlen(camera_data));
+            zmq_bridge_scheduler_publish(camera_scheduler, "camera", camera_data,
+                                         static_cast<int>(strlen(camera_data)));
 
             // A cada segundo, mostra o estado da simulação
             std::cout << "Vehicle state: position=(" << position_x << ","
@@ -179,9 +224,16 @@ int main(int argc, char* argv[])
                       << ", steering=" << steering << ", brake=" << brake << ")"
                       << std::endl;
 
-  
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            std::this_thread::sleep_until(next_step);
+            next_step += step;
 
+            // Atrasado mais de um passo (ex.: processo suspenso): volta à
+            // grelha em vez de recuperar em rajada
+            auto now = std::chrono::steady_clock::now();
+            if (now > next_step)
+            {
+                next_step += (now - next_step) / step * step + step;
+            }
 
             if (std::cin.peek() == 'q')
             {
@@ -195,8 +247,9 @@ int main(int argc, char* argv[])
 
     // Aguarda as threads terminarem
     std::cout << "Shutting down..." << std::endl;
-    cmd_thread.join();
-    ctrl_thread.join();
+    recv_thread.join();
+    zmq_bridge_poller_destroy(poller);
+    zmq_bridge_scheduler_destroy(camera_scheduler);
 
 
     zmq_bridge_close_socket(pub_socket);
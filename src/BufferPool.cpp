@@ -0,0 +1,338 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "BufferPool.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    // Cabeçalho antes dos dados; 16 bytes mantêm o alinhamento do malloc
+    struct BufferHeader {
+        int32_t size_class;
+
+        uint32_t reserved[3];
+    };
+
+    static_assert(sizeof(BufferHeader) == 16, "BufferHeader must keep 16-byte alignment");
+
+
+    static BufferHeader* HeaderOf(void* buffer)
+    {
+        return reinterpret_cast<BufferHeader*>(static_cast<unsigned char*>(buffer)
+                                               - sizeof(BufferHeader));
+    }
+
+
+    static size_t ClassSize(int index)
+    {
+        return BufferPool::kMinClassSize << index;
+    }
+
+
+    static int64_t NowMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+
+    BufferPool::BufferPool()
+    {
+        for (int i = 0; i < kClassCount; ++i)
+        {
+            size_t max_cached = kMaxCachedBytes / 4 / ClassSize(i);
+            m_classes[i].max_cached = max_cached > 0 ? max_cached : 1;
+        }
+    }
+
+
+    BufferPool& BufferPool::Instance()
+    {
+        static BufferPool* instance = new BufferPool();
+        return *instance;
+    }
+
+
+    int BufferPool::ClassIndex(size_t size)
+    {
+        if (size > kMaxClassSize)
+        {
+            return kUnpooled;
+        }
+
+        int index = 0;
+        while (ClassSize(index) < size)
+        {
+            ++index;
+        }
+
+        return index;
+    }
+
+
+    void* BufferPool::Allocate(size_t size)
+    {
+        int index = ClassIndex(size);
+        void* raw = nullptr;
+
+        if (index != kUnpooled)
+        {
+            SizeClass& size_class = m_classes[index];
+            size_class.last_used_ms.store(NowMs(), std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(size_class.mutex);
+
+            if (!size_class.free.empty())
+            {
+                raw = size_class.free.back();
+                size_class.free.pop_back();
+            }
+        }
+
+        if (raw)
+        {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            m_cached_bytes.fetch_sub(static_cast<int64_t>(ClassSize(index)),
+                                     std::memory_order_relaxed);
+        }
+        else
+        {
+            size_t capacity = index != kUnpooled ? ClassSize(index) : size;
+            raw = std::malloc(sizeof(BufferHeader) + capacity);
+            if (!raw)
+            {
+                return nullptr;
+            }
+
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            static_cast<BufferHeader*>(raw)->size_class = index;
+        }
+
+        m_in_use.fetch_add(1, std::memory_order_relaxed);
+        return static_cast<unsigned char*>(raw) + sizeof(BufferHeader);
+    }
+
+
+    void BufferPool::Release(void* buffer)
+    {
+        if (!buffer)
+        {
+            return;
+        }
+
+        BufferHeader* header = HeaderOf(buffer);
+        int index = header->size_class;
+
+        m_in_use.fetch_sub(1, std::memory_order_relaxed);
+
+        bool cached = false;
+        if (index != kUnpooled)
+        {
+            SizeClass& size_class = m_classes[index];
+            int64_t size = static_cast<int64_t>(ClassSize(index));
+
+            std::lock_guard<std::mutex> lock(size_class.mutex);
+
+            // O orçamento é reservado antes de guardar: Release() corre em
+            // paralelo nas threads de I/O do libzmq
+            if (size_class.free.size() < size_class.max_cached)
+            {
+                if (m_cached_bytes.fetch_add(size, std::memory_order_relaxed) + size
+                    <= static_cast<int64_t>(kMaxCachedBytes))
+                {
+                    size_class.free.push_back(header);
+                    m_returned.fetch_add(1, std::memory_order_relaxed);
+                    cached = true;
+                }
+                else
+                {
+                    m_cached_bytes.fetch_sub(size, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        if (!cached)
+        {
+            m_released.fetch_add(1, std::memory_order_relaxed);
+            std::free(header);
+        }
+
+        TrimIdle();
+    }
+
+
+    void BufferPool::TrimIdle()
+    {
+        int64_t now = NowMs();
+        int64_t next = m_next_trim_ms.load(std::memory_order_relaxed);
+        if (now < next
+            || !m_next_trim_ms.compare_exchange_strong(next, now + 1000,
+                                                       std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        for (int i = 0; i < kClassCount; ++i)
+        {
+            if (now - m_classes[i].last_used_ms.load(std::memory_order_relaxed) >= kIdleTrimMs)
+            {
+                TrimClass(i);
+            }
+        }
+    }
+
+
+    void BufferPool::TrimClass(int index)
+    {
+        std::vector<void*> buffers;
+
+        {
+            std::lock_guard<std::mutex> lock(m_classes[index].mutex);
+            if (m_classes[index].free.empty())
+            {
+                return;
+            }
+
+            buffers.swap(m_classes[index].free);
+        }
+
+        m_cached_bytes.fetch_sub(static_cast<int64_t>(buffers.size() * ClassSize(index)),
+                                 std::memory_order_relaxed);
+
+        for (void* raw : buffers)
+        {
+            std::free(raw);
+        }
+    }
+
+
+    void BufferPool::Free(void* buffer, void* /*hint*/)
+    {
+        Instance().Release(buffer);
+    }
+
+
+    zmq::message_t BufferPool::AllocateMessage(size_t size)
+    {
+        if (size < kMinPooledSize)
+        {
+            return zmq::message_t(size);
+        }
+
+        void* buffer = Allocate(size);
+        if (!buffer)
+        {
+            // Deixa o libzmq tentar alocar (e reportar ENOMEM)
+            return zmq::message_t(size);
+        }
+
+        try
+        {
+            return zmq::message_t(buffer, size, &BufferPool::Free, nullptr);
+        } catch (const zmq::error_t&)
+        {
+            Release(buffer);
+            throw;
+        }
+    }
+
+
+    zmq::message_t BufferPool::CopyMessage(const void* data, size_t size)
+    {
+        if (size < kMinPooledSize)
+        {
+            return zmq::message_t(data, size);
+        }
+
+        zmq::message_t message = AllocateMessage(size);
+        if (size > 0)
+        {
+            memcpy(message.data(), data, size);
+        }
+
+        return message;
+    }
+
+
+    zmq::message_t* BufferPool::AcquireHandle()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_handles_mutex);
+
+            if (!m_handles.empty())
+            {
+                zmq::message_t* message = m_handles.back();
+                m_handles.pop_back();
+                m_handle_hits.fetch_add(1, std::memory_order_relaxed);
+                return message;
+            }
+        }
+
+        m_handle_misses.fetch_add(1, std::memory_order_relaxed);
+        return new zmq::message_t();
+    }
+
+
+    void BufferPool::ReleaseHandle(zmq::message_t* message)
+    {
+        if (!message)
+        {
+            return;
+        }
+
+        // Devolve já os dados ao libzmq; só o objeto é reutilizado
+        message->rebuild();
+
+        {
+            std::lock_guard<std::mutex> lock(m_handles_mutex);
+
+            if (m_handles.size() < kMaxCachedHandles)
+            {
+                m_handles.push_back(message);
+                return;
+            }
+        }
+
+        delete message;
+    }
+
+
+    void BufferPool::Trim()
+    {
+        for (int i = 0; i < kClassCount; ++i)
+        {
+            TrimClass(i);
+        }
+
+        std::vector<zmq::message_t*> handles;
+
+        {
+            std::lock_guard<std::mutex> lock(m_handles_mutex);
+            handles.swap(m_handles);
+        }
+
+        for (zmq::message_t* message : handles)
+        {
+            delete message;
+        }
+    }
+
+
+    void BufferPool::GetStats(zmq_bridge_pool_stats& stats)
+    {
+        stats.hits = static_cast<long long>(m_hits.load(std::memory_order_relaxed));
+        stats.misses = static_cast<long long>(m_misses.load(std::memory_order_relaxed));
+        stats.returned = static_cast<long long>(m_returned.load(std::memory_order_relaxed));
+        stats.released = static_cast<long long>(m_released.load(std::memory_order_relaxed));
+        stats.cached_bytes = m_cached_bytes.load(std::memory_order_relaxed);
+        stats.in_use = m_in_use.load(std::memory_order_relaxed);
+        stats.handle_hits =
+            static_cast<long long>(m_handle_hits.load(std::memory_order_relaxed));
+        stats.handle_misses =
+            static_cast<long long>(m_handle_misses.load(std::memory_order_relaxed));
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,123 @@
+// BufferPool.h - Buffers de mensagens reutilizados por classes de tamanho
+#pragma once
+
+#include <zmq.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "ZMQBridge.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Pool de buffers em classes de tamanho (potências de dois de 64 B a
+// 16 MB). Cada buffer leva um pequeno cabeçalho com a sua classe, pelo que
+// Free() não precisa do tamanho e pode ser usada diretamente como função
+// de libertação do libzmq (chamada a partir das threads de I/O). Pedidos
+// acima da maior classe usam malloc/free sem passar pela cache.
+//
+// A cache tem um orçamento global de kMaxCachedBytes, do qual cada classe
+// usa no máximo um quarto (e pelo menos um buffer); o excedente é
+// libertado de imediato. Classes sem pedidos há kIdleTrimMs são esvaziadas.
+//
+// CopyMessage/AllocateMessage só usam o pool a partir de kMinPooledSize:
+// abaixo disso o libzmq aloca dados e contador numa única chamada, e um
+// buffer do pool só acrescentaria a alocação do content_t.
+class BufferPool {
+public:
+    static constexpr size_t kMinClassSize = 64;
+    static constexpr size_t kMaxClassSize = 16 * 1024 * 1024;
+    static constexpr size_t kMaxCachedBytes = 64 * 1024 * 1024;
+    static constexpr int64_t kIdleTrimMs = 5000;
+
+    static constexpr size_t kMinPooledSize = 1024;
+
+    // Nunca é destruído: o libzmq pode devolver buffers depois de main()
+    static BufferPool& Instance();
+
+    // nullptr se a memória se esgotar
+    void* Allocate(size_t size);
+
+    void Release(void* buffer);
+
+    // Assinatura de zmq_free_fn
+    static void Free(void* buffer, void* hint);
+
+    // Mensagem com uma cópia de data; a partir de kMinPooledSize os dados
+    // ficam num buffer do pool, devolvido quando o libzmq terminar
+    zmq::message_t CopyMessage(const void* data, size_t size);
+
+    // Mensagem com size bytes por preencher, também com buffer do pool
+    zmq::message_t AllocateMessage(size_t size);
+
+    // Objetos zmq::message_t para receções emprestadas
+    zmq::message_t* AcquireHandle();
+
+    void ReleaseHandle(zmq::message_t* message);
+
+    // Liberta todos os buffers e handles guardados
+    void Trim();
+
+    void GetStats(zmq_bridge_pool_stats& stats);
+
+private:
+    static constexpr int kClassCount = 19; // 64 B .. 16 MB
+    static constexpr int kUnpooled = -1;
+    static constexpr size_t kMaxCachedHandles = 256;
+
+    struct SizeClass
+    {
+        std::mutex mutex;
+
+        std::vector<void*> free;
+
+        size_t max_cached = 0;
+
+        // Instante (ms do steady clock) do último Allocate da classe
+        std::atomic<int64_t> last_used_ms{ 0 };
+    };
+
+    BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    static int ClassIndex(size_t size);
+
+    // Liberta os buffers das classes sem pedidos há kIdleTrimMs; no máximo
+    // uma vez por segundo, a partir de Release()
+    void TrimIdle();
+
+    // Liberta os buffers guardados da classe
+    void TrimClass(int index);
+
+    SizeClass m_classes[kClassCount];
+
+    std::mutex m_handles_mutex;
+
+    std::vector<zmq::message_t*> m_handles;
+
+    std::atomic<uint64_t> m_hits{ 0 };
+
+    std::atomic<uint64_t> m_misses{ 0 };
+
+    std::atomic<uint64_t> m_returned{ 0 };
+
+    std::atomic<uint64_t> m_released{ 0 };
+
+    std::atomic<int64_t> m_cached_bytes{ 0 };
+
+    std::atomic<int64_t> m_next_trim_ms{ 0 };
+
+    std::atomic<int64_t> m_in_use{ 0 };
+
+    std::atomic<uint64_t> m_handle_hits{ 0 };
+
+    std::atomic<uint64_t> m_handle_misses{ 0 };
+};
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,379 @@
+#include <climits>
+#include <cstring>
+#include <string>
+#include "ZMQBridge.h"
+#include "Internal.h"
+#include "Codec.h"
+
+#ifdef ZMQ_BRIDGE_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef ZMQ_BRIDGE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef ZMQ_BRIDGE_HAVE_TURBOJPEG
+#include <turbojpeg.h>
+#endif
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    static const unsigned char kMagic[4] = { 'Z', 'B', 'C', '1' };
+
+
+    static void WriteU32(unsigned char* out, uint32_t value)
+    {
+        out[0] = static_cast<unsigned char>(value);
+        out[1] = static_cast<unsigned char>(value >> 8);
+        out[2] = static_cast<unsigned char>(value >> 16);
+        out[3] = static_cast<unsigned char>(value >> 24);
+    }
+
+
+    static uint32_t ReadU32(const unsigned char* in)
+    {
+        return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8)
+            | (static_cast<uint32_t>(in[2]) << 16)
+            | (static_cast<uint32_t>(in[3]) << 24);
+    }
+
+
+#ifdef ZMQ_BRIDGE_HAVE_ZSTD
+    // Contextos reutilizados por cada thread (evita alocações por frame)
+    struct ZstdContexts {
+        ZSTD_CCtx* compress = nullptr;
+        ZSTD_DCtx* decompress = nullptr;
+
+        ~ZstdContexts()
+        {
+            ZSTD_freeCCtx(compress);
+            ZSTD_freeDCtx(decompress);
+        }
+    };
+
+    static thread_local ZstdContexts t_zstd;
+#endif
+
+
+#ifdef ZMQ_BRIDGE_HAVE_TURBOJPEG
+    // Handles do TurboJPEG não podem ser partilhados entre threads
+    struct JpegHandles {
+        tjhandle compress = nullptr;
+        tjhandle decompress = nullptr;
+
+        ~JpegHandles()
+        {
+            if (compress)
+            {
+                tjDestroy(compress);
+            }
+
+            if (decompress)
+            {
+                tjDestroy(decompress);
+            }
+        }
+    };
+
+    static thread_local JpegHandles t_jpeg;
+
+
+    static int JpegPixelFormat(int channels)
+    {
+        switch (channels)
+        {
+        case 1: return TJPF_GRAY;
+        case 3: return TJPF_RGB;
+        case 4: return TJPF_RGBA;
+        default: return -1;
+        }
+    }
+#endif
+
+
+    bool CodecAvailable(int codec)
+    {
+        switch (codec)
+        {
+        case ZMQ_BRIDGE_CODEC_NONE: return true;
+#ifdef ZMQ_BRIDGE_HAVE_LZ4
+        case ZMQ_BRIDGE_CODEC_LZ4: return true;
+#endif
+#ifdef ZMQ_BRIDGE_HAVE_ZSTD
+        case ZMQ_BRIDGE_CODEC_ZSTD: return true;
+#endif
+#ifdef ZMQ_BRIDGE_HAVE_TURBOJPEG
+        case ZMQ_BRIDGE_CODEC_JPEG: return true;
+#endif
+        default: return false;
+        }
+    }
+
+
+    bool EncodeFrame(int codec, int quality, const unsigned char* raw, size_t size,
+                     int width, int height, int channels,
+                     std::vector<unsigned char>& out)
+    {
+        if (!CodecAvailable(codec))
+        {
+            SetLastError("Codec not available in this build");
+            return false;
+        }
+
+        if (size > INT_MAX)
+        {
+            SetLastError("Frame too large to encode");
+            return false;
+        }
+
+        // Só usado por zstd e JPEG
+        (void)quality;
+
+        size_t payload_size = 0;
+
+        switch (codec)
+        {
+        case ZMQ_BRIDGE_CODEC_NONE:
+            out.resize(kEncodedHeaderSize + size);
+            if (size > 0)
+            {
+                memcpy(out.data() + kEncodedHeaderSize, raw, size);
+            }
+            payload_size = size;
+            break;
+
+#ifdef ZMQ_BRIDGE_HAVE_LZ4
+        case ZMQ_BRIDGE_CODEC_LZ4:
+        {
+            int bound = LZ4_compressBound(static_cast<int>(size));
+            out.resize(kEncodedHeaderSize + static_cast<size_t>(bound));
+
+            int written = LZ4_compress_default(
+                reinterpret_cast<const char*>(raw),
+                reinterpret_cast<char*>(out.data() + kEncodedHeaderSize),
+                static_cast<int>(size), bound);
+            if (written <= 0 && size > 0)
+            {
+                SetLastError("LZ4 compression failed");
+                return false;
+            }
+
+            payload_size = static_cast<size_t>(written);
+            break;
+        }
+#endif
+
+#ifdef ZMQ_BRIDGE_HAVE_ZSTD
+        case ZMQ_BRIDGE_CODEC_ZSTD:
+        {
+            if (!t_zstd.compress)
+            {
+                t_zstd.compress = ZSTD_createCCtx();
+            }
+
+            size_t bound = ZSTD_compressBound(size);
+            out.resize(kEncodedHeaderSize + bound);
+
+            size_t written = ZSTD_compressCCtx(
+                t_zstd.compress, out.data() + kEncodedHeaderSize, bound, raw, size,
+                quality > 0 ? quality : ZSTD_CLEVEL_DEFAULT);
+            if (ZSTD_isError(written))
+            {
+                SetLastError("zstd compression failed: "
+                             + std::string(ZSTD_getErrorName(written)));
+                return false;
+            }
+
+            payload_size = written;
+            break;
+        }
+#endif
+
+#ifdef ZMQ_BRIDGE_HAVE_TURBOJPEG
+        case ZMQ_BRIDGE_CODEC_JPEG:
+        {
+            int pixel_format = JpegPixelFormat(channels);
+            if (pixel_format < 0 || width <= 0 || height <= 0
+                || size != static_cast<size_t>(width) * height * channels)
+            {
+                SetLastError("JPEG needs width * height * channels bytes with 1, 3 or 4 channels");
+                return false;
+            }
+
+            if (!t_jpeg.compress)
+            {
+                t_jpeg.compress = tjInitCompress();
+            }
+
+            int subsampling = channels == 1 ? TJSAMP_GRAY : TJSAMP_420;
+            unsigned long bound = tjBufSize(width, height, subsampling);
+            out.resize(kEncodedHeaderSize + bound);
+
+            // Escreve diretamente após o cabeçalho, sem realocar
+            unsigned char* jpeg = out.data() + kEncodedHeaderSize;
+            unsigned long jpeg_size = bound;
+            if (tjCompress2(t_jpeg.compress, raw, width, 0, height, pixel_format, &jpeg,
+                            &jpeg_size, subsampling, quality > 0 ? quality : 85,
+                            TJFLAG_NOREALLOC | TJFLAG_FASTDCT) != 0)
+            {
+                SetLastError("JPEG compression failed: "
+                             + std::string(tjGetErrorStr2(t_jpeg.compress)));
+                return false;
+            }
+
+            payload_size = jpeg_size;
+            break;
+        }
+#endif
+
+        default:
+            SetLastError("Codec not available in this build");
+            return false;
+        }
+
+        out.resize(kEncodedHeaderSize + payload_size);
+
+        unsigned char* header = out.data();
+        memcpy(header, kMagic, sizeof(kMagic));
+        header[4] = static_cast<unsigned char>(codec);
+        header[5] = static_cast<unsigned char>(channels);
+        header[6] = 0;
+        header[7] = 0;
+        WriteU32(header + 8, static_cast<uint32_t>(width));
+        WriteU32(header + 12, static_cast<uint32_t>(height));
+        WriteU32(header + 16, static_cast<uint32_t>(size));
+
+        return true;
+    }
+
+
+    bool ReadFrameInfo(const void* frame, size_t size, zmq_bridge_frame_info* info)
+    {
+        const unsigned char* header = static_cast<const unsigned char*>(frame);
+
+        if (!frame || size < kEncodedHeaderSize
+            || memcmp(header, kMagic, sizeof(kMagic)) != 0)
+        {
+            SetLastError("Not an encoded frame");
+            return false;
+        }
+
+        uint32_t raw_size = ReadU32(header + 16);
+        if (raw_size > INT_MAX)
+        {
+            SetLastError("Not an encoded frame");
+            return false;
+        }
+
+        info->codec = header[4];
+        info->channels = header[5];
+        info->width = static_cast<int>(ReadU32(header + 8));
+        info->height = static_cast<int>(ReadU32(header + 12));
+        info->raw_size = static_cast<int>(raw_size);
+        return true;
+    }
+
+
+    int DecodeFrame(const void* frame, size_t size, void* buffer, size_t buffer_size)
+    {
+        zmq_bridge_frame_info info;
+        if (!ReadFrameInfo(frame, size, &info))
+        {
+            return -1;
+        }
+
+        if (!CodecAvailable(info.codec))
+        {
+            SetLastError("Codec not available in this build");
+            return -1;
+        }
+
+        size_t raw_size = static_cast<size_t>(info.raw_size);
+        if (raw_size > buffer_size)
+        {
+            SetLastError("Buffer too small for decoded frame");
+            return -1;
+        }
+
+        const unsigned char* payload =
+            static_cast<const unsigned char*>(frame) + kEncodedHeaderSize;
+        size_t payload_size = size - kEncodedHeaderSize;
+        bool decoded = false;
+
+        switch (info.codec)
+        {
+        case ZMQ_BRIDGE_CODEC_NONE:
+            decoded = payload_size == raw_size;
+            if (decoded && raw_size > 0)
+            {
+                memcpy(buffer, payload, raw_size);
+            }
+            break;
+
+#ifdef ZMQ_BRIDGE_HAVE_LZ4
+        case ZMQ_BRIDGE_CODEC_LZ4:
+            decoded = payload_size <= INT_MAX
+                && LZ4_decompress_safe(reinterpret_cast<const char*>(payload),
+                                       static_cast<char*>(buffer),
+                                       static_cast<int>(payload_size),
+                                       static_cast<int>(raw_size))
+                    == static_cast<int>(raw_size);
+            break;
+#endif
+
+#ifdef ZMQ_BRIDGE_HAVE_ZSTD
+        case ZMQ_BRIDGE_CODEC_ZSTD:
+        {
+            if (!t_zstd.decompress)
+            {
+                t_zstd.decompress = ZSTD_createDCtx();
+            }
+
+            size_t written = ZSTD_decompressDCtx(t_zstd.decompress, buffer, raw_size,
+                                                 payload, payload_size);
+            decoded = !ZSTD_isError(written) && written == raw_size;
+            break;
+        }
+#endif
+
+#ifdef ZMQ_BRIDGE_HAVE_TURBOJPEG
+        case ZMQ_BRIDGE_CODEC_JPEG:
+        {
+            int pixel_format = JpegPixelFormat(info.channels);
+            if (pixel_format < 0
+                || raw_size != static_cast<size_t>(info.width) * info.height * info.channels)
+            {
+                break;
+            }
+
+            if (!t_jpeg.decompress)
+            {
+                t_jpeg.decompress = tjInitDecompress();
+            }
+
+            decoded = tjDecompress2(t_jpeg.decompress, payload, payload_size,
+                                    static_cast<unsigned char*>(buffer), info.width, 0,
+                                    info.height, pixel_format, TJFLAG_FASTDCT)
+                == 0;
+            break;
+        }
+#endif
+
+        default:
+            break;
+        }
+
+        if (!decoded)
+        {
+            SetLastError("Failed to decode frame");
+            return -1;
+        }
+
+        return info.raw_size;
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
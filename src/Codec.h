@@ -0,0 +1,40 @@
+// Codec.h - Compressão de frames (LZ4, zstd, JPEG) com cabeçalho próprio
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ZMQBridge.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Cabeçalho (little-endian) que precede os dados comprimidos:
+//   0  magic "ZBC1"
+//   4  u8 codec, u8 channels, u16 reservado
+//   8  u32 width
+//  12  u32 height
+//  16  u32 tamanho dos dados sem compressão
+constexpr size_t kEncodedHeaderSize = 20;
+
+
+// Indica se o codec foi incluído nesta build
+bool CodecAvailable(int codec);
+
+// Comprime raw para out (cabeçalho + dados), reutilizando a capacidade de
+// out. quality: 1-100 para JPEG, nível para zstd (<= 0 usa o padrão);
+// ignorado por LZ4. Devolve false e define o último erro em caso de falha.
+bool EncodeFrame(int codec, int quality, const unsigned char* raw, size_t size,
+                 int width, int height, int channels,
+                 std::vector<unsigned char>& out);
+
+// Lê o cabeçalho de um frame produzido por EncodeFrame
+bool ReadFrameInfo(const void* frame, size_t size, zmq_bridge_frame_info* info);
+
+// Descomprime o frame para buffer. Devolve o número de bytes escritos, ou
+// -1 (com o último erro definido) se o frame for inválido ou não couber.
+int DecodeFrame(const void* frame, size_t size, void* buffer, size_t buffer_size);
+
+} // namespace internal
+} // namespace zmq_bridge
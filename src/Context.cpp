@@ -1,16 +1,77 @@
 
-
 #include <zmq.hpp>
 #include "ZMQBridge.h"
+#include "BufferPool.h"
 #include "Internal.h"
 
-namespace zmq_bridge 
+namespace zmq_bridge
 {
-namespace internal 
+namespace internal
 {
 
-    bool Context::Initialize()
+    // Último erro, por thread
+    static thread_local std::string t_last_error;
+
+    // Nome da thread interna, ou nullptr numa thread do chamador
+    static thread_local const char* t_background_name = nullptr;
+
+    // Último erro das threads internas, partilhado pelo processo
+    static std::mutex s_background_mutex;
+
+    static std::string s_background_error;
+
+    static bool s_background_set = false;
+
+
+    void SetLastError(const std::string& error)
     {
+        t_last_error = error;
+
+        if (t_background_name)
+        {
+            std::lock_guard<std::mutex> lock(s_background_mutex);
+            s_background_error = std::string(t_background_name) + ": " + error;
+            s_background_set = true;
+        }
+    }
+
+
+    void SetBackgroundThread(const char* name) { t_background_name = name; }
+
+
+    bool TakeBackgroundError(std::string& error)
+    {
+        std::lock_guard<std::mutex> lock(s_background_mutex);
+
+        if (!s_background_set)
+        {
+            return false;
+        }
+
+        error.swap(s_background_error);
+        s_background_error.clear();
+        s_background_set = false;
+        return true;
+    }
+
+
+    const std::string& GetLastError() { return t_last_error; }
+
+
+    // Define uma opção do contexto; lança zmq::error_t se for rejeitada
+    static void SetContextOption(zmq::context_t& context, int option, int value)
+    {
+        if (zmq_ctx_set(context.handle(), option, value) != 0)
+        {
+            throw zmq::error_t();
+        }
+    }
+
+
+    bool Context::Initialize(const zmq_bridge_config* config)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
         if (m_initialized)
         {
             return true;
@@ -19,29 +80,135 @@ namespace internal
         try
         {
             m_context = std::make_unique<zmq::context_t>(1);
+            m_thread_priority = -1;
+
+            if (config)
+            {
+                if (config->io_threads > 0)
+                {
+                    SetContextOption(*m_context, ZMQ_IO_THREADS, config->io_threads);
+                }
+
+                if (config->max_sockets > 0)
+                {
+                    SetContextOption(*m_context, ZMQ_MAX_SOCKETS, config->max_sockets);
+                }
+
+                if (config->thread_sched_policy >= 0)
+                {
+                    SetContextOption(*m_context, ZMQ_THREAD_SCHED_POLICY,
+                                     config->thread_sched_policy);
+                }
+
+                if (config->thread_priority >= 0)
+                {
+                    SetContextOption(*m_context, ZMQ_THREAD_PRIORITY,
+                                     config->thread_priority);
+                    m_thread_priority = config->thread_priority;
+                }
+
+                for (int i = 0; config->affinity_cpus && i < config->affinity_cpu_count; ++i)
+                {
+#ifdef ZMQ_THREAD_AFFINITY_CPU_ADD
+                    SetContextOption(*m_context, ZMQ_THREAD_AFFINITY_CPU_ADD,
+                                     config->affinity_cpus[i]);
+#else
+                    SetLastError("Thread affinity not supported by this libzmq");
+                    m_context.reset();
+                    return false;
+#endif
+                }
+            }
+
             m_initialized = true;
             return true;
         } catch (const zmq::error_t& e)
         {
-            m_error = "Failed to initialize ZeroMQ context: " + std::string(e.what());
+            SetLastError("ZMQ initialization error: " + std::string(e.what()));
+            m_context.reset();
             return false;
         }
     }
 
 
+    void Context::GetEffectiveConfig(zmq_bridge_config& config)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_context)
+        {
+            return;
+        }
+
+        void* handle = m_context->handle();
+        config.io_threads = zmq_ctx_get(handle, ZMQ_IO_THREADS);
+
+        // A tabela de handles limita o número de sockets abertos
+        int max_sockets = zmq_ctx_get(handle, ZMQ_MAX_SOCKETS);
+        int capacity = static_cast<int>(HandleTable<SocketState>::kCapacity);
+        config.max_sockets = max_sockets > capacity ? capacity : max_sockets;
+
+        config.thread_sched_policy = zmq_ctx_get(handle, ZMQ_THREAD_SCHED_POLICY);
+        config.thread_priority = m_thread_priority;
+    }
+
+
     void Context::Shutdown()
     {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_initialized = false;
+
+        m_dispatcher.Stop();
+
+        m_reactor.Stop();
+
+        m_encoder.Stop();
+
+        m_latest_publishers.ForEach([this](int latest_id, LatestPublisher&) {
+            m_latest_publishers.Remove(latest_id,
+                                       [](LatestPublisher& latest) { latest.Stop(); });
+        });
+
+        m_schedulers.ForEach([this](int scheduler_id, Scheduler&) {
+            m_schedulers.Remove(scheduler_id, [](Scheduler& scheduler) { scheduler.Stop(); });
+        });
+
+        m_shm_publishers.ForEach([this](int shm_id, ShmPublisher&) {
+            m_shm_publishers.Remove(shm_id, [](ShmPublisher& shm) { shm.Stop(); });
+        });
+
+        m_shm_readers.Clear();
+
+        // A reprodução envia pelos sockets; os gravadores deixam de os ouvir
+        m_replayers.ForEach([this](int replayer_id, Replayer&) {
+            m_replayers.Remove(replayer_id, [](Replayer& replayer) { replayer.Close(); });
+        });
+
+        m_recorders.ForEach([this](int recorder_id, Recorder&) {
+            m_recorders.Remove(recorder_id, [](Recorder& recorder) { recorder.Close(); });
+        });
+
+        m_pollers.ForEach([this](int poller_id, Poller&) {
+            m_pollers.Remove(poller_id, [](Poller& poller) { poller.Close(); });
+        });
+
         m_socket_manager.CloseAllSockets();
         m_context.reset();
-        m_initialized = false;
+
+        // Com o contexto fechado já não há envios em curso
+        BufferPool::Instance().Trim();
     }
 
- 
+
+    bool Context::IsInitialized() const { return m_initialized; }
+
+
     zmq::context_t* Context::GetContext()
     {
         if (!m_initialized)
         {
-            m_error = "Context not initialized";
+            SetLastError("ZeroMQ context not initialized");
             return nullptr;
         }
 
@@ -52,7 +219,40 @@ namespace internal
     SocketManager& Context::GetSocketManager() { return m_socket_manager; }
 
 
-    const std::string& Context::GetLastError() const { return m_error; }
+    HandleTable<Poller>& Context::GetPollers() { return m_pollers; }
+
+
+    Reactor& Context::GetReactor() { return m_reactor; }
+
+
+    Dispatcher& Context::GetDispatcher() { return m_dispatcher; }
+
+
+    HandleTable<LatestPublisher>& Context::GetLatestPublishers() { return m_latest_publishers; }
+
+
+    HandleTable<ShmPublisher>& Context::GetShmPublishers() { return m_shm_publishers; }
+
+
+    ShmReaders& Context::GetShmReaders() { return m_shm_readers; }
+
+
+    HandleTable<Recorder>& Context::GetRecorders() { return m_recorders; }
+
+
+    HandleTable<Replayer>& Context::GetReplayers() { return m_replayers; }
+
+
+    HandleTable<Scheduler>& Context::GetSchedulers() { return m_schedulers; }
+
+
+    Encoder& Context::GetEncoder() { return m_encoder; }
+
+
+    SchemaRegistry& Context::GetSchemas() { return m_schemas; }
+
+
+    TopicRegistry& Context::GetTopics() { return m_topics; }
 
 
     Context& Context::Instance()
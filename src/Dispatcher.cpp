@@ -0,0 +1,347 @@
+#include <zmq.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "ZMQBridge.h"
+#include "Internal.h"
+#include "Dispatcher.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    // Limita o tempo até a thread ver callbacks novos ou removidos e até
+    // verificar sockets cujo ZMQ_FD não assinalou (ver Dispatcher); em regra
+    // as mensagens não esperam por isto, zmq_poll regressa logo que chegam
+    static const int kPollTimeoutMs = 10;
+
+    // Mensagens por socket antes de passar ao seguinte
+    static const int kMaxBatch = 64;
+
+
+    Dispatcher::~Dispatcher()
+    {
+        Stop();
+    }
+
+
+    bool Dispatcher::SetCallback(int socket_id, zmq_bridge_message_callback fn,
+                                 void* user_data)
+    {
+        if (!fn)
+        {
+            Forget(socket_id);
+            return true;
+        }
+
+        zmq::fd_t fd;
+
+        {
+            SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+            if (!lock)
+            {
+                return false;
+            }
+
+            try
+            {
+                int type = lock.Socket().get(zmq::sockopt::type);
+                if (type == ZMQ_PUB || type == ZMQ_PUSH)
+                {
+                    SetLastError("Socket cannot receive");
+                    return false;
+                }
+
+                fd = lock.Socket().get(zmq::sockopt::fd);
+            } catch (const zmq::error_t& e)
+            {
+                SetLastError("Failed to query socket: " + std::string(e.what()));
+                return false;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (!m_running)
+        {
+            m_stop = false;
+
+            try
+            {
+                m_thread = std::thread(&Dispatcher::Run, this);
+            } catch (const std::system_error& e)
+            {
+                SetLastError("Failed to start dispatcher thread: " + std::string(e.what()));
+                return false;
+            }
+
+            m_running = true;
+        }
+
+        auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                               [socket_id](const Entry& entry) {
+                                   return entry.socket_id == socket_id;
+                               });
+
+        if (it != m_entries.end())
+        {
+            it->fn = fn;
+            it->user_data = user_data;
+        }
+        else
+        {
+            m_entries.push_back({ socket_id, fd, fn, user_data });
+        }
+
+        ++m_version;
+        m_wake.notify_one();
+        WaitForThread(lock);
+        return true;
+    }
+
+
+    void Dispatcher::Forget(int socket_id)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                               [socket_id](const Entry& entry) {
+                                   return entry.socket_id == socket_id;
+                               });
+
+        if (it == m_entries.end())
+        {
+            return;
+        }
+
+        m_entries.erase(it);
+        ++m_version;
+        m_wake.notify_one();
+        WaitForThread(lock);
+    }
+
+
+    void Dispatcher::WaitForThread(std::unique_lock<std::mutex>& lock)
+    {
+        // Dentro de um callback a thread só vê a alteração depois de regressar
+        if (std::this_thread::get_id() == m_thread.get_id())
+        {
+            return;
+        }
+
+        unsigned version = m_version;
+        m_seen.wait(lock, [this, version] { return !m_running || m_seen_version == version; });
+    }
+
+
+    void Dispatcher::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (!m_running)
+            {
+                return;
+            }
+
+            m_stop = true;
+        }
+
+        m_wake.notify_one();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+        m_entries.clear();
+        ++m_version;
+        m_seen.notify_all();
+    }
+
+
+    void Dispatcher::Invoke(const Entry& entry)
+    {
+        // Um só frame é entregue diretamente, sem cópia
+        if (m_frames.size() == 1)
+        {
+            int size = static_cast<int>(m_frames[0].size());
+            entry.fn(entry.socket_id, m_frames[0].data(), &size, 1, entry.user_data);
+            return;
+        }
+
+        // Vários frames: contíguos em m_buffer, como em zmq_bridge_receive_multipart
+        m_sizes.clear();
+        size_t total = 0;
+        for (const auto& frame : m_frames)
+        {
+            m_sizes.push_back(static_cast<int>(frame.size()));
+            total += frame.size();
+        }
+
+        if (m_buffer.size() < total)
+        {
+            m_buffer.resize(total);
+        }
+
+        size_t offset = 0;
+        for (const auto& frame : m_frames)
+        {
+            if (frame.size() > 0)
+            {
+                memcpy(m_buffer.data() + offset, frame.data(), frame.size());
+            }
+
+            offset += frame.size();
+        }
+
+        entry.fn(entry.socket_id, m_buffer.data(), m_sizes.data(),
+                 static_cast<int>(m_sizes.size()), entry.user_data);
+    }
+
+
+    bool Dispatcher::Drain(const Entry& entry, unsigned version, bool& exhausted)
+    {
+        auto& manager = Context::Instance().GetSocketManager();
+        exhausted = false;
+
+        for (int i = 0; i < kMaxBatch; ++i)
+        {
+            m_frames.clear();
+
+            {
+                SocketLock lock = manager.Acquire(entry.socket_id);
+                if (!lock)
+                {
+                    return true;
+                }
+
+                zmq::message_t frame;
+                if (!lock.State().Receive(frame, zmq::recv_flags::dontwait))
+                {
+                    return true;
+                }
+
+                // Os restantes frames da mensagem já chegaram
+                bool more = frame.more();
+                m_frames.push_back(std::move(frame));
+
+                while (more)
+                {
+                    zmq::message_t next;
+                    if (!lock.State().Receive(next, zmq::recv_flags::none))
+                    {
+                        break;
+                    }
+
+                    more = next.more();
+                    m_frames.push_back(std::move(next));
+                }
+            }
+
+            Invoke(entry);
+
+            // O callback pode ter alterado os callbacks ou fechado sockets
+            if (m_version.load(std::memory_order_acquire) != version)
+            {
+                return false;
+            }
+        }
+
+        exhausted = true;
+        return true;
+    }
+
+
+    void Dispatcher::Run()
+    {
+        SetBackgroundThread("dispatcher");
+
+        auto& manager = Context::Instance().GetSocketManager();
+        std::vector<Entry> entries;
+        std::vector<zmq::pollitem_t> items;
+        unsigned version = m_version.load() - 1;
+
+        // Há mensagens por entregar sem esperar (lote cheio ou frames pendentes)
+        bool ready = false;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                while (true)
+                {
+                    if (version != m_version.load())
+                    {
+                        version = m_version.load();
+                        entries = m_entries;
+
+                        items.clear();
+                        for (const Entry& entry : entries)
+                        {
+                            items.push_back({ nullptr, entry.fd, ZMQ_POLLIN, 0 });
+                        }
+
+                        m_seen_version = version;
+                        m_seen.notify_all();
+                    }
+
+                    if (m_stop || !entries.empty())
+                    {
+                        break;
+                    }
+
+                    m_wake.wait(lock);
+                }
+
+                if (m_stop)
+                {
+                    break;
+                }
+            }
+
+            for (const Entry& entry : entries)
+            {
+                ready = ready || manager.HasPending(entry.socket_id);
+            }
+
+            try
+            {
+                int rc = zmq::poll(items.data(), items.size(),
+                                   std::chrono::milliseconds(ready ? 0 : kPollTimeoutMs));
+
+                // Sem sinal em nenhum ZMQ_FD (timeout), todos os sockets são
+                // verificados: um sinal pode ter sido consumido noutra thread
+                bool check_all = rc == 0;
+                ready = false;
+
+                for (size_t i = 0; i < items.size(); ++i)
+                {
+                    if (!check_all && !(items[i].revents & ZMQ_POLLIN)
+                        && !manager.HasPending(entries[i].socket_id))
+                    {
+                        continue;
+                    }
+
+                    bool exhausted;
+                    if (!Drain(entries[i], version, exhausted))
+                    {
+                        break;
+                    }
+
+                    ready = ready || exhausted;
+                }
+            } catch (const zmq::error_t& e)
+            {
+                SetLastError("Dispatcher error: " + std::string(e.what()));
+            }
+        }
+
+        m_frames.clear();
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,96 @@
+// Dispatcher.h - Thread que entrega as mensagens recebidas a callbacks
+#pragma once
+
+#include <zmq.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ZMQBridge.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Uma única thread espera (zmq_poll) por todos os sockets com callback e
+// chama o callback assim que uma mensagem completa chega, sem depender da
+// frequência com que o chamador faz polling. O callback corre sem o mutex
+// do socket, por isso pode enviar pelo mesmo socket (ex.: resposta REP).
+//
+// A espera é feita sobre o ZMQ_FD de cada socket, sem tocar no socket do
+// libzmq (que não é thread-safe); as receções são feitas com o mutex do
+// socket, por isso outras threads podem continuar a enviar por ele. O
+// ZMQ_FD só assinala transições e um envio noutra thread pode consumir o
+// sinal: por isso todos os sockets são verificados a cada kPollTimeoutMs,
+// que limita o atraso nesse caso. Frames deixados em SocketState::pending
+// (receive_ex, peek) são entregues sem esperar pelo socket.
+//
+// Depois de SetCallback()/Forget() regressarem, o callback anterior já não
+// está a ser chamado nem volta a ser (exceto quando chamados a partir do
+// próprio callback, que não pode esperar por si mesmo).
+class Dispatcher {
+public:
+    ~Dispatcher();
+
+    // fn nullptr remove o callback. A thread arranca no primeiro callback.
+    bool SetCallback(int socket_id, zmq_bridge_message_callback fn, void* user_data);
+
+    // Remove o callback, se existir (antes de fechar o socket)
+    void Forget(int socket_id);
+
+    void Stop();
+
+private:
+    struct Entry
+    {
+        int socket_id;
+
+        zmq::fd_t fd;
+
+        zmq_bridge_message_callback fn;
+
+        void* user_data;
+    };
+
+    void Run();
+
+    // Entrega até kMaxBatch mensagens; false se os callbacks mudaram.
+    // exhausted fica true se o lote encheu e ainda podem existir mensagens
+    bool Drain(const Entry& entry, unsigned version, bool& exhausted);
+
+    void Invoke(const Entry& entry);
+
+    // Espera que a thread veja a versão atual (chamar com m_mutex)
+    void WaitForThread(std::unique_lock<std::mutex>& lock);
+
+    std::thread m_thread;
+
+    bool m_running = false;
+
+    bool m_stop = false;
+
+    std::vector<Entry> m_entries;
+
+    // Incrementada a cada alteração de m_entries
+    std::atomic<unsigned> m_version{ 0 };
+
+    // Última versão vista pela thread
+    unsigned m_seen_version = 0;
+
+    std::condition_variable m_wake;
+
+    std::condition_variable m_seen;
+
+    std::mutex m_mutex;
+
+    // Só usados pela thread; reutilizados entre mensagens
+    std::vector<zmq::message_t> m_frames;
+
+    std::vector<unsigned char> m_buffer;
+
+    std::vector<int> m_sizes;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
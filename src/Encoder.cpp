@@ -0,0 +1,242 @@
+#include <zmq.hpp>
+#include <functional>
+#include "ZMQBridge.h"
+#include "Internal.h"
+#include "BufferPool.h"
+#include "Codec.h"
+#include "Encoder.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    Encoder::~Encoder()
+    {
+        Stop();
+    }
+
+
+    bool Encoder::Start(int worker_threads, int queue_capacity)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_running)
+        {
+            return true;
+        }
+
+        if (worker_threads <= 0)
+        {
+            worker_threads = static_cast<int>(std::thread::hardware_concurrency());
+            worker_threads = worker_threads > 1 ? worker_threads - 1 : 1;
+        }
+
+        m_queue_capacity = queue_capacity > 0 ? static_cast<size_t>(queue_capacity) : 4;
+
+        try
+        {
+            for (int i = 0; i < worker_threads; ++i)
+            {
+                auto worker = std::make_unique<Worker>();
+                Worker* raw = worker.get();
+                m_workers.push_back(std::move(worker));
+                raw->thread = std::thread(&Encoder::Run, this, std::ref(*raw));
+            }
+        } catch (const std::system_error& e)
+        {
+            SetLastError("Failed to start encoder threads: " + std::string(e.what()));
+
+            for (auto& worker : m_workers)
+            {
+                {
+                    std::lock_guard<std::mutex> worker_lock(worker->mutex);
+                    worker->stop = true;
+                }
+
+                worker->wake.notify_one();
+                if (worker->thread.joinable())
+                {
+                    worker->thread.join();
+                }
+            }
+
+            m_workers.clear();
+            return false;
+        }
+
+        m_running = true;
+        return true;
+    }
+
+
+    void Encoder::Stop()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_running = false;
+
+        // Os frames ainda em fila são descartados
+        for (auto& worker : m_workers)
+        {
+            {
+                std::lock_guard<std::mutex> worker_lock(worker->mutex);
+                worker->stop = true;
+                worker->jobs.clear();
+            }
+
+            worker->wake.notify_one();
+        }
+
+        for (auto& worker : m_workers)
+        {
+            if (worker->thread.joinable())
+            {
+                worker->thread.join();
+            }
+        }
+
+        m_workers.clear();
+    }
+
+
+    bool Encoder::SetTopicCodec(int socket_id, const std::string& topic, int codec,
+                                int quality)
+    {
+        if (!CodecAvailable(codec))
+        {
+            SetLastError("Codec not available in this build");
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_topics_mutex);
+
+        TopicCodec& config = m_topics[std::make_pair(socket_id, topic)];
+        config.codec = codec;
+        config.quality = quality;
+        return true;
+    }
+
+
+    void Encoder::ForgetSocket(int socket_id)
+    {
+        std::lock_guard<std::mutex> lock(m_topics_mutex);
+
+        // As chaves de um socket são contíguas no map
+        m_topics.erase(m_topics.lower_bound(std::make_pair(socket_id, std::string())),
+                       m_topics.lower_bound(std::make_pair(socket_id + 1, std::string())));
+    }
+
+
+    int Encoder::Submit(int socket_id, const std::string& topic, const void* pixels,
+                        size_t size, int width, int height, int channels)
+    {
+        // Copia fora do lock: o chamador pode reutilizar o buffer logo a seguir
+        EncodeJob job;
+        job.socket_id = socket_id;
+        job.topic = topic;
+        job.width = width;
+        job.height = height;
+        job.channels = channels;
+
+        const unsigned char* bytes = static_cast<const unsigned char*>(pixels);
+        job.pixels.assign(bytes, bytes + size);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_running || m_workers.empty())
+        {
+            SetLastError("Encoder not running");
+            return ZMQ_BRIDGE_ERROR_INIT;
+        }
+
+        {
+            std::lock_guard<std::mutex> topics_lock(m_topics_mutex);
+
+            auto it = m_topics.find(std::make_pair(socket_id, topic));
+            if (it != m_topics.end())
+            {
+                job.codec = it->second;
+            }
+        }
+
+        size_t index = (std::hash<std::string>()(topic) ^ static_cast<size_t>(socket_id))
+            % m_workers.size();
+        Worker& worker = *m_workers[index];
+
+        {
+            std::lock_guard<std::mutex> worker_lock(worker.mutex);
+
+            if (worker.jobs.size() >= m_queue_capacity)
+            {
+                SetLastError("Encoder queue full");
+                return ZMQ_BRIDGE_ERROR_QUEUE_FULL;
+            }
+
+            worker.jobs.push_back(std::move(job));
+        }
+
+        worker.wake.notify_one();
+        return ZMQ_BRIDGE_OK;
+    }
+
+
+    void Encoder::Publish(Worker& worker, const EncodeJob& job)
+    {
+        if (!EncodeFrame(job.codec.codec, job.codec.quality, job.pixels.data(),
+                         job.pixels.size(), job.width, job.height, job.channels,
+                         worker.output))
+        {
+            return;
+        }
+
+        SocketLock lock = Context::Instance().GetSocketManager().Acquire(job.socket_id);
+        if (!lock)
+        {
+            return;
+        }
+
+        try
+        {
+            zmq::message_t topic_msg(job.topic.data(), job.topic.size());
+            if (!lock.State().Send(topic_msg, zmq::send_flags::sndmore))
+            {
+                return;
+            }
+
+            zmq::message_t data_msg =
+                BufferPool::Instance().CopyMessage(worker.output.data(), worker.output.size());
+            lock.State().Send(data_msg, zmq::send_flags::none);
+        } catch (const zmq::error_t& e)
+        {
+            SetLastError("Publish error: " + std::string(e.what()));
+        }
+    }
+
+
+    void Encoder::Run(Worker& worker)
+    {
+        SetBackgroundThread("encoder");
+
+        while (true)
+        {
+            EncodeJob job;
+
+            {
+                std::unique_lock<std::mutex> lock(worker.mutex);
+                worker.wake.wait(lock, [&worker] { return worker.stop || !worker.jobs.empty(); });
+
+                if (worker.stop)
+                {
+                    break;
+                }
+
+                job = std::move(worker.jobs.front());
+                worker.jobs.pop_front();
+            }
+
+            Publish(worker, job);
+        }
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
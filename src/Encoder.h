@@ -0,0 +1,108 @@
+// Encoder.h - Compressão de frames num pool de threads antes da publicação
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Codec e qualidade configurados para um tópico
+struct TopicCodec {
+    int codec = 0;
+
+    int quality = 0;
+};
+
+
+// Frame à espera de ser comprimido e publicado
+struct EncodeJob {
+    int socket_id = -1;
+
+    std::string topic;
+
+    TopicCodec codec;
+
+    int width = 0;
+
+    int height = 0;
+
+    int channels = 0;
+
+    std::vector<unsigned char> pixels;
+};
+
+
+// Pool de threads que comprime frames (ver Codec.h) e os publica como
+// [tópico][cabeçalho + dados comprimidos]. Cada (socket, tópico) é sempre
+// atribuído à mesma thread, o que mantém a ordem dos frames do tópico.
+class Encoder {
+public:
+    ~Encoder();
+
+    bool Start(int worker_threads, int queue_capacity);
+
+    void Stop();
+
+    bool IsRunning() const { return m_running; }
+
+    bool SetTopicCodec(int socket_id, const std::string& topic, int codec, int quality);
+
+    // Esquece os codecs dos tópicos de um socket (ex.: socket fechado)
+    void ForgetSocket(int socket_id);
+
+    // Copia os píxeis e enfileira o frame. Devolve ZMQ_BRIDGE_OK,
+    // ZMQ_BRIDGE_ERROR_QUEUE_FULL ou ZMQ_BRIDGE_ERROR_INIT.
+    int Submit(int socket_id, const std::string& topic, const void* pixels,
+               size_t size, int width, int height, int channels);
+
+private:
+    struct Worker
+    {
+        std::thread thread;
+
+        std::mutex mutex;
+
+        std::condition_variable wake;
+
+        std::deque<EncodeJob> jobs;
+
+        bool stop = false;
+
+        // Reutilizado entre frames
+        std::vector<unsigned char> output;
+    };
+
+    void Run(Worker& worker);
+
+    void Publish(Worker& worker, const EncodeJob& job);
+
+    std::atomic<bool> m_running{ false };
+
+    size_t m_queue_capacity = 0;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::map<std::pair<int, std::string>, TopicCodec> m_topics;
+
+    // Protege m_workers; Stop() espera que os Submit() em curso terminem
+    // antes de destruir os workers
+    std::mutex m_mutex;
+
+    // Protege m_topics. Separado de m_mutex, que Stop() mantém enquanto
+    // espera pelos workers (que bloqueiam sockets): SetTopicCodec e
+    // ForgetSocket são chamados com o mutex de um socket
+    std::mutex m_topics_mutex;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
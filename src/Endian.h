@@ -0,0 +1,34 @@
+// Endian.h - Leitura e escrita de inteiros little-endian nos formatos binários
+#pragma once
+
+#include <cstdint>
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Os cabeçalhos em rede e em disco (envelope, RPC, memória partilhada,
+// gravações) são little-endian, qualquer que seja a plataforma.
+// bytes vai de 1 a 8.
+inline void StoreLE(unsigned char* out, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+    {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+
+inline uint64_t LoadLE(const unsigned char* in, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i)
+    {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+
+    return value;
+}
+
+} // namespace internal
+} // namespace zmq_bridge
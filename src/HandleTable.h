@@ -0,0 +1,179 @@
+// HandleTable.h - Tabela de handles (índice + geração) com leitura sem locks
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace zmq_bridge {
+namespace internal {
+
+// Tabela de slots endereçada por handles inteiros positivos.
+//
+// Cada handle junta o índice do slot (bits baixos) com a geração do slot
+// (bits altos). Quando um slot é libertado a geração avança, pelo que um
+// handle antigo deixa de ser aceite mesmo que o slot volte a ser usado.
+//
+// Lookup() não usa locks nem hashing: é uma leitura atómica do handle
+// publicado no slot. Insert() e Remove() usam um mutex apenas para a
+// lista de slots livres. Os objetos T nunca são destruídos antes da
+// tabela, por isso um Lookup() concorrente com Remove() nunca acede a
+// memória libertada; cabe ao T ter o seu próprio lock e ao chamador
+// confirmar com IsCurrent() depois de o obter.
+template <typename T>
+class HandleTable {
+public:
+    static constexpr int kIndexBits = 12;
+    static constexpr uint32_t kCapacity = 1u << kIndexBits;
+    static constexpr uint32_t kIndexMask = kCapacity - 1;
+    static constexpr uint32_t kMaxGeneration = (1u << (31 - kIndexBits)) - 1;
+
+    HandleTable() : m_slots(new Slot[kCapacity])
+    {
+        for (uint32_t i = 0; i < kCapacity; ++i)
+        {
+            m_free.push_back(i);
+        }
+    }
+
+    HandleTable(const HandleTable&) = delete;
+    HandleTable& operator=(const HandleTable&) = delete;
+
+    // Reserva um slot, inicializa o valor com init(T&) e publica o handle.
+    // Devolve -1 se a tabela estiver cheia.
+    template <typename Init>
+    int Insert(Init&& init)
+    {
+        uint32_t index;
+        {
+            std::lock_guard<std::mutex> lock(m_free_mutex);
+            if (m_free.empty())
+            {
+                return -1;
+            }
+
+            // FIFO: um slot libertado é o último a ser reutilizado
+            index = m_free.front();
+            m_free.pop_front();
+        }
+
+        Slot& slot = m_slots[index];
+
+        try
+        {
+            if (!slot.value)
+            {
+                slot.value = std::make_unique<T>();
+            }
+
+            init(*slot.value);
+        } catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_free_mutex);
+            m_free.push_front(index);
+            throw;
+        }
+
+        int handle = static_cast<int>((slot.generation << kIndexBits) | index);
+        slot.handle.store(handle, std::memory_order_release);
+
+        return handle;
+    }
+
+    // Devolve o valor associado ao handle, ou nullptr se o handle não for
+    // (ou já não for) válido. Não bloqueia.
+    T* Lookup(int handle) const
+    {
+        if (handle <= 0)
+        {
+            return nullptr;
+        }
+
+        const Slot& slot = m_slots[static_cast<uint32_t>(handle) & kIndexMask];
+        if (slot.handle.load(std::memory_order_acquire) != handle)
+        {
+            return nullptr;
+        }
+
+        return slot.value.get();
+    }
+
+    // Indica se o handle continua a ser o handle publicado no seu slot
+    bool IsCurrent(int handle) const
+    {
+        if (handle <= 0)
+        {
+            return false;
+        }
+
+        const Slot& slot = m_slots[static_cast<uint32_t>(handle) & kIndexMask];
+        return slot.handle.load(std::memory_order_acquire) == handle;
+    }
+
+    // Invalida o handle, chama release(T&) para limpar o valor e devolve o
+    // slot à lista livre. Devolve false se o handle não for válido.
+    template <typename Release>
+    bool Remove(int handle, Release&& release)
+    {
+        if (handle <= 0)
+        {
+            return false;
+        }
+
+        uint32_t index = static_cast<uint32_t>(handle) & kIndexMask;
+        Slot& slot = m_slots[index];
+
+        int expected = handle;
+        if (!slot.handle.compare_exchange_strong(expected, 0,
+                                                 std::memory_order_acq_rel))
+        {
+            return false;
+        }
+
+        release(*slot.value);
+
+        std::lock_guard<std::mutex> lock(m_free_mutex);
+        slot.generation =
+            (slot.generation >= kMaxGeneration) ? 1 : slot.generation + 1;
+        m_free.push_back(index);
+
+        return true;
+    }
+
+    // Chama fn(handle, T&) para cada handle válido no momento da leitura
+    template <typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        for (uint32_t i = 0; i < kCapacity; ++i)
+        {
+            int handle = m_slots[i].handle.load(std::memory_order_acquire);
+            if (handle != 0)
+            {
+                fn(handle, *m_slots[i].value);
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        // Handle publicado, ou 0 se o slot estiver livre
+        std::atomic<int> handle{ 0 };
+
+        // Protegida por m_free_mutex (ou pela posse exclusiva do slot)
+        uint32_t generation = 1;
+
+        std::unique_ptr<T> value;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+
+    std::deque<uint32_t> m_free;
+
+    std::mutex m_free_mutex;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,159 @@
+// Histogram.h - Histograma log-linear de tempos com registo sem locks
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "ZMQBridge.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Histograma no estilo HDR: valores abaixo de kSubBucketCount têm um balde
+// cada; acima disso, cada potência de dois é dividida em kSubBucketCount
+// baldes, o que limita o erro relativo a 1/16 em toda a gama (até 2^42 ns,
+// cerca de 73 minutos). Record() só faz incrementos atómicos relaxados e
+// pode ser chamado por várias threads; os percentis de Snapshot() são
+// aproximados se houver registos concorrentes.
+class Histogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr uint64_t kSubBucketCount = 1u << kSubBucketBits;
+    static constexpr int kMaxExponent = 42;
+    static constexpr size_t kBucketCount =
+        static_cast<size_t>(kMaxExponent - kSubBucketBits + 1) * kSubBucketCount;
+
+    void Record(uint64_t value)
+    {
+        m_buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (value > max
+               && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void Snapshot(zmq_bridge_time_stats& stats) const
+    {
+        uint64_t counts[kBucketCount];
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBucketCount; ++i)
+        {
+            counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+
+        stats.count = static_cast<long long>(total);
+        stats.p50_ns = static_cast<long long>(Percentile(counts, total, max, 0.50));
+        stats.p90_ns = static_cast<long long>(Percentile(counts, total, max, 0.90));
+        stats.p99_ns = static_cast<long long>(Percentile(counts, total, max, 0.99));
+        stats.p999_ns = static_cast<long long>(Percentile(counts, total, max, 0.999));
+        stats.max_ns = static_cast<long long>(max);
+    }
+
+    uint64_t Count() const { return m_count.load(std::memory_order_relaxed); }
+
+    void Reset()
+    {
+        for (auto& bucket : m_buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+
+        m_count.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static int HighestBit(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    static size_t BucketIndex(uint64_t value)
+    {
+        if (value < kSubBucketCount)
+        {
+            return static_cast<size_t>(value);
+        }
+
+        int exponent = HighestBit(value);
+        if (exponent >= kMaxExponent)
+        {
+            return kBucketCount - 1;
+        }
+
+        // Os kSubBucketBits bits abaixo do bit mais alto escolhem o balde
+        int shift = exponent - kSubBucketBits;
+        size_t group = static_cast<size_t>(shift + 1);
+        size_t sub = static_cast<size_t>((value >> shift) & (kSubBucketCount - 1));
+        return group * kSubBucketCount + sub;
+    }
+
+    // Maior valor que cai no balde index
+    static uint64_t BucketUpperBound(size_t index)
+    {
+        size_t group = index / kSubBucketCount;
+        uint64_t sub = index % kSubBucketCount;
+        if (group == 0)
+        {
+            return sub;
+        }
+
+        int shift = static_cast<int>(group) - 1;
+        uint64_t lower = (kSubBucketCount + sub) << shift;
+        return lower + (uint64_t(1) << shift) - 1;
+    }
+
+    static uint64_t Percentile(const uint64_t* counts, uint64_t total, uint64_t max,
+                               double percentile)
+    {
+        if (total == 0)
+        {
+            return 0;
+        }
+
+        uint64_t rank = static_cast<uint64_t>(percentile * static_cast<double>(total));
+        if (rank >= total)
+        {
+            rank = total - 1;
+        }
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i)
+        {
+            seen += counts[i];
+            if (seen > rank)
+            {
+                uint64_t bound = BucketUpperBound(i);
+                return bound < max ? bound : max;
+            }
+        }
+
+        return max;
+    }
+
+    std::atomic<uint64_t> m_buckets[kBucketCount] = {};
+
+    std::atomic<uint64_t> m_count{ 0 };
+
+    std::atomic<uint64_t> m_max{ 0 };
+};
+
+} // namespace internal
+} // namespace zmq_bridge
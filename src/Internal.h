@@ -3,69 +3,328 @@
 
 #include <zmq.hpp>
 #include <string>
-#include <unordered_map>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+#include "ZMQBridge.h"
+#include "HandleTable.h"
+#include "Histogram.h"
+#include "Encoder.h"
+#include "LatestPublisher.h"
+#include "Schema.h"
+#include "TopicRegistry.h"
+#include "Poller.h"
+#include "Reactor.h"
+#include "Dispatcher.h"
+#include "SharedMemory.h"
+#include "Rpc.h"
+#include "Recorder.h"
+#include "Scheduler.h"
 
 namespace zmq_bridge {
 namespace internal {
 
 
+// Último erro da thread que chama (válido até ao próximo erro nessa thread)
+void SetLastError(const std::string& error);
+
+const std::string& GetLastError();
+
+// Marca a thread que chama como thread interna (dispatcher, reactor, ...):
+// os erros que regista também ficam em TakeBackgroundError, porque nenhum
+// chamador os pode ler com zmq_bridge_get_last_error
+void SetBackgroundThread(const char* name);
+
+// Último erro de uma thread interna, prefixado com o nome da thread; false
+// se não houver nenhum desde a última chamada
+bool TakeBackgroundError(std::string& error);
+
+
+// Opções ZMQ_BRIDGE_OPT_*. Devolvem false (com o último erro definido) se a
+// opção não existir e lançam zmq::error_t se o ZeroMQ a rejeitar.
+bool SetSocketOption(zmq::socket_t& socket, int option, long long value);
+
+bool GetSocketOption(zmq::socket_t& socket, int option, long long& value);
+
+// Todos os campos a -1
+void InitSocketOptions(zmq_bridge_socket_options& options);
+
+// Aplica os campos diferentes de -1; lança zmq::error_t em caso de erro
+void ApplySocketOptions(zmq::socket_t& socket, const zmq_bridge_socket_options& options);
+
+
+// Métricas de um socket (ver zmq_bridge_socket_stats); atualizadas com o
+// mutex do socket e lidas sem ele
+struct SocketStats {
+    std::atomic<uint64_t> messages_sent{ 0 };
+
+    std::atomic<uint64_t> bytes_sent{ 0 };
+
+    std::atomic<uint64_t> messages_received{ 0 };
+
+    std::atomic<uint64_t> bytes_received{ 0 };
+
+    std::atomic<uint64_t> send_would_block{ 0 };
+
+    std::atomic<uint64_t> receive_would_block{ 0 };
+
+    std::atomic<uint64_t> send_errors{ 0 };
+
+    std::atomic<uint64_t> receive_errors{ 0 };
+
+    std::atomic<uint64_t> truncated{ 0 };
+
+    Histogram send_time;
+
+    Histogram receive_time;
+
+    std::atomic<uint64_t> envelopes_received{ 0 };
+
+    std::atomic<uint64_t> sequence_lost{ 0 };
+
+    std::atomic<uint64_t> sequence_reordered{ 0 };
+
+    Histogram latency;
+
+    void Reset();
+};
+
+
+// Estado de um socket, protegido pelo seu próprio mutex
+struct SocketState {
+    std::mutex mutex;
+
+    std::unique_ptr<zmq::socket_t> socket;
+
+    // Frames já lidos do socket mas ainda não entregues ao chamador
+    std::deque<zmq::message_t> pending;
+
+    SocketStats stats;
+
+    // Envia um frame e atualiza stats; lança zmq::error_t como socket->send
+    zmq::send_result_t Send(zmq::message_t& message, zmq::send_flags flags);
+
+    // Recebe o próximo frame, começando pelos pendentes
+    bool Receive(zmq::message_t& message, zmq::recv_flags flags);
+
+    // Devolve um frame para a frente da fila de pendentes
+    void Unread(zmq::message_t&& message);
+
+    // Descarta os frames pendentes
+    void ClearPending();
+
+    // Pode ser lido sem o mutex (ex.: pelo Poller)
+    bool HasPending() const { return has_pending.load(std::memory_order_acquire); }
+
+    std::atomic<bool> has_pending{ false };
+
+    std::atomic<uint32_t> pending_frames{ 0 };
+
+    // Canal do reactor, se o socket estiver ligado a ele. Lido sem o mutex
+    // do socket: usar só com std::atomic_load/atomic_store/atomic_exchange
+    std::shared_ptr<ReactorChannel> reactor;
+
+    // Envelope de rastreio (ver zmq_bridge_set_envelope)
+    bool envelope = false;
+
+    uint32_t envelope_sender = 0;
+
+    // Próximo número de sequência de cada fluxo, identificado pelo primeiro
+    // frame da mensagem (tópico em PUB, identidade do destino em ROUTER;
+    // vazio em mensagens de um só frame); no máximo
+    // ZMQ_BRIDGE_ENVELOPE_MAX_STREAMS
+    std::unordered_map<std::string, uint64_t> envelope_sequence;
+
+    // Primeiro frame da mensagem em curso e se o próximo frame enviado
+    // começa uma mensagem nova
+    std::string envelope_send_key;
+
+    bool envelope_send_start = true;
+
+    // Último número de sequência recebido de cada fluxo (chave: u32 do
+    // emissor seguido do primeiro frame da mensagem) e quando foi usado,
+    // para esquecer os menos usados
+    struct EnvelopeStream {
+        uint64_t sequence = 0;
+
+        uint64_t used = 0;
+    };
+
+    std::unordered_map<std::string, EnvelopeStream> envelope_last_sequence;
+
+    uint64_t envelope_receive_tick = 0;
+
+    std::string envelope_receive_key;
+
+    bool envelope_receive_start = true;
+
+    // Ativa ou desativa o envelope; chamar com o mutex do socket
+    void EnableEnvelope(bool enabled);
+
+    // Estado RPC, criado no primeiro zmq_bridge_rpc_* (DEALER ou ROUTER)
+    std::unique_ptr<RpcClient> rpc_client;
+
+    std::unique_ptr<RpcServer> rpc_server;
+
+    // Gravador que recebe as mensagens enviadas (ver Recorder::Tap)
+    Recorder* recorder = nullptr;
+
+    int recorder_channel = 0;
+
+    // Frames da mensagem em curso, até ao último
+    std::vector<unsigned char> tap_buffer;
+
+    std::vector<size_t> tap_sizes;
+
+    std::vector<LogFrame> tap_frames;
+};
+
+
+// Acesso exclusivo a um socket enquanto o objeto existir
+class SocketLock {
+public:
+    SocketLock() = default;
+
+    SocketLock(SocketState* state, std::unique_lock<std::mutex> lock)
+        : m_state(state), m_lock(std::move(lock))
+    {
+    }
+
+    explicit operator bool() const { return m_state != nullptr; }
+
+    zmq::socket_t& Socket() const { return *m_state->socket; }
+
+    SocketState& State() const { return *m_state; }
+
+private:
+    SocketState* m_state = nullptr;
+
+    std::unique_lock<std::mutex> m_lock;
+};
+
+
 class SocketManager {
 public:
-    int CreateSocket(zmq::socket_type type, const std::string& endpoint, bool bind_socket);
-    
-    int CreateSubscriber(const std::string& endpoint, const std::string& topic);
-    
-    zmq::socket_t* GetSocket(int socket_id);
-    
+    // options (opcional) é aplicado antes de bind/connect; topic (opcional)
+    // é subscrito em sockets SUB
+    int CreateSocket(zmq::socket_type type, const std::string& endpoint, bool bind_socket,
+                     const zmq_bridge_socket_options* options = nullptr,
+                     const std::string* topic = nullptr);
+
+    // Com conflate, o socket guarda só a última mensagem (ZMQ_CONFLATE)
+    int CreateSubscriber(const std::string& endpoint, const std::string& topic,
+                         bool conflate = false);
+
+    // Procura o socket sem locks e bloqueia apenas o mutex desse socket
+    SocketLock Acquire(int socket_id);
+
+    // Consulta sem locks se há frames pendentes (ver SocketState::pending)
+    bool HasPending(int socket_id) const;
+
+    bool IsValid(int socket_id) const { return m_sockets.IsCurrent(socket_id); }
+
+    // Estado do socket sem bloquear o seu mutex; só para campos atómicos
+    SocketState* Find(int socket_id) const { return m_sockets.Lookup(socket_id); }
+
     bool CloseSocket(int socket_id);
-    
+
     void CloseAllSockets();
-    
-    const std::string& GetLastError() const;
-    
+
 private:
-    std::unordered_map<int, std::unique_ptr<zmq::socket_t>> m_sockets;
-    
-    int m_next_socket_id = 1;
-    
-    std::mutex m_mutex;
-    
-    std::string m_error;
+    int Register(std::unique_ptr<zmq::socket_t> socket);
+
+    HandleTable<SocketState> m_sockets;
 };
 
- 
+
 class Context {
 public:
-    bool Initialize();
-    
+    // config (opcional) é aplicado antes de criar qualquer socket, enquanto
+    // as threads de I/O ainda não arrancaram
+    bool Initialize(const zmq_bridge_config* config = nullptr);
+
+    // Valores efetivos do contexto atual (ver zmq_bridge_config)
+    void GetEffectiveConfig(zmq_bridge_config& config);
+
     void Shutdown();
-    
+
+    bool IsInitialized() const;
+
     zmq::context_t* GetContext();
-    
+
     SocketManager& GetSocketManager();
-    
-    const std::string& GetLastError() const;
-    
+
+    HandleTable<Poller>& GetPollers();
+
+    Reactor& GetReactor();
+
+    Dispatcher& GetDispatcher();
+
+    HandleTable<LatestPublisher>& GetLatestPublishers();
+
+    HandleTable<ShmPublisher>& GetShmPublishers();
+
+    ShmReaders& GetShmReaders();
+
+    HandleTable<Recorder>& GetRecorders();
+
+    HandleTable<Replayer>& GetReplayers();
+
+    HandleTable<Scheduler>& GetSchedulers();
+
+    Encoder& GetEncoder();
+
+    SchemaRegistry& GetSchemas();
+
+    TopicRegistry& GetTopics();
+
     static Context& Instance();
-    
+
 private:
     Context() = default;
-    
+
     Context(const Context&) = delete;
     Context& operator=(const Context&) = delete;
-    
-    static Context _instance;
-    
+
     std::unique_ptr<zmq::context_t> m_context;
-    
+
+    // Não pode ser lida do libzmq
+    int m_thread_priority = -1;
+
     SocketManager m_socket_manager;
-    
-    bool m_initialized = false;
-    
-    std::string m_error;
+
+    HandleTable<Poller> m_pollers;
+
+    Reactor m_reactor;
+
+    Dispatcher m_dispatcher;
+
+    HandleTable<LatestPublisher> m_latest_publishers;
+
+    HandleTable<ShmPublisher> m_shm_publishers;
+
+    ShmReaders m_shm_readers;
+
+    HandleTable<Recorder> m_recorders;
+
+    HandleTable<Replayer> m_replayers;
+
+    HandleTable<Scheduler> m_schedulers;
+
+    Encoder m_encoder;
+
+    // Não dependem do contexto ZeroMQ: sobrevivem a Shutdown()
+    SchemaRegistry m_schemas;
+
+    TopicRegistry m_topics;
+
+    std::atomic<bool> m_initialized{ false };
+
+    // Serializa Initialize/Shutdown
+    std::mutex m_mutex;
 };
 
 } // namespace internal
-} // namespace zmq_bridge
\ No newline at end of file
+} // namespace zmq_bridge
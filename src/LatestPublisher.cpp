@@ -0,0 +1,230 @@
+#include <zmq.hpp>
+#include <cstring>
+#include "ZMQBridge.h"
+#include "BufferPool.h"
+#include "Internal.h"
+#include "LatestPublisher.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    LatestPublisher::~LatestPublisher()
+    {
+        Stop();
+    }
+
+
+    bool LatestPublisher::Start(int socket_id, int flags)
+    {
+        Stop();
+
+        {
+            std::lock_guard<std::mutex> lock(m_topics_mutex);
+            m_topics.clear();
+            m_topic_list.clear();
+            m_topic_count = 0;
+        }
+
+        m_socket_id = socket_id;
+        m_flags = flags;
+        m_signaled = false;
+        m_running = true;
+
+        try
+        {
+            m_thread = std::thread(&LatestPublisher::Run, this);
+            return true;
+        } catch (const std::system_error& e)
+        {
+            m_running = false;
+            SetLastError("Failed to start latest publisher thread: "
+                         + std::string(e.what()));
+            return false;
+        }
+    }
+
+
+    void LatestPublisher::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+            m_running = false;
+        }
+
+        m_wake.notify_one();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+
+    std::shared_ptr<LatestTopic> LatestPublisher::FindOrAddTopic(const std::string& topic)
+    {
+        std::lock_guard<std::mutex> lock(m_topics_mutex);
+
+        auto it = m_topics.find(topic);
+        if (it != m_topics.end())
+        {
+            return it->second;
+        }
+
+        auto entry = std::make_shared<LatestTopic>(topic);
+        m_topics.emplace(topic, entry);
+        m_topic_list.push_back(entry);
+        m_topic_count = m_topic_list.size();
+
+        return entry;
+    }
+
+
+    bool LatestPublisher::Publish(const std::string& topic, const void* data, size_t size)
+    {
+        if (!m_running)
+        {
+            SetLastError("Invalid latest publisher ID");
+            return false;
+        }
+
+        std::shared_ptr<LatestTopic> entry = FindOrAddTopic(topic);
+
+        {
+            std::lock_guard<std::mutex> lock(entry->write_mutex);
+
+            // assign reutiliza a capacidade do buffer: sem alocações depois
+            // dos primeiros frames do tópico
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            entry->frames.Back().assign(bytes, bytes + size);
+
+            ++entry->published;
+            if (entry->frames.Publish())
+            {
+                ++entry->overwritten;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+            m_signaled = true;
+        }
+
+        m_wake.notify_one();
+        return true;
+    }
+
+
+    void LatestPublisher::GetStats(const char* topic, zmq_bridge_latest_stats* stats)
+    {
+        *stats = zmq_bridge_latest_stats();
+
+        std::lock_guard<std::mutex> lock(m_topics_mutex);
+
+        for (const auto& entry : m_topic_list)
+        {
+            if (topic && entry->topic != topic)
+            {
+                continue;
+            }
+
+            stats->published += static_cast<long long>(entry->published.load());
+            stats->sent += static_cast<long long>(entry->sent.load());
+            stats->overwritten += static_cast<long long>(entry->overwritten.load());
+            stats->dropped += static_cast<long long>(entry->dropped.load());
+        }
+    }
+
+
+    bool LatestPublisher::SendFront(LatestTopic& topic, SocketState& state)
+    {
+        const std::vector<unsigned char>& frame = topic.frames.Front();
+
+        try
+        {
+            if (m_flags & ZMQ_BRIDGE_LATEST_SINGLE_FRAME)
+            {
+                // [tópico + dados] num só frame, compatível com ZMQ_CONFLATE
+                zmq::message_t message =
+                    BufferPool::Instance().AllocateMessage(topic.topic.size() + frame.size());
+                memcpy(message.data(), topic.topic.data(), topic.topic.size());
+                if (!frame.empty())
+                {
+                    memcpy(static_cast<char*>(message.data()) + topic.topic.size(),
+                           frame.data(), frame.size());
+                }
+
+                return state.Send(message, zmq::send_flags::dontwait).has_value();
+            }
+
+            zmq::message_t topic_msg(topic.topic.data(), topic.topic.size());
+            if (!state.Send(topic_msg, zmq::send_flags::sndmore
+                                            | zmq::send_flags::dontwait))
+            {
+                return false;
+            }
+
+            // Aceite o primeiro frame, o libzmq aceita o resto da mensagem
+            zmq::message_t data_msg = BufferPool::Instance().CopyMessage(frame.data(), frame.size());
+            return state.Send(data_msg, zmq::send_flags::dontwait).has_value();
+        } catch (const zmq::error_t& e)
+        {
+            SetLastError("Latest publish error: " + std::string(e.what()));
+            return false;
+        }
+    }
+
+
+    void LatestPublisher::Run()
+    {
+        SetBackgroundThread("latest publisher");
+
+        std::vector<std::shared_ptr<LatestTopic>> topics;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_wake_mutex);
+                m_wake.wait(lock, [this] { return m_signaled || !m_running; });
+
+                if (!m_running)
+                {
+                    break;
+                }
+
+                m_signaled = false;
+            }
+
+            if (topics.size() != m_topic_count.load())
+            {
+                std::lock_guard<std::mutex> lock(m_topics_mutex);
+                topics = m_topic_list;
+            }
+
+            // Um frame que o socket não aceite (socket fechado, erro de
+            // envio, EAGAIN fora de PUB) é descartado: o próximo Publish()
+            // traz um mais recente. Um PUB no HWM aceita e descarta sem
+            // avisar, por isso esses frames contam como enviados
+            SocketLock lock = Context::Instance().GetSocketManager().Acquire(m_socket_id);
+
+            for (const auto& topic : topics)
+            {
+                if (!topic->frames.Update())
+                {
+                    continue;
+                }
+
+                if (lock && SendFront(*topic, lock.State()))
+                {
+                    ++topic->sent;
+                }
+                else
+                {
+                    ++topic->dropped;
+                }
+            }
+        }
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,101 @@
+// LatestPublisher.h - Publicação "último valor" por tópico
+#pragma once
+
+#include <zmq.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ZMQBridge.h"
+#include "TripleBuffer.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+struct SocketState;
+
+
+// Estado de um tópico: o último frame publicado e os seus contadores
+struct LatestTopic {
+    explicit LatestTopic(const std::string& name) : topic(name) {}
+
+    const std::string topic;
+
+    // Serializa produtores do mesmo tópico (o TripleBuffer só admite um)
+    std::mutex write_mutex;
+
+    TripleBuffer<std::vector<unsigned char>> frames;
+
+    std::atomic<uint64_t> published{ 0 };
+
+    std::atomic<uint64_t> sent{ 0 };
+
+    std::atomic<uint64_t> overwritten{ 0 };
+
+    std::atomic<uint64_t> dropped{ 0 };
+};
+
+
+// Publica, por tópico, apenas o frame mais recente num socket existente.
+// Publish() copia os dados para o TripleBuffer do tópico e regressa logo;
+// uma thread própria envia o que estiver pendente. Se o produtor for mais
+// rápido do que o envio, os frames intermédios são substituídos (contados
+// em overwritten) em vez de ficarem em fila atrás do HWM do socket.
+class LatestPublisher {
+public:
+    LatestPublisher() = default;
+
+    ~LatestPublisher();
+
+    LatestPublisher(const LatestPublisher&) = delete;
+    LatestPublisher& operator=(const LatestPublisher&) = delete;
+
+    bool Start(int socket_id, int flags);
+
+    void Stop();
+
+    bool Publish(const std::string& topic, const void* data, size_t size);
+
+    // Soma dos contadores de um tópico, ou de todos se topic for NULL
+    void GetStats(const char* topic, zmq_bridge_latest_stats* stats);
+
+private:
+    void Run();
+
+    std::shared_ptr<LatestTopic> FindOrAddTopic(const std::string& topic);
+
+    // Envia Front() do tópico; devolve false se o socket não o aceitou
+    bool SendFront(LatestTopic& topic, SocketState& state);
+
+    int m_socket_id = -1;
+
+    int m_flags = 0;
+
+    std::thread m_thread;
+
+    std::atomic<bool> m_running{ false };
+
+    // Protege m_topics e m_topic_list
+    std::mutex m_topics_mutex;
+
+    std::unordered_map<std::string, std::shared_ptr<LatestTopic>> m_topics;
+
+    std::vector<std::shared_ptr<LatestTopic>> m_topic_list;
+
+    std::atomic<size_t> m_topic_count{ 0 };
+
+    // Acorda a thread de envio quando há frames novos
+    std::mutex m_wake_mutex;
+
+    std::condition_variable m_wake;
+
+    bool m_signaled = false;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
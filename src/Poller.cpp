@@ -0,0 +1,461 @@
+#include <zmq.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "ZMQBridge.h"
+#include "Internal.h"
+#include "Poller.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    // user_data do socket de despertar nos eventos do zmq_poller
+    static const int kWakeId = -1;
+
+
+    static std::string ZmqErrorString()
+    {
+        return std::string(zmq_strerror(zmq_errno()));
+    }
+
+
+    class Poller::Interrupt {
+    public:
+        explicit Interrupt(Poller& poller) : m_poller(poller)
+        {
+            // Contado antes do sinal: um Wait() que já tenha consumido o
+            // sinal vê m_interrupts e não volta a esperar
+            m_poller.m_interrupts.fetch_add(1);
+
+            {
+                std::lock_guard<std::mutex> wake_lock(m_poller.m_wake_mutex);
+                if (m_poller.m_wake_send)
+                {
+                    try
+                    {
+                        zmq::message_t signal;
+                        m_poller.m_wake_send->send(signal, zmq::send_flags::dontwait);
+                    } catch (const zmq::error_t&)
+                    {
+                        // Com o contexto a fechar, Wait() também regressa
+                    }
+                }
+            }
+
+            m_lock = std::unique_lock<std::mutex>(m_poller.m_mutex);
+        }
+
+        ~Interrupt()
+        {
+            m_lock.unlock();
+            m_poller.m_interrupts.fetch_sub(1);
+        }
+
+        Interrupt(const Interrupt&) = delete;
+        Interrupt& operator=(const Interrupt&) = delete;
+
+    private:
+        Poller& m_poller;
+
+        std::unique_lock<std::mutex> m_lock;
+    };
+
+
+    bool Poller::Open()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_entries.clear();
+
+        zmq::context_t* context = Context::Instance().GetContext();
+        if (!context)
+        {
+            return false;
+        }
+
+        // Endpoint único por poller
+        static std::atomic<uint64_t> next_wake{ 0 };
+        std::string endpoint = "inproc://zmq_bridge.poller." + std::to_string(next_wake++);
+
+        try
+        {
+            m_wake_recv = std::make_unique<zmq::socket_t>(*context, zmq::socket_type::pair);
+            m_wake_recv->set(zmq::sockopt::linger, 0);
+            m_wake_recv->bind(endpoint);
+
+            auto wake_send = std::make_unique<zmq::socket_t>(*context, zmq::socket_type::pair);
+            wake_send->set(zmq::sockopt::linger, 0);
+            wake_send->connect(endpoint);
+
+            std::lock_guard<std::mutex> wake_lock(m_wake_mutex);
+            m_wake_send = std::move(wake_send);
+        } catch (const zmq::error_t& e)
+        {
+            m_wake_recv.reset();
+            SetLastError("Failed to create poller wake socket: " + std::string(e.what()));
+            return false;
+        }
+
+#ifdef ZMQ_HAVE_POLLER
+        m_poller = zmq_poller_new();
+        if (!m_poller
+            || zmq_poller_add(m_poller, m_wake_recv->handle(),
+                              reinterpret_cast<void*>(static_cast<intptr_t>(kWakeId)),
+                              ZMQ_POLLIN)
+                   != 0)
+        {
+            SetLastError("Failed to create poller: " + ZmqErrorString());
+            if (m_poller)
+            {
+                zmq_poller_destroy(&m_poller);
+                m_poller = nullptr;
+            }
+
+            std::lock_guard<std::mutex> wake_lock(m_wake_mutex);
+            m_wake_send.reset();
+            m_wake_recv.reset();
+            return false;
+        }
+#endif
+
+        m_open = true;
+        return true;
+    }
+
+
+    void Poller::Close()
+    {
+        Interrupt interrupt(*this);
+
+#ifdef ZMQ_HAVE_POLLER
+        if (m_poller)
+        {
+            zmq_poller_destroy(&m_poller);
+            m_poller = nullptr;
+        }
+#endif
+
+        m_entries.clear();
+        SyncIds();
+
+        {
+            std::lock_guard<std::mutex> wake_lock(m_wake_mutex);
+            m_wake_send.reset();
+        }
+
+        m_wake_recv.reset();
+        m_open = false;
+    }
+
+
+    std::vector<Poller::Entry>::iterator Poller::Find(int socket_id)
+    {
+        return std::find_if(m_entries.begin(), m_entries.end(),
+                            [socket_id](const Entry& entry) {
+                                return entry.socket_id == socket_id;
+                            });
+    }
+
+
+    bool Poller::Add(int socket_id, int events)
+    {
+        Interrupt interrupt(*this);
+
+        if (!m_open)
+        {
+            SetLastError("Invalid poller ID");
+            return false;
+        }
+
+        if (Find(socket_id) != m_entries.end())
+        {
+            SetLastError("Socket already registered in poller");
+            return false;
+        }
+
+        SocketLock socket = Context::Instance().GetSocketManager().Acquire(socket_id);
+        if (!socket)
+        {
+            return false;
+        }
+
+        void* handle = socket.Socket().handle();
+
+#ifdef ZMQ_HAVE_POLLER
+        // O ID do socket segue como user_data e volta em cada evento
+        if (zmq_poller_add(m_poller, handle,
+                           reinterpret_cast<void*>(static_cast<intptr_t>(socket_id)),
+                           static_cast<short>(events))
+            != 0)
+        {
+            SetLastError("Failed to add socket to poller: " + ZmqErrorString());
+            return false;
+        }
+#endif
+
+        m_entries.push_back({ socket_id, handle, events });
+        SyncIds();
+        return true;
+    }
+
+
+    bool Poller::Modify(int socket_id, int events)
+    {
+        Interrupt interrupt(*this);
+
+        auto it = Find(socket_id);
+        if (it == m_entries.end())
+        {
+            SetLastError("Socket not registered in poller");
+            return false;
+        }
+
+#ifdef ZMQ_HAVE_POLLER
+        if (zmq_poller_modify(m_poller, it->handle, static_cast<short>(events)) != 0)
+        {
+            SetLastError("Failed to modify poller entry: " + ZmqErrorString());
+            return false;
+        }
+#endif
+
+        it->events = events;
+        return true;
+    }
+
+
+    bool Poller::Remove(int socket_id)
+    {
+        Interrupt interrupt(*this);
+
+        auto it = Find(socket_id);
+        if (it == m_entries.end())
+        {
+            SetLastError("Socket not registered in poller");
+            return false;
+        }
+
+#ifdef ZMQ_HAVE_POLLER
+        zmq_poller_remove(m_poller, it->handle);
+#endif
+
+        m_entries.erase(it);
+        SyncIds();
+        return true;
+    }
+
+
+    void Poller::Forget(int socket_id)
+    {
+        // Sem interromper se o socket não estiver neste poller: CloseSocket
+        // chama Forget em todos
+        {
+            std::lock_guard<std::mutex> wake_lock(m_wake_mutex);
+            if (std::find(m_ids.begin(), m_ids.end(), socket_id) == m_ids.end())
+            {
+                return;
+            }
+        }
+
+        Interrupt interrupt(*this);
+
+        auto it = Find(socket_id);
+        if (it == m_entries.end())
+        {
+            return;
+        }
+
+#ifdef ZMQ_HAVE_POLLER
+        zmq_poller_remove(m_poller, it->handle);
+#endif
+
+        m_entries.erase(it);
+        SyncIds();
+    }
+
+
+    void Poller::SyncIds()
+    {
+        std::lock_guard<std::mutex> wake_lock(m_wake_mutex);
+
+        m_ids.clear();
+        for (const Entry& entry : m_entries)
+        {
+            m_ids.push_back(entry.socket_id);
+        }
+    }
+
+
+    void Poller::PruneClosed()
+    {
+        auto& manager = Context::Instance().GetSocketManager();
+        bool pruned = false;
+
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if (manager.IsValid(it->socket_id))
+            {
+                ++it;
+                continue;
+            }
+
+#ifdef ZMQ_HAVE_POLLER
+            zmq_poller_remove(m_poller, it->handle);
+#endif
+            it = m_entries.erase(it);
+            pruned = true;
+        }
+
+        if (pruned)
+        {
+            SyncIds();
+        }
+    }
+
+
+    void Poller::DrainWake()
+    {
+        try
+        {
+            zmq::message_t signal;
+            while (m_wake_recv->recv(signal, zmq::recv_flags::dontwait))
+            {
+            }
+        } catch (const zmq::error_t&)
+        {
+        }
+    }
+
+
+    int Poller::Wait(zmq_bridge_poll_event* events, int max_events,
+                     int timeout_ms)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_open)
+        {
+            SetLastError("Invalid poller ID");
+            return -1;
+        }
+
+        if (max_events <= 0)
+        {
+            SetLastError("Invalid event buffer size");
+            return -1;
+        }
+
+        // Uma alteração está à espera de m_mutex
+        if (m_interrupts.load() > 0)
+        {
+            return 0;
+        }
+
+        PruneClosed();
+
+        // Frames já lidos e ainda não entregues: responde sem esperar
+        auto& manager = Context::Instance().GetSocketManager();
+        int count = 0;
+        for (const Entry& entry : m_entries)
+        {
+            if (count < max_events && (entry.events & ZMQ_POLLIN)
+                && manager.HasPending(entry.socket_id))
+            {
+                events[count].socket_id = entry.socket_id;
+                events[count].events = ZMQ_POLLIN;
+                ++count;
+            }
+        }
+
+        if (count > 0)
+        {
+            return count;
+        }
+
+        // Sem sockets, espera só pelo socket de despertar até ao timeout
+        if (m_entries.empty() && timeout_ms < 0)
+        {
+            SetLastError("Poller has no sockets");
+            return -1;
+        }
+
+#ifdef ZMQ_HAVE_POLLER
+        // Mais um lugar para o socket de despertar
+        m_ready.resize(static_cast<size_t>(max_events) + 1);
+
+        int rc = zmq_poller_wait_all(m_poller, m_ready.data(), max_events + 1,
+                                     timeout_ms);
+        if (rc < 0)
+        {
+            // EAGAIN: nenhum socket ficou pronto dentro do timeout
+            if (zmq_errno() == EAGAIN || zmq_errno() == EINTR)
+            {
+                return 0;
+            }
+
+            SetLastError("Poll error: " + ZmqErrorString());
+            return -1;
+        }
+
+        for (int i = 0; i < rc; ++i)
+        {
+            int socket_id = static_cast<int>(reinterpret_cast<intptr_t>(m_ready[i].user_data));
+            if (socket_id == kWakeId)
+            {
+                DrainWake();
+                continue;
+            }
+
+            if (count < max_events)
+            {
+                events[count].socket_id = socket_id;
+                events[count].events = m_ready[i].events;
+                ++count;
+            }
+        }
+
+        return count;
+#else
+        m_items.resize(m_entries.size() + 1);
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            m_items[i] = { m_entries[i].handle, 0,
+                           static_cast<short>(m_entries[i].events), 0 };
+        }
+
+        m_items.back() = { m_wake_recv->handle(), 0, ZMQ_POLLIN, 0 };
+
+        int rc = zmq_poll(m_items.data(), static_cast<int>(m_items.size()),
+                          timeout_ms);
+        if (rc < 0)
+        {
+            if (zmq_errno() == EINTR)
+            {
+                return 0;
+            }
+
+            SetLastError("Poll error: " + ZmqErrorString());
+            return -1;
+        }
+
+        if (m_items.back().revents)
+        {
+            DrainWake();
+        }
+
+        for (size_t i = 0; i < m_entries.size() && count < max_events; ++i)
+        {
+            if (m_items[i].revents)
+            {
+                events[count].socket_id = m_entries[i].socket_id;
+                events[count].events = m_items[i].revents;
+                ++count;
+            }
+        }
+
+        return count;
+#endif
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,103 @@
+// Poller.h - Espera por vários sockets com uma única chamada
+#pragma once
+
+#include <zmq.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "ZMQBridge.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Conjunto de sockets (por ID) e eventos a esperar. Usa zmq_poller quando a
+// libzmq o disponibiliza e zmq_poll caso contrário.
+//
+// Wait() não bloqueia os mutexes dos sockets, para não parar outras
+// threads durante o timeout. Por isso, enquanto um socket estiver num
+// poller, só a thread que chama Wait() o deve ler ou escrever: o libzmq
+// não admite o mesmo socket em duas threads ao mesmo tempo.
+//
+// Add/Modify/Remove/Forget/Close acordam um Wait() em curso (um par de
+// sockets PAIR inproc) em vez de esperarem pelo fim do timeout; depois de
+// Forget() regressar, o socket já não é usado pelo poller e pode ser
+// fechado. Por isso Wait() pode regressar com 0 eventos antes do timeout.
+class Poller {
+public:
+    Poller() = default;
+
+    Poller(const Poller&) = delete;
+    Poller& operator=(const Poller&) = delete;
+
+    bool Open();
+
+    void Close();
+
+    bool Add(int socket_id, int events);
+
+    bool Modify(int socket_id, int events);
+
+    bool Remove(int socket_id);
+
+    // Como Remove, mas sem erro se o socket não estiver registado
+    void Forget(int socket_id);
+
+    // Devolve o número de eventos escritos em events, ou -1 em caso de erro
+    int Wait(zmq_bridge_poll_event* events, int max_events, int timeout_ms);
+
+private:
+    struct Entry
+    {
+        int socket_id;
+        void* handle;
+        int events;
+    };
+
+    std::vector<Entry>::iterator Find(int socket_id);
+
+    // Remove sockets entretanto fechados
+    void PruneClosed();
+
+    // Copia os IDs de m_entries para m_ids; chamar com m_mutex
+    void SyncIds();
+
+    // Acorda o Wait() em curso e bloqueia m_mutex enquanto existir
+    class Interrupt;
+
+    // Descarta os sinais de BeginInterrupt() já recebidos
+    void DrainWake();
+
+    // Mantido durante todo o Wait()
+    std::mutex m_mutex;
+
+    // Alterações à espera de m_mutex: Wait() regressa logo enquanto houver
+    std::atomic<int> m_interrupts{ 0 };
+
+    // Protege m_wake_send (usado por várias threads) e m_ids
+    std::mutex m_wake_mutex;
+
+    std::unique_ptr<zmq::socket_t> m_wake_send;
+
+    // IDs registados, para Forget() sem bloquear m_mutex
+    std::vector<int> m_ids;
+
+    // Só com m_mutex
+    std::unique_ptr<zmq::socket_t> m_wake_recv;
+
+    std::vector<Entry> m_entries;
+
+#ifdef ZMQ_HAVE_POLLER
+    void* m_poller = nullptr;
+
+    std::vector<zmq_poller_event_t> m_ready;
+#else
+    std::vector<zmq_pollitem_t> m_items;
+#endif
+
+    bool m_open = false;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,359 @@
+#include <zmq.hpp>
+#include <algorithm>
+#include <chrono>
+#include "ZMQBridge.h"
+#include "Internal.h"
+#include "Reactor.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    Reactor::~Reactor()
+    {
+        if (m_running.exchange(false) && m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+
+    bool Reactor::Start(int idle_timeout_ms)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_running)
+        {
+            return true;
+        }
+
+        m_idle_timeout_ms = idle_timeout_ms > 0 ? idle_timeout_ms : 1;
+        m_running = true;
+
+        try
+        {
+            m_thread = std::thread(&Reactor::Run, this);
+            return true;
+        } catch (const std::system_error& e)
+        {
+            m_running = false;
+            SetLastError("Failed to start reactor thread: " + std::string(e.what()));
+            return false;
+        }
+    }
+
+
+    void Reactor::Stop()
+    {
+        // Com m_mutex: um Attach() em curso ou já ligou o canal (e é
+        // desligado abaixo) ou vê o reactor parado
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_running.exchange(false))
+            {
+                return;
+            }
+        }
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Desliga os sockets que ainda apontam para os canais
+        auto& manager = Context::Instance().GetSocketManager();
+        for (auto& channel : m_channels)
+        {
+            channel->attached = false;
+
+            SocketState* state = manager.Find(channel->socket_id);
+            if (state)
+            {
+                std::shared_ptr<ReactorChannel> expected = channel;
+                std::atomic_compare_exchange_strong(&state->reactor, &expected,
+                                                    std::shared_ptr<ReactorChannel>());
+            }
+        }
+
+        m_channels.clear();
+        ++m_channels_version;
+    }
+
+
+    bool Reactor::Attach(int socket_id, int queue_capacity)
+    {
+        if (!m_running)
+        {
+            SetLastError("Reactor not running");
+            return false;
+        }
+
+        if (queue_capacity <= 0)
+        {
+            SetLastError("Invalid queue capacity");
+            return false;
+        }
+
+        SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+        if (!lock)
+        {
+            return false;
+        }
+
+        if (std::atomic_load(&lock.State().reactor))
+        {
+            SetLastError("Socket already attached to reactor");
+            return false;
+        }
+
+        auto channel = std::make_shared<ReactorChannel>(
+            socket_id, static_cast<size_t>(queue_capacity));
+
+        try
+        {
+            int type = lock.Socket().get(zmq::sockopt::type);
+            channel->can_send = type != ZMQ_SUB && type != ZMQ_PULL;
+            channel->can_receive = type != ZMQ_PUB && type != ZMQ_PUSH;
+            channel->fd = lock.Socket().get(zmq::sockopt::fd);
+        } catch (const zmq::error_t& e)
+        {
+            SetLastError("Failed to query socket: " + std::string(e.what()));
+            return false;
+        }
+
+        std::lock_guard<std::mutex> channels_lock(m_mutex);
+
+        // Stop() pode ter corrido entretanto: sem thread, o canal nunca
+        // seria servido
+        if (!m_running)
+        {
+            SetLastError("Reactor not running");
+            return false;
+        }
+
+        std::atomic_store(&lock.State().reactor, channel);
+        m_channels.push_back(std::move(channel));
+        ++m_channels_version;
+
+        return true;
+    }
+
+
+    bool Reactor::Detach(int socket_id)
+    {
+        SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+        if (!lock)
+        {
+            return false;
+        }
+
+        // Os frames ainda na fila de saída são descartados
+        std::shared_ptr<ReactorChannel> channel =
+            std::atomic_exchange(&lock.State().reactor, std::shared_ptr<ReactorChannel>());
+        if (!channel)
+        {
+            SetLastError("Socket not attached to reactor");
+            return false;
+        }
+
+        Retire(*channel);
+        return true;
+    }
+
+
+    void Reactor::Retire(ReactorChannel& channel)
+    {
+        channel.attached = false;
+        ++m_channels_version;
+    }
+
+
+    std::shared_ptr<ReactorChannel> Reactor::Find(int socket_id) const
+    {
+        SocketState* state = Context::Instance().GetSocketManager().Find(socket_id);
+        if (!state)
+        {
+            return nullptr;
+        }
+
+        std::shared_ptr<ReactorChannel> channel = std::atomic_load(&state->reactor);
+        if (!channel || !channel->attached.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        return channel;
+    }
+
+
+    bool Reactor::FlushOutgoing(ReactorChannel& channel, SocketState& state)
+    {
+        bool moved = false;
+
+        while (ReactorFrame* frame = channel.outgoing.Front())
+        {
+            zmq::send_flags flags = frame->more
+                ? zmq::send_flags::dontwait | zmq::send_flags::sndmore
+                : zmq::send_flags::dontwait;
+
+            try
+            {
+                // EAGAIN: o frame fica na fila até o socket aceitar mais
+                if (!state.Send(frame->message, flags).has_value())
+                {
+                    break;
+                }
+            } catch (const zmq::error_t& e)
+            {
+                // Descarta o frame para não repetir o mesmo erro para sempre
+                SetLastError("Reactor send error: " + std::string(e.what()));
+            }
+
+            channel.outgoing.Pop();
+            moved = true;
+        }
+
+        return moved;
+    }
+
+
+    bool Reactor::FillIncoming(ReactorChannel& channel, SocketState& state)
+    {
+        bool moved = false;
+
+        while (channel.incoming.Free() > 0)
+        {
+            ReactorFrame frame;
+            if (!state.Receive(frame.message, zmq::recv_flags::dontwait))
+            {
+                break;
+            }
+
+            frame.more = frame.message.more();
+            channel.incoming.TryPush(std::move(frame));
+            moved = true;
+        }
+
+        return moved;
+    }
+
+
+    void Reactor::Run()
+    {
+        SetBackgroundThread("reactor");
+
+        auto& manager = Context::Instance().GetSocketManager();
+
+        std::vector<std::shared_ptr<ReactorChannel>> channels;
+        unsigned version = m_channels_version.load() - 1;
+
+        std::vector<zmq::pollitem_t> items;
+
+        while (m_running)
+        {
+            // Atualiza a lista de canais só quando muda, libertando os
+            // desligados (um chamador ainda com o canal mantém-no vivo)
+            if (version != m_channels_version.load(std::memory_order_acquire))
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                version = m_channels_version.load();
+
+                m_channels.erase(std::remove_if(m_channels.begin(), m_channels.end(),
+                                                [](const std::shared_ptr<ReactorChannel>& channel) {
+                                                    return !channel->attached;
+                                                }),
+                                 m_channels.end());
+                channels = m_channels;
+            }
+
+            bool busy = false;
+            items.clear();
+
+            for (const auto& channel : channels)
+            {
+                if (!channel->attached.load(std::memory_order_acquire))
+                {
+                    continue;
+                }
+
+                SocketLock lock = manager.Acquire(channel->socket_id);
+                if (!lock)
+                {
+                    continue;
+                }
+
+                short events = 0;
+
+                try
+                {
+                    if (channel->can_send)
+                    {
+                        busy |= FlushOutgoing(*channel, lock.State());
+
+                        if (channel->outgoing.Front())
+                        {
+                            events |= ZMQ_POLLOUT;
+                        }
+                    }
+
+                    if (channel->can_receive)
+                    {
+                        busy |= FillIncoming(*channel, lock.State());
+
+                        if (channel->incoming.Free() > 0)
+                        {
+                            events |= ZMQ_POLLIN;
+                        }
+                    }
+
+                    // O ZMQ_FD só assinala mudanças: se o socket já está
+                    // pronto não haverá sinal, por isso não se espera
+                    if (events)
+                    {
+                        if (lock.Socket().get(zmq::sockopt::events) & events)
+                        {
+                            busy = true;
+                        }
+                        else
+                        {
+                            items.push_back({ nullptr, channel->fd, ZMQ_POLLIN, 0 });
+                        }
+                    }
+                } catch (const zmq::error_t& e)
+                {
+                    SetLastError("Reactor error: " + std::string(e.what()));
+                }
+            }
+
+            if (busy)
+            {
+                continue;
+            }
+
+            // Sem trabalho: espera pela rede nos ZMQ_FD, sem nenhum socket
+            // (um socket fechado durante a espera não é tocado); frames
+            // novos na fila de saída são apanhados no máximo ao fim de
+            // m_idle_timeout_ms
+            try
+            {
+                if (items.empty())
+                {
+                    std::this_thread::sleep_for(
+                        std::chrono::milliseconds(m_idle_timeout_ms));
+                }
+                else
+                {
+                    zmq::poll(items.data(), items.size(),
+                              std::chrono::milliseconds(m_idle_timeout_ms));
+                }
+            } catch (const zmq::error_t& e)
+            {
+                SetLastError("Reactor poll error: " + std::string(e.what()));
+            }
+        }
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,111 @@
+// Reactor.h - Thread de I/O dedicada que serve sockets através de filas SPSC
+#pragma once
+
+#include <zmq.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SpscRing.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+struct SocketState;
+
+
+// Frame em trânsito entre o chamador e a thread de I/O
+struct ReactorFrame {
+    zmq::message_t message;
+
+    bool more = false;
+};
+
+
+// Filas de um socket ligado ao reactor. outgoing: chamador -> I/O;
+// incoming: I/O -> chamador. Cada sentido admite um único produtor e um
+// único consumidor: do lado do chamador, send_mutex e receive_mutex
+// serializam as threads que usam o mesmo socket.
+struct ReactorChannel {
+    ReactorChannel(int id, size_t capacity)
+        : socket_id(id), outgoing(capacity), incoming(capacity)
+    {
+    }
+
+    const int socket_id;
+
+    SpscRing<ReactorFrame> outgoing;
+
+    SpscRing<ReactorFrame> incoming;
+
+    // Produtores de outgoing (zmq_bridge_reactor_send/publish)
+    std::mutex send_mutex;
+
+    // Consumidores de incoming (zmq_bridge_reactor_receive/peek_size)
+    std::mutex receive_mutex;
+
+    std::atomic<bool> attached{ true };
+
+    // ZMQ_FD do socket, lido em Attach(): a thread de I/O espera por ele
+    // sem o mutex do socket, que pode ser fechado entretanto
+    zmq::fd_t fd = zmq::fd_t();
+
+    // Definidos pelo tipo de socket (ex.: PUB só envia)
+    bool can_send = true;
+
+    bool can_receive = true;
+};
+
+
+// Com o reactor ativo, a thread de I/O faz todos os send/recv dos sockets
+// ligados; o chamador apenas enfileira e desenfileira frames, sem tocar no
+// libzmq nem esperar pela rede.
+class Reactor {
+public:
+    ~Reactor();
+
+    bool Start(int idle_timeout_ms);
+
+    void Stop();
+
+    bool IsRunning() const { return m_running; }
+
+    bool Attach(int socket_id, int queue_capacity);
+
+    bool Detach(int socket_id);
+
+    // Marca um canal já retirado do socket (ex.: socket fechado); a thread
+    // de I/O deixa de o servir e liberta-o
+    void Retire(ReactorChannel& channel);
+
+    // Canal do socket, ou nullptr se não estiver ligado. A referência
+    // mantém o canal válido mesmo depois de Detach() ou Stop().
+    std::shared_ptr<ReactorChannel> Find(int socket_id) const;
+
+private:
+    void Run();
+
+    // Envia o que estiver na fila de saída; devolve true se algo foi feito
+    bool FlushOutgoing(ReactorChannel& channel, SocketState& state);
+
+    // Lê do socket até encher a fila de entrada
+    bool FillIncoming(ReactorChannel& channel, SocketState& state);
+
+    std::thread m_thread;
+
+    std::atomic<bool> m_running{ false };
+
+    int m_idle_timeout_ms = 1;
+
+    // Canais ligados; os desligados são retirados pela thread de I/O. Um
+    // chamador que ainda tenha um canal (Find) mantém-no vivo.
+    std::vector<std::shared_ptr<ReactorChannel>> m_channels;
+
+    std::atomic<unsigned> m_channels_version{ 0 };
+
+    std::mutex m_mutex;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
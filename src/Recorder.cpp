@@ -0,0 +1,945 @@
+#include <zmq.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "ZMQBridge.h"
+#include "BufferPool.h"
+#include "Endian.h"
+#include "Internal.h"
+#include "Recorder.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    static const unsigned char kSegmentMagic[4] = { 'Z', 'B', 'L', '1' };
+
+    static const unsigned char kIndexMagic[4] = { 'Z', 'B', 'I', '1' };
+
+    // Menor segmento aceite por Open
+    static const size_t kMinSegmentSize = 64 * 1024;
+
+    // Os tamanhos e offsets dentro de um segmento são u32
+    static const size_t kMaxSegmentSize = UINT32_MAX;
+
+    // Espera entre tentativas quando o socket recusa uma mensagem reproduzida
+    static const std::chrono::milliseconds kMinSendBackoff(1);
+    static const std::chrono::milliseconds kMaxSendBackoff(50);
+
+    static const int kMaxChannel = 65535;
+
+
+    static int64_t SteadyNowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+
+    static std::string SegmentPath(const std::string& path, uint32_t number)
+    {
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), ".%06u.zbl", number);
+        return path + suffix;
+    }
+
+
+    MappedFile::~MappedFile()
+    {
+        Close(m_size);
+    }
+
+
+#ifdef _WIN32
+
+    bool MappedFile::Create(const std::string& path, size_t size)
+    {
+        Close();
+
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                                  nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            SetLastError("Failed to create log file '" + path + "'");
+            return false;
+        }
+
+        uint64_t size64 = static_cast<uint64_t>(size);
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                            static_cast<DWORD>(size64 >> 32),
+                                            static_cast<DWORD>(size64), nullptr);
+        void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size) : nullptr;
+        if (!data)
+        {
+            if (mapping)
+            {
+                CloseHandle(mapping);
+            }
+
+            CloseHandle(file);
+            SetLastError("Failed to map log file '" + path + "'");
+            return false;
+        }
+
+        m_file = file;
+        m_mapping = mapping;
+        m_data = static_cast<unsigned char*>(data);
+        m_size = size;
+        m_writable = true;
+        return true;
+    }
+
+
+    bool MappedFile::Open(const std::string& path)
+    {
+        Close();
+
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            SetLastError("Failed to open log file '" + path + "'");
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        HANDLE mapping = nullptr;
+        void* data = nullptr;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        }
+
+        if (!data)
+        {
+            if (mapping)
+            {
+                CloseHandle(mapping);
+            }
+
+            CloseHandle(file);
+            SetLastError("Failed to map log file '" + path + "'");
+            return false;
+        }
+
+        m_file = file;
+        m_mapping = mapping;
+        m_data = static_cast<unsigned char*>(data);
+        m_size = static_cast<size_t>(size.QuadPart);
+        m_writable = false;
+        return true;
+    }
+
+
+    void MappedFile::Close(size_t used)
+    {
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+            m_data = nullptr;
+        }
+
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        }
+
+        if (m_file)
+        {
+            if (m_writable)
+            {
+                LARGE_INTEGER position;
+                position.QuadPart = static_cast<LONGLONG>(used);
+                SetFilePointerEx(m_file, position, nullptr, FILE_BEGIN);
+                SetEndOfFile(m_file);
+            }
+
+            CloseHandle(m_file);
+            m_file = nullptr;
+        }
+
+        m_size = 0;
+        m_writable = false;
+    }
+
+#else
+
+    bool MappedFile::Create(const std::string& path, size_t size)
+    {
+        Close();
+
+        int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            SetLastError("Failed to create log file '" + path + "'");
+            return false;
+        }
+
+        void* data = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+        {
+            data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            SetLastError("Failed to map log file '" + path + "'");
+            return false;
+        }
+
+        m_fd = fd;
+        m_data = static_cast<unsigned char*>(data);
+        m_size = size;
+        m_writable = true;
+        return true;
+    }
+
+
+    bool MappedFile::Open(const std::string& path)
+    {
+        Close();
+
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            SetLastError("Failed to open log file '" + path + "'");
+            return false;
+        }
+
+        struct stat info;
+        void* data = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        }
+
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            SetLastError("Failed to map log file '" + path + "'");
+            return false;
+        }
+
+        m_fd = fd;
+        m_data = static_cast<unsigned char*>(data);
+        m_size = static_cast<size_t>(info.st_size);
+        m_writable = false;
+        return true;
+    }
+
+
+    void MappedFile::Close(size_t used)
+    {
+        if (m_data)
+        {
+            munmap(m_data, m_size);
+            m_data = nullptr;
+        }
+
+        if (m_fd >= 0)
+        {
+            // O espaço reservado e não usado não fica no disco
+            if (m_writable && ftruncate(m_fd, static_cast<off_t>(used)) != 0)
+            {
+                SetLastError("Failed to truncate log file");
+            }
+
+            close(m_fd);
+            m_fd = -1;
+        }
+
+        m_size = 0;
+        m_writable = false;
+    }
+
+#endif
+
+
+    Recorder::~Recorder()
+    {
+        Close();
+    }
+
+
+    bool Recorder::Open(const std::string& path, size_t segment_size)
+    {
+        std::lock_guard<std::mutex> sources_lock(m_sources_mutex);
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (segment_size < kMinSegmentSize || segment_size > kMaxSegmentSize)
+        {
+            SetLastError("Log segment size must be between 64 KiB and 4 GiB");
+            return false;
+        }
+
+        m_path = path;
+        m_segment_size = segment_size;
+        m_segment_number = 0;
+        m_start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+        m_steady_start_ns = SteadyNowNs();
+
+        m_messages = 0;
+        m_bytes = 0;
+        m_dropped = 0;
+
+        m_index = std::fopen((path + ".zbi").c_str(), "wb");
+        if (!m_index)
+        {
+            SetLastError("Failed to create log index '" + path + ".zbi'");
+            return false;
+        }
+
+        unsigned char header[kLogIndexHeaderSize] = {};
+        memcpy(header, kIndexMagic, sizeof(kIndexMagic));
+        std::fwrite(header, 1, sizeof(header), m_index);
+
+        if (!OpenSegment())
+        {
+            std::fclose(m_index);
+            m_index = nullptr;
+            return false;
+        }
+
+        return true;
+    }
+
+
+    bool Recorder::OpenSegment()
+    {
+        if (!m_segment.Create(SegmentPath(m_path, m_segment_number), m_segment_size))
+        {
+            return false;
+        }
+
+        unsigned char* header = m_segment.Data();
+        memcpy(header, kSegmentMagic, sizeof(kSegmentMagic));
+        StoreLE(header + 4, m_segment_number, 4);
+        StoreLE(header + 8, static_cast<uint64_t>(m_start_ns), 8);
+
+        m_offset = kLogSegmentHeaderSize;
+        return true;
+    }
+
+
+    void Recorder::CloseSegment()
+    {
+        StoreLE(m_segment.Data() + 16, m_offset, 8);
+        m_segment.Close(m_offset);
+        ++m_segment_number;
+    }
+
+
+    void Recorder::Close()
+    {
+        std::lock_guard<std::mutex> sources_lock(m_sources_mutex);
+
+        // Sem fontes, já ninguém chama Append
+        for (int socket_id : m_taps)
+        {
+            SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+            if (lock && lock.State().recorder == this)
+            {
+                lock.State().recorder = nullptr;
+                lock.State().tap_buffer.clear();
+                lock.State().tap_sizes.clear();
+            }
+        }
+
+        for (const auto& attachment : m_attachments)
+        {
+            Context::Instance().GetDispatcher().Forget(attachment->socket_id);
+        }
+
+        m_taps.clear();
+        m_attachments.clear();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_segment.Data())
+        {
+            CloseSegment();
+        }
+
+        if (m_index)
+        {
+            std::fclose(m_index);
+            m_index = nullptr;
+        }
+    }
+
+
+    bool Recorder::Tap(int socket_id, int channel)
+    {
+        if (channel < 0 || channel > kMaxChannel)
+        {
+            SetLastError("Invalid log channel");
+            return false;
+        }
+
+        std::lock_guard<std::mutex> sources_lock(m_sources_mutex);
+
+        if (!m_index)
+        {
+            SetLastError("Recorder not open");
+            return false;
+        }
+
+        SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+        if (!lock)
+        {
+            return false;
+        }
+
+        if (lock.State().recorder && lock.State().recorder != this)
+        {
+            SetLastError("Socket already tapped by another recorder");
+            return false;
+        }
+
+        // Começa na próxima mensagem completa
+        lock.State().recorder = this;
+        lock.State().recorder_channel = channel;
+        lock.State().tap_buffer.clear();
+        lock.State().tap_sizes.clear();
+
+        if (std::find(m_taps.begin(), m_taps.end(), socket_id) == m_taps.end())
+        {
+            m_taps.push_back(socket_id);
+        }
+
+        return true;
+    }
+
+
+    bool Recorder::Attach(int socket_id, int channel)
+    {
+        if (channel < 0 || channel > kMaxChannel)
+        {
+            SetLastError("Invalid log channel");
+            return false;
+        }
+
+        std::lock_guard<std::mutex> sources_lock(m_sources_mutex);
+
+        if (!m_index)
+        {
+            SetLastError("Recorder not open");
+            return false;
+        }
+
+        auto attachment = std::make_unique<Attachment>();
+        attachment->recorder = this;
+        attachment->socket_id = socket_id;
+        attachment->channel = channel;
+
+        if (!Context::Instance().GetDispatcher().SetCallback(socket_id, &Recorder::OnMessage,
+                                                            attachment.get()))
+        {
+            return false;
+        }
+
+        m_attachments.push_back(std::move(attachment));
+        return true;
+    }
+
+
+    void Recorder::OnMessage(int, const void* data, const int* frame_sizes, int frame_count,
+                             void* user_data)
+    {
+        Attachment* attachment = static_cast<Attachment*>(user_data);
+
+        // Os frames chegam contíguos em data
+        attachment->frames.clear();
+        const unsigned char* in = static_cast<const unsigned char*>(data);
+        for (int i = 0; i < frame_count; ++i)
+        {
+            attachment->frames.push_back({ in, static_cast<size_t>(frame_sizes[i]) });
+            in += frame_sizes[i];
+        }
+
+        attachment->recorder->Append(attachment->channel, attachment->frames.data(),
+                                     attachment->frames.size());
+    }
+
+
+    void Recorder::Append(int channel, const LogFrame* frames, size_t count)
+    {
+        size_t payload = 0;
+        size_t size = kLogRecordHeaderSize;
+        for (size_t i = 0; i < count; ++i)
+        {
+            payload += frames[i].size;
+            size += 4 + frames[i].size;
+        }
+
+        size = (size + 7) & ~size_t(7);
+
+        // Instante tirado com o mutex: o índice fica ordenado
+        std::lock_guard<std::mutex> lock(m_mutex);
+        int64_t timestamp = SteadyNowNs() - m_steady_start_ns;
+
+        if (!m_segment.Data() || count == 0 || count > 0xFFFF
+            || size > m_segment_size - kLogSegmentHeaderSize)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (m_offset + size > m_segment_size)
+        {
+            CloseSegment();
+            if (!OpenSegment())
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        unsigned char* out = m_segment.Data() + m_offset;
+        StoreLE(out + 4, count, 2);
+        StoreLE(out + 6, static_cast<uint64_t>(channel), 2);
+        StoreLE(out + 8, static_cast<uint64_t>(timestamp), 8);
+
+        unsigned char* cursor = out + kLogRecordHeaderSize;
+        for (size_t i = 0; i < count; ++i)
+        {
+            StoreLE(cursor, frames[i].size, 4);
+            if (frames[i].size > 0)
+            {
+                memcpy(cursor + 4, frames[i].data, frames[i].size);
+            }
+
+            cursor += 4 + frames[i].size;
+        }
+
+        memset(cursor, 0, static_cast<size_t>(out + size - cursor));
+
+        // Tamanho por último: um registo incompleto (processo terminado a
+        // meio) termina a leitura do segmento
+        StoreLE(out, size, 4);
+
+        unsigned char entry[kLogIndexEntrySize];
+        StoreLE(entry, static_cast<uint64_t>(timestamp), 8);
+        StoreLE(entry + 8, m_segment_number, 4);
+        StoreLE(entry + 12, m_offset, 4);
+        std::fwrite(entry, 1, sizeof(entry), m_index);
+
+        m_offset += size;
+        m_messages.fetch_add(1, std::memory_order_relaxed);
+        m_bytes.fetch_add(payload, std::memory_order_relaxed);
+    }
+
+
+    void Recorder::GetStats(zmq_bridge_log_stats& stats)
+    {
+        stats.messages = static_cast<long long>(m_messages.load(std::memory_order_relaxed));
+        stats.bytes = static_cast<long long>(m_bytes.load(std::memory_order_relaxed));
+        stats.dropped = static_cast<long long>(m_dropped.load(std::memory_order_relaxed));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stats.segments = m_segment_number + (m_segment.Data() ? 1 : 0);
+    }
+
+
+    Replayer::~Replayer()
+    {
+        Close();
+    }
+
+
+    bool Replayer::Open(const std::string& path)
+    {
+        Close();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (uint32_t number = 0;; ++number)
+        {
+            auto segment = std::make_unique<MappedFile>();
+            if (!segment->Open(SegmentPath(path, number)))
+            {
+                break;
+            }
+
+            if (segment->Size() < kLogSegmentHeaderSize
+                || memcmp(segment->Data(), kSegmentMagic, sizeof(kSegmentMagic)) != 0)
+            {
+                m_segments.clear();
+                SetLastError("Invalid log segment '" + SegmentPath(path, number) + "'");
+                return false;
+            }
+
+            m_segments.push_back(std::move(segment));
+        }
+
+        if (m_segments.empty())
+        {
+            SetLastError("No log segments found at '" + path + "'");
+            return false;
+        }
+
+        // O índice é opcional: sem ele a reprodução começa sempre no início
+        m_index.clear();
+        if (std::FILE* index = std::fopen((path + ".zbi").c_str(), "rb"))
+        {
+            unsigned char header[kLogIndexHeaderSize];
+            unsigned char entry[kLogIndexEntrySize];
+
+            if (std::fread(header, 1, sizeof(header), index) == sizeof(header)
+                && memcmp(header, kIndexMagic, sizeof(kIndexMagic)) == 0)
+            {
+                while (std::fread(entry, 1, sizeof(entry), index) == sizeof(entry))
+                {
+                    IndexEntry value;
+                    value.timestamp_ns = static_cast<int64_t>(LoadLE(entry, 8));
+                    value.segment = static_cast<uint32_t>(LoadLE(entry + 8, 4));
+                    value.offset = static_cast<uint32_t>(LoadLE(entry + 12, 4));
+
+                    if (value.segment < m_segments.size())
+                    {
+                        m_index.push_back(value);
+                    }
+                }
+            }
+
+            std::fclose(index);
+        }
+
+        m_messages = 0;
+        m_bytes = 0;
+        m_dropped = 0;
+        return true;
+    }
+
+
+    void Replayer::Close()
+    {
+        Stop();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_segments.clear();
+        m_index.clear();
+        m_routes.clear();
+    }
+
+
+    bool Replayer::Route(int channel, int socket_id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (IsRunning())
+        {
+            SetLastError("Replayer is running");
+            return false;
+        }
+
+        if (channel < 0 || channel > kMaxChannel)
+        {
+            SetLastError("Invalid log channel");
+            return false;
+        }
+
+        if (socket_id < 0)
+        {
+            m_routes.erase(channel);
+        }
+        else
+        {
+            m_routes[channel] = socket_id;
+        }
+
+        return true;
+    }
+
+
+    bool Replayer::Start(double speed, long long start_ns)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (IsRunning())
+        {
+            SetLastError("Replayer is running");
+            return false;
+        }
+
+        if (m_segments.empty())
+        {
+            SetLastError("Replayer not open");
+            return false;
+        }
+
+        // A reprodução anterior já terminou
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+
+        size_t segment = 0;
+        size_t offset = kLogSegmentHeaderSize;
+
+        if (start_ns > 0 && !m_index.empty())
+        {
+            auto it = std::lower_bound(m_index.begin(), m_index.end(), start_ns,
+                                       [](const IndexEntry& entry, long long value) {
+                                           return entry.timestamp_ns < value;
+                                       });
+
+            segment = it != m_index.end() ? it->segment : m_segments.size();
+            offset = it != m_index.end() ? it->offset : kLogSegmentHeaderSize;
+        }
+
+        m_stop = false;
+        m_running = true;
+
+        try
+        {
+            m_thread = std::thread(&Replayer::Run, this, speed, segment, offset);
+        } catch (const std::system_error& e)
+        {
+            m_running = false;
+            SetLastError("Failed to start replayer thread: " + std::string(e.what()));
+            return false;
+        }
+
+        return true;
+    }
+
+
+    void Replayer::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_wake.notify_all();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+
+        m_running = false;
+    }
+
+
+    bool Replayer::SendFrames(SocketState& state, bool& blocked)
+    {
+        blocked = false;
+
+        for (size_t i = 0; i < m_frames.size(); ++i)
+        {
+            // Cópia: o libzmq pode usar os dados depois de o log ser fechado
+            zmq::message_t frame = BufferPool::Instance().CopyMessage(m_frames[i].data,
+                                                                      m_frames[i].size);
+            zmq::send_flags flags = i + 1 < m_frames.size() ? zmq::send_flags::sndmore
+                                                            : zmq::send_flags::none;
+
+            // Só o primeiro frame pode ser recusado; depois dele os restantes
+            // bloqueiam, para o socket não ficar a meio de uma mensagem
+            if (i == 0)
+            {
+                flags = flags | zmq::send_flags::dontwait;
+            }
+
+            try
+            {
+                if (!state.Send(frame, flags))
+                {
+                    if (i == 0)
+                    {
+                        blocked = true;
+                        return false;
+                    }
+
+                    SetLastError("Replay error: message left incomplete, replay stopped");
+                    m_stop = true;
+                    return false;
+                }
+            } catch (const zmq::error_t& e)
+            {
+                // A meio de uma mensagem o socket já não pode ser usado
+                SetLastError("Replay error: " + std::string(e.what()));
+                if (i > 0)
+                {
+                    m_stop = true;
+                }
+
+                return false;
+            }
+
+            m_bytes.fetch_add(m_frames[i].size, std::memory_order_relaxed);
+        }
+
+        return true;
+    }
+
+
+    bool Replayer::Send(const unsigned char* record, size_t size, int socket_id, bool block)
+    {
+        size_t count = static_cast<size_t>(LoadLE(record + 4, 2));
+        const unsigned char* end = record + size;
+
+        // O registo é validado inteiro antes de enviar o primeiro frame
+        m_frames.clear();
+        const unsigned char* cursor = record + kLogRecordHeaderSize;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (end - cursor < 4)
+            {
+                return false;
+            }
+
+            size_t length = static_cast<size_t>(LoadLE(cursor, 4));
+            if (static_cast<size_t>(end - cursor - 4) < length)
+            {
+                return false;
+            }
+
+            m_frames.push_back({ cursor + 4, length });
+            cursor += 4 + length;
+        }
+
+        if (m_frames.empty())
+        {
+            return false;
+        }
+
+        auto backoff = kMinSendBackoff;
+        while (true)
+        {
+            bool blocked;
+
+            {
+                SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+                if (!lock)
+                {
+                    return false;
+                }
+
+                bool sent = SendFrames(lock.State(), blocked);
+                if (sent || !blocked || !block)
+                {
+                    return sent;
+                }
+            }
+
+            // Sem o lock do socket: outras threads continuam a usá-lo
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_wake.wait_for(lock, backoff, [this] { return m_stop.load(); }))
+            {
+                return false;
+            }
+
+            backoff = std::min(backoff * 2, kMaxSendBackoff);
+        }
+    }
+
+
+    void Replayer::Run(double speed, size_t segment, size_t offset)
+    {
+        SetBackgroundThread("replayer");
+
+        auto start = std::chrono::steady_clock::now();
+        bool timed = speed > 0;
+        bool first = true;
+        int64_t first_timestamp = 0;
+
+        for (; segment < m_segments.size() && !m_stop; ++segment, offset = kLogSegmentHeaderSize)
+        {
+            const unsigned char* data = m_segments[segment]->Data();
+            size_t limit = m_segments[segment]->Size();
+
+            // Sem o tamanho usado (gravação interrompida), lê até um registo vazio
+            size_t used = static_cast<size_t>(LoadLE(data + 16, 8));
+            if (used >= kLogSegmentHeaderSize && used < limit)
+            {
+                limit = used;
+            }
+
+            while (offset + kLogRecordHeaderSize <= limit && !m_stop)
+            {
+                const unsigned char* record = data + offset;
+                size_t size = static_cast<size_t>(LoadLE(record, 4));
+                if (size < kLogRecordHeaderSize || size > limit - offset)
+                {
+                    break;
+                }
+
+                int64_t timestamp = static_cast<int64_t>(LoadLE(record + 8, 8));
+                if (first)
+                {
+                    first_timestamp = timestamp;
+                    first = false;
+                }
+
+                if (timed)
+                {
+                    auto delay = std::chrono::nanoseconds(
+                        static_cast<int64_t>((timestamp - first_timestamp) / speed));
+
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    if (m_wake.wait_until(lock, start + delay, [this] { return m_stop.load(); }))
+                    {
+                        break;
+                    }
+                }
+
+                auto route = m_routes.find(static_cast<int>(LoadLE(record + 6, 2)));
+                if (route != m_routes.end())
+                {
+                    // Sem ritmo (speed <= 0) a reprodução espera pelo
+                    // socket: descartar mensagens tornaria o resultado
+                    // dependente da velocidade do recetor
+                    if (Send(record, size, route->second, !timed))
+                    {
+                        m_messages.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+
+                offset += size;
+            }
+        }
+
+        m_running.store(false, std::memory_order_release);
+    }
+
+
+    void Replayer::GetStats(zmq_bridge_log_stats& stats)
+    {
+        stats.messages = static_cast<long long>(m_messages.load(std::memory_order_relaxed));
+        stats.bytes = static_cast<long long>(m_bytes.load(std::memory_order_relaxed));
+        stats.dropped = static_cast<long long>(m_dropped.load(std::memory_order_relaxed));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stats.segments = static_cast<long long>(m_segments.size());
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
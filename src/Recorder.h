@@ -0,0 +1,237 @@
+// Recorder.h - Gravação de mensagens num log segmentado mapeado em memória,
+// e reprodução a partir desse log
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ZMQBridge.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Layout do log (little-endian). Segmentos <path>.NNNNNN.zbl:
+//   cabeçalho (64 bytes): "ZBL1", u32 número do segmento, i64 início da
+//     gravação (ns desde a epoch), u64 bytes usados (0 se a gravação não
+//     terminou: o leitor percorre os registos até um tamanho 0)
+//   registos a partir do byte 64, alinhados a 8 bytes: u32 tamanho do
+//     registo (com cabeçalho e padding), u16 número de frames, u16 canal,
+//     i64 instante (ns desde o início da gravação), e cada frame como u32
+//     tamanho seguido dos dados
+// Índice <path>.zbi: "ZBI1", u32 reservado, e por registo i64 instante,
+// u32 segmento, u32 posição no segmento.
+constexpr size_t kLogSegmentHeaderSize = 64;
+constexpr size_t kLogRecordHeaderSize = 16;
+constexpr size_t kLogIndexHeaderSize = 8;
+constexpr size_t kLogIndexEntrySize = 16;
+
+
+// Ficheiro mapeado em memória: criado com tamanho fixo para escrita, ou
+// aberto inteiro só para leitura
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Create(const std::string& path, size_t size);
+
+    bool Open(const std::string& path);
+
+    // Desmapeia; um ficheiro criado é truncado para used bytes
+    void Close(size_t used = 0);
+
+    unsigned char* Data() const { return m_data; }
+
+    size_t Size() const { return m_size; }
+
+private:
+    unsigned char* m_data = nullptr;
+
+    size_t m_size = 0;
+
+    bool m_writable = false;
+
+#ifdef _WIN32
+    void* m_file = nullptr;
+
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
+
+// Frame de uma mensagem a gravar
+struct LogFrame
+{
+    const void* data;
+
+    size_t size;
+};
+
+
+// Grava mensagens completas no log. As mensagens chegam de duas formas:
+// Tap() grava o que é enviado por um socket, na thread que envia, e
+// Attach() entrega a um callback do Dispatcher o que um socket recebe.
+// Cada registo é copiado diretamente para o segmento mapeado; quando não
+// cabe, o segmento é truncado para o tamanho usado e abre-se o seguinte.
+class Recorder {
+public:
+    ~Recorder();
+
+    bool Open(const std::string& path, size_t segment_size);
+
+    // Retira as fontes e fecha o log
+    void Close();
+
+    bool Tap(int socket_id, int channel);
+
+    bool Attach(int socket_id, int channel);
+
+    // Grava uma mensagem; chamado com o mutex do socket de origem (Tap) ou
+    // na thread do dispatcher (Attach)
+    void Append(int channel, const LogFrame* frames, size_t count);
+
+    void GetStats(zmq_bridge_log_stats& stats);
+
+private:
+    struct Attachment
+    {
+        Recorder* recorder;
+
+        int socket_id;
+
+        int channel;
+
+        std::vector<LogFrame> frames;
+    };
+
+    static void OnMessage(int socket_id, const void* data, const int* frame_sizes,
+                          int frame_count, void* user_data);
+
+    // Chamar com m_mutex
+    bool OpenSegment();
+
+    void CloseSegment();
+
+    std::string m_path;
+
+    size_t m_segment_size = 0;
+
+    MappedFile m_segment;
+
+    uint32_t m_segment_number = 0;
+
+    size_t m_offset = 0;
+
+    std::FILE* m_index = nullptr;
+
+    // Início da gravação: ns desde a epoch (para o cabeçalho) e no steady
+    // clock (para os instantes dos registos)
+    int64_t m_start_ns = 0;
+
+    int64_t m_steady_start_ns = 0;
+
+    std::vector<int> m_taps;
+
+    std::vector<std::unique_ptr<Attachment>> m_attachments;
+
+    std::atomic<uint64_t> m_messages{ 0 };
+
+    std::atomic<uint64_t> m_bytes{ 0 };
+
+    std::atomic<uint64_t> m_dropped{ 0 };
+
+    // Serializa Open/Close e as fontes
+    std::mutex m_sources_mutex;
+
+    // Protege o segmento e o índice
+    std::mutex m_mutex;
+};
+
+
+// Reproduz um log numa thread própria, enviando cada canal para o socket
+// indicado em Route(). speed 1 respeita os intervalos originais, 2 é duas
+// vezes mais rápido e <= 0 envia tão depressa quanto possível. A ordem dos
+// registos é sempre a da gravação.
+class Replayer {
+public:
+    ~Replayer();
+
+    bool Open(const std::string& path);
+
+    void Close();
+
+    // socket_id < 0 remove o canal; só com a reprodução parada
+    bool Route(int channel, int socket_id);
+
+    // Começa no primeiro registo com instante >= start_ns (pelo índice)
+    bool Start(double speed, long long start_ns);
+
+    void Stop();
+
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    void GetStats(zmq_bridge_log_stats& stats);
+
+private:
+    struct IndexEntry
+    {
+        int64_t timestamp_ns;
+
+        uint32_t segment;
+
+        uint32_t offset;
+    };
+
+    void Run(double speed, size_t segment, size_t offset);
+
+    // Envia um registo; false se o socket o recusou ou o registo for
+    // inválido. Com block, espera (com backoff) que o socket aceite o
+    // primeiro frame em vez de o descartar
+    bool Send(const unsigned char* record, size_t size, int socket_id, bool block);
+
+    // Envia m_frames; blocked fica true se o socket recusou o primeiro frame
+    bool SendFrames(SocketState& state, bool& blocked);
+
+    std::vector<std::unique_ptr<MappedFile>> m_segments;
+
+    std::vector<IndexEntry> m_index;
+
+    // Frames do registo em envio (só a thread de reprodução)
+    std::vector<LogFrame> m_frames;
+
+    std::unordered_map<int, int> m_routes;
+
+    std::thread m_thread;
+
+    std::atomic<bool> m_running{ false };
+
+    std::atomic<bool> m_stop{ false };
+
+    std::condition_variable m_wake;
+
+    std::mutex m_mutex;
+
+    std::atomic<uint64_t> m_messages{ 0 };
+
+    std::atomic<uint64_t> m_bytes{ 0 };
+
+    std::atomic<uint64_t> m_dropped{ 0 };
+};
+
+} // namespace internal
+} // namespace zmq_bridge
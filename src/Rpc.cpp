@@ -0,0 +1,312 @@
+#include <zmq.hpp>
+#include <cstring>
+#include "ZMQBridge.h"
+#include "BufferPool.h"
+#include "Endian.h"
+#include "Internal.h"
+#include "Rpc.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    static const unsigned char kRequestMagic[4] = { 'Z', 'B', 'Q', '1' };
+
+    static const unsigned char kReplyMagic[4] = { 'Z', 'B', 'P', '1' };
+
+
+    // Cabeçalho de pedidos e respostas: magic, u32 timeout_ms, u64 ID
+    static zmq::message_t MakeHeader(const unsigned char* magic, uint32_t timeout_ms,
+                                     uint64_t request_id)
+    {
+        zmq::message_t header(ZMQ_BRIDGE_RPC_HEADER_SIZE);
+        unsigned char* out = static_cast<unsigned char*>(header.data());
+        memcpy(out, magic, 4);
+        StoreLE(out + 4, timeout_ms, 4);
+        StoreLE(out + 8, request_id, 8);
+        return header;
+    }
+
+
+    static bool ParseHeader(const zmq::message_t& header, const unsigned char* magic,
+                            uint32_t& timeout_ms, uint64_t& request_id)
+    {
+        if (header.size() != ZMQ_BRIDGE_RPC_HEADER_SIZE || memcmp(header.data(), magic, 4) != 0)
+        {
+            return false;
+        }
+
+        const unsigned char* in = static_cast<const unsigned char*>(header.data());
+        timeout_ms = static_cast<uint32_t>(LoadLE(in + 4, 4));
+        request_id = LoadLE(in + 8, 8);
+        return true;
+    }
+
+
+    // Devolve os frames aos pendentes, pela ordem original
+    static void UnreadFrames(SocketState& state, std::vector<zmq::message_t>& frames)
+    {
+        while (!frames.empty())
+        {
+            state.Unread(std::move(frames.back()));
+            frames.pop_back();
+        }
+    }
+
+
+    // Lê todos os frames da próxima mensagem; false se não houver mensagem.
+    // Em caso de erro, os frames já lidos voltam aos pendentes.
+    static bool ReceiveFrames(SocketState& state, std::vector<zmq::message_t>& frames)
+    {
+        frames.clear();
+
+        try
+        {
+            zmq::message_t message;
+            if (!state.Receive(message, zmq::recv_flags::dontwait))
+            {
+                return false;
+            }
+
+            // Os restantes frames da mensagem já chegaram
+            bool more = message.more();
+            frames.push_back(std::move(message));
+
+            while (more)
+            {
+                zmq::message_t next;
+                if (!state.Receive(next, zmq::recv_flags::dontwait))
+                {
+                    break;
+                }
+
+                more = next.more();
+                frames.push_back(std::move(next));
+            }
+        } catch (const zmq::error_t&)
+        {
+            UnreadFrames(state, frames);
+            throw;
+        }
+
+        return true;
+    }
+
+
+    int RpcClient::Request(SocketState& state, const void* data, size_t size, int timeout_ms,
+                           uint64_t& request_id)
+    {
+        if (m_pending.size() >= kMaxPending)
+        {
+            SetLastError("Too many pending RPC requests");
+            return ZMQ_BRIDGE_ERROR_QUEUE_FULL;
+        }
+
+        uint64_t id = m_next_id;
+        uint32_t timeout = timeout_ms > 0 ? static_cast<uint32_t>(timeout_ms) : 0;
+
+        // Sem servidor ligado o DEALER bloquearia; o pedido é recusado
+        zmq::message_t header = MakeHeader(kRequestMagic, timeout, id);
+        if (!state.Send(header, zmq::send_flags::sndmore | zmq::send_flags::dontwait))
+        {
+            SetLastError("RPC request would block (no server connected or queue full)");
+            return ZMQ_BRIDGE_ERROR_SEND;
+        }
+
+        // Os restantes frames de uma mensagem aceite nunca bloqueiam
+        zmq::message_t body = BufferPool::Instance().CopyMessage(data, size);
+        if (!state.Send(body, zmq::send_flags::dontwait))
+        {
+            SetLastError("Failed to send RPC request");
+            return ZMQ_BRIDGE_ERROR_SEND;
+        }
+
+        ++m_next_id;
+        m_pending.insert(id);
+
+        if (timeout > 0)
+        {
+            m_deadlines.emplace(RpcClock::now() + std::chrono::milliseconds(timeout), id);
+        }
+
+        request_id = id;
+        return ZMQ_BRIDGE_OK;
+    }
+
+
+    bool RpcClient::Cancel(uint64_t request_id)
+    {
+        // O prazo, se existir, fica na fila e é ignorado quando chegar ao topo
+        if (m_pending.erase(request_id) == 0)
+        {
+            SetLastError("RPC request not pending");
+            return false;
+        }
+
+        return true;
+    }
+
+
+    int RpcClient::Receive(SocketState& state, uint64_t& request_id, void* buffer,
+                           size_t capacity, size_t& size)
+    {
+        size = 0;
+
+        // Prazos expirados primeiro: uma resposta que chegue depois é descartada
+        auto now = RpcClock::now();
+        while (!m_deadlines.empty() && m_deadlines.top().first <= now)
+        {
+            uint64_t id = m_deadlines.top().second;
+            m_deadlines.pop();
+
+            if (m_pending.erase(id) > 0)
+            {
+                request_id = id;
+                SetLastError("RPC request timed out");
+                return ZMQ_BRIDGE_ERROR_TIMEOUT;
+            }
+        }
+
+        std::vector<zmq::message_t> frames;
+        while (ReceiveFrames(state, frames))
+        {
+            uint32_t timeout_ms;
+            uint64_t id;
+
+            // Mensagens que não são respostas, ou respostas a pedidos que
+            // expiraram, são descartadas
+            if (frames.size() != 2 || !ParseHeader(frames[0], kReplyMagic, timeout_ms, id)
+                || m_pending.count(id) == 0)
+            {
+                continue;
+            }
+
+            size = frames[1].size();
+            if (size > capacity)
+            {
+                UnreadFrames(state, frames);
+                SetLastError("Buffer too small for message");
+                return ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL;
+            }
+
+            if (size > 0)
+            {
+                memcpy(buffer, frames[1].data(), size);
+            }
+
+            m_pending.erase(id);
+            request_id = id;
+            return ZMQ_BRIDGE_OK;
+        }
+
+        return ZMQ_BRIDGE_NO_MESSAGE;
+    }
+
+
+    void RpcServer::Expire(RpcClock::time_point now)
+    {
+        while (!m_deadlines.empty() && m_deadlines.top().first <= now)
+        {
+            m_pending.erase(m_deadlines.top().second);
+            m_deadlines.pop();
+        }
+    }
+
+
+    int RpcServer::Receive(SocketState& state, uint64_t& handle, void* buffer,
+                           size_t capacity, size_t& size)
+    {
+        size = 0;
+
+        auto now = RpcClock::now();
+        Expire(now);
+
+        if (m_pending.size() >= kMaxPending)
+        {
+            SetLastError("Too many unanswered RPC requests");
+            return ZMQ_BRIDGE_ERROR_QUEUE_FULL;
+        }
+
+        std::vector<zmq::message_t> frames;
+        while (ReceiveFrames(state, frames))
+        {
+            uint32_t timeout_ms;
+            uint64_t request_id;
+
+            // [identidade][cabeçalho][dados]; outras mensagens são descartadas
+            if (frames.size() != 3 || !ParseHeader(frames[1], kRequestMagic, timeout_ms, request_id))
+            {
+                continue;
+            }
+
+            size = frames[2].size();
+            if (size > capacity)
+            {
+                UnreadFrames(state, frames);
+                SetLastError("Buffer too small for message");
+                return ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL;
+            }
+
+            if (size > 0)
+            {
+                memcpy(buffer, frames[2].data(), size);
+            }
+
+            handle = m_next_handle++;
+
+            Request& request = m_pending[handle];
+            request.identity = std::move(frames[0]);
+            request.request_id = request_id;
+
+            // O prazo conta a partir da receção: os relógios dos dois
+            // processos não são comparáveis
+            if (timeout_ms > 0)
+            {
+                m_deadlines.emplace(now + std::chrono::milliseconds(timeout_ms), handle);
+            }
+
+            return ZMQ_BRIDGE_OK;
+        }
+
+        return ZMQ_BRIDGE_NO_MESSAGE;
+    }
+
+
+    int RpcServer::Reply(SocketState& state, uint64_t handle, const void* data, size_t size)
+    {
+        Expire(RpcClock::now());
+
+        auto it = m_pending.find(handle);
+        if (it == m_pending.end())
+        {
+            if (handle == 0 || handle >= m_next_handle)
+            {
+                SetLastError("Invalid RPC request handle");
+                return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+            }
+
+            SetLastError("RPC request already answered or expired");
+            return ZMQ_BRIDGE_ERROR_TIMEOUT;
+        }
+
+        Request request = std::move(it->second);
+        m_pending.erase(it);
+
+        // O ROUTER nunca bloqueia: sem espaço ou com o cliente desligado, a
+        // resposta é descartada pelo libzmq
+        zmq::message_t header = MakeHeader(kReplyMagic, 0, request.request_id);
+        zmq::message_t body = BufferPool::Instance().CopyMessage(data, size);
+
+        if (!state.Send(request.identity, zmq::send_flags::sndmore)
+            || !state.Send(header, zmq::send_flags::sndmore)
+            || !state.Send(body, zmq::send_flags::none))
+        {
+            SetLastError("Failed to send RPC reply");
+            return ZMQ_BRIDGE_ERROR_SEND;
+        }
+
+        return ZMQ_BRIDGE_OK;
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,100 @@
+// Rpc.h - Pedidos assíncronos com IDs de correlação sobre DEALER/ROUTER
+#pragma once
+
+#include <zmq.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace zmq_bridge {
+namespace internal {
+
+
+struct SocketState;
+
+
+// Prazos por ordem crescente; as entradas de pedidos já concluídos ficam
+// até chegarem ao topo e são então ignoradas
+using RpcClock = std::chrono::steady_clock;
+
+using RpcDeadlines =
+    std::priority_queue<std::pair<RpcClock::time_point, uint64_t>,
+                        std::vector<std::pair<RpcClock::time_point, uint64_t>>,
+                        std::greater<std::pair<RpcClock::time_point, uint64_t>>>;
+
+
+// Lado do cliente (socket DEALER): cada pedido recebe um ID e, com
+// timeout_ms > 0, um prazo. As respostas podem chegar por qualquer ordem;
+// as de pedidos expirados são descartadas. Todos os métodos são chamados
+// com o mutex do socket.
+class RpcClient {
+public:
+    static constexpr size_t kMaxPending = 65536;
+
+    // Envia [cabeçalho][dados] sem bloquear; lança zmq::error_t
+    int Request(SocketState& state, const void* data, size_t size, int timeout_ms,
+                uint64_t& request_id);
+
+    // ZMQ_BRIDGE_OK com a próxima resposta, ZMQ_BRIDGE_ERROR_TIMEOUT com
+    // um pedido expirado (indicado uma só vez) ou ZMQ_BRIDGE_NO_MESSAGE.
+    // Com ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL a resposta fica pendente e
+    // size recebe o seu tamanho. Lança zmq::error_t.
+    int Receive(SocketState& state, uint64_t& request_id, void* buffer, size_t capacity,
+                size_t& size);
+
+    // Esquece um pedido em curso (ex.: sem timeout e sem resposta); uma
+    // resposta que ainda chegue é descartada. false se não estiver pendente
+    bool Cancel(uint64_t request_id);
+
+private:
+    uint64_t m_next_id = 1;
+
+    // Pedidos à espera de resposta
+    std::unordered_set<uint64_t> m_pending;
+
+    RpcDeadlines m_deadlines;
+};
+
+
+// Lado do servidor (socket ROUTER): cada pedido recebido fica guardado
+// (identidade do cliente e ID de correlação) sob um handle, para ser
+// respondido mais tarde e por qualquer ordem. Um pedido cujo prazo passou
+// deixa de poder ser respondido: o cliente já desistiu dele.
+class RpcServer {
+public:
+    static constexpr size_t kMaxPending = 65536;
+
+    // Como RpcClient::Receive, mas sem ZMQ_BRIDGE_ERROR_TIMEOUT; devolve
+    // ZMQ_BRIDGE_ERROR_QUEUE_FULL se houver kMaxPending pedidos por responder
+    int Receive(SocketState& state, uint64_t& handle, void* buffer, size_t capacity,
+                size_t& size);
+
+    // Envia [identidade][cabeçalho][dados]; lança zmq::error_t
+    int Reply(SocketState& state, uint64_t handle, const void* data, size_t size);
+
+private:
+    struct Request
+    {
+        zmq::message_t identity;
+
+        uint64_t request_id = 0;
+    };
+
+    // Esquece os pedidos cujo prazo já passou
+    void Expire(RpcClock::time_point now);
+
+    uint64_t m_next_handle = 1;
+
+    std::unordered_map<uint64_t, Request> m_pending;
+
+    RpcDeadlines m_deadlines;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,326 @@
+#include <zmq.hpp>
+#include <cmath>
+#include "ZMQBridge.h"
+#include "BufferPool.h"
+#include "Internal.h"
+#include "Scheduler.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    static const double kMaxRateHz = 10000.0;
+
+
+    Scheduler::~Scheduler()
+    {
+        Stop();
+    }
+
+
+    bool Scheduler::Start(int socket_id)
+    {
+        Stop();
+
+        {
+            std::lock_guard<std::mutex> lock(m_topics_mutex);
+            m_topics.clear();
+            m_topic_list.clear();
+        }
+
+        m_socket_id = socket_id;
+        m_base = Clock::now();
+        m_signaled = false;
+        m_running = true;
+
+        try
+        {
+            m_thread = std::thread(&Scheduler::Run, this);
+        } catch (const std::system_error& e)
+        {
+            m_running = false;
+            SetLastError("Failed to start scheduler thread: " + std::string(e.what()));
+            return false;
+        }
+
+#ifdef _WIN32
+        // Resolução de 1 ms para os timeouts da thread enquanto existir
+        timeBeginPeriod(1);
+#endif
+        return true;
+    }
+
+
+    void Scheduler::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+            m_running = false;
+        }
+
+        m_wake.notify_one();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+#ifdef _WIN32
+            timeEndPeriod(1);
+#endif
+        }
+    }
+
+
+    std::shared_ptr<ScheduledTopic> Scheduler::FindTopic(const std::string& topic)
+    {
+        std::lock_guard<std::mutex> lock(m_topics_mutex);
+
+        auto it = m_topics.find(topic);
+        return it != m_topics.end() ? it->second : nullptr;
+    }
+
+
+    bool Scheduler::AddTopic(const std::string& topic, double rate_hz, int flags)
+    {
+        if (!m_running)
+        {
+            SetLastError("Invalid scheduler ID");
+            return false;
+        }
+
+        if (!(rate_hz > 0.0) || rate_hz > kMaxRateHz)
+        {
+            SetLastError("Schedule rate must be between 0 and 10000 Hz");
+            return false;
+        }
+
+        int64_t period_ns = static_cast<int64_t>(std::llround(1e9 / rate_hz));
+
+        {
+            std::lock_guard<std::mutex> lock(m_topics_mutex);
+
+            std::shared_ptr<ScheduledTopic>& entry = m_topics[topic];
+            if (!entry)
+            {
+                entry = std::make_shared<ScheduledTopic>(topic);
+                m_topic_list.push_back(entry);
+            }
+
+            entry->flags = flags;
+            entry->requested_period_ns = period_ns;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+            m_signaled = true;
+        }
+
+        m_wake.notify_one();
+        return true;
+    }
+
+
+    int Scheduler::Publish(const std::string& topic, const void* data, size_t size)
+    {
+        std::shared_ptr<ScheduledTopic> entry = FindTopic(topic);
+        if (!entry)
+        {
+            SetLastError("Topic '" + topic + "' has no schedule");
+            return ZMQ_BRIDGE_ERROR_TOPIC;
+        }
+
+        std::lock_guard<std::mutex> lock(entry->write_mutex);
+
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        entry->frames.Back().assign(bytes, bytes + size);
+
+        ++entry->published;
+        if (entry->frames.Publish())
+        {
+            ++entry->coalesced;
+        }
+
+        // A thread não é acordada: o frame sai no próximo tick do tópico
+        return ZMQ_BRIDGE_OK;
+    }
+
+
+    bool Scheduler::GetStats(const std::string& topic, zmq_bridge_schedule_stats& stats)
+    {
+        std::shared_ptr<ScheduledTopic> entry = FindTopic(topic);
+        if (!entry)
+        {
+            SetLastError("Topic '" + topic + "' has no schedule");
+            return false;
+        }
+
+        stats.published = static_cast<long long>(entry->published.load());
+        stats.sent = static_cast<long long>(entry->sent.load());
+        stats.coalesced = static_cast<long long>(entry->coalesced.load());
+        stats.idle_ticks = static_cast<long long>(entry->idle_ticks.load());
+        stats.missed_ticks = static_cast<long long>(entry->missed_ticks.load());
+        stats.dropped = static_cast<long long>(entry->dropped.load());
+        entry->jitter.Snapshot(stats.jitter);
+        return true;
+    }
+
+
+    // Envia [tópico][dados] sem bloquear; Front() fica intacto para
+    // ZMQ_BRIDGE_SCHEDULE_REPEAT
+    static bool SendFront(ScheduledTopic& topic, SocketState& state)
+    {
+        const std::vector<unsigned char>& frame = topic.frames.Front();
+
+        try
+        {
+            zmq::message_t topic_msg(topic.topic.data(), topic.topic.size());
+            if (!state.Send(topic_msg, zmq::send_flags::sndmore | zmq::send_flags::dontwait))
+            {
+                return false;
+            }
+
+            zmq::message_t data_msg = BufferPool::Instance().CopyMessage(frame.data(), frame.size());
+            return state.Send(data_msg, zmq::send_flags::dontwait).has_value();
+        } catch (const zmq::error_t& e)
+        {
+            SetLastError("Scheduled publish error: " + std::string(e.what()));
+            return false;
+        }
+    }
+
+
+    void Scheduler::Tick(ScheduledTopic& topic, Clock::time_point now, SocketLock& lock)
+    {
+        int64_t elapsed =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_base).count();
+
+        topic.jitter.Record(static_cast<uint64_t>(elapsed - topic.tick * topic.period_ns));
+
+        bool send = topic.frames.Update();
+        if (send)
+        {
+            topic.has_frame = true;
+        }
+        else if (topic.has_frame
+                 && (topic.flags.load(std::memory_order_relaxed) & ZMQ_BRIDGE_SCHEDULE_REPEAT))
+        {
+            send = true;
+        }
+
+        if (!send)
+        {
+            ++topic.idle_ticks;
+        }
+        else if (lock && SendFront(topic, lock.State()))
+        {
+            ++topic.sent;
+        }
+        else
+        {
+            ++topic.dropped;
+        }
+
+        // Próximo tick na grelha; os que já passaram não são enviados em rajada
+        int64_t next = elapsed / topic.period_ns + 1;
+        if (next > topic.tick + 1)
+        {
+            topic.missed_ticks += static_cast<uint64_t>(next - topic.tick - 1);
+        }
+
+        topic.tick = next;
+    }
+
+
+    void Scheduler::Run()
+    {
+        SetBackgroundThread("scheduler");
+
+        std::vector<std::shared_ptr<ScheduledTopic>> topics;
+        bool refresh = true;
+
+        while (true)
+        {
+            if (refresh)
+            {
+                std::lock_guard<std::mutex> lock(m_topics_mutex);
+                topics = m_topic_list;
+            }
+
+            // Tópicos novos, ou com outro ritmo, entram no próximo tick da
+            // sua grelha a partir de m_base
+            Clock::time_point now = Clock::now();
+            int64_t elapsed =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_base).count();
+
+            Clock::time_point next = Clock::time_point::max();
+            for (const auto& topic : topics)
+            {
+                int64_t period = topic->requested_period_ns.load();
+                if (period != topic->period_ns)
+                {
+                    topic->period_ns = period;
+                    topic->tick = elapsed / period + 1;
+                }
+
+                Clock::time_point deadline =
+                    m_base + std::chrono::nanoseconds(topic->tick * topic->period_ns);
+                if (deadline < next)
+                {
+                    next = deadline;
+                }
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(m_wake_mutex);
+                auto wake = [this] { return m_signaled || !m_running; };
+
+                if (topics.empty())
+                {
+                    m_wake.wait(lock, wake);
+                }
+                else
+                {
+                    m_wake.wait_until(lock, next, wake);
+                }
+
+                if (!m_running)
+                {
+                    break;
+                }
+
+                refresh = m_signaled;
+                m_signaled = false;
+            }
+
+            now = Clock::now();
+            if (now < next)
+            {
+                continue;
+            }
+
+            // Um frame que o socket não aceite (HWM, socket fechado) conta
+            // em dropped; o tick seguinte traz o mais recente
+            SocketLock lock = Context::Instance().GetSocketManager().Acquire(m_socket_id);
+
+            for (const auto& topic : topics)
+            {
+                if (m_base + std::chrono::nanoseconds(topic->tick * topic->period_ns) <= now)
+                {
+                    Tick(*topic, now, lock);
+                }
+            }
+        }
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
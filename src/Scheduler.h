@@ -0,0 +1,134 @@
+// Scheduler.h - Publicação a ritmo fixo, por tópico, com prazos absolutos
+#pragma once
+
+#include <zmq.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ZMQBridge.h"
+#include "Histogram.h"
+#include "TripleBuffer.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+struct SocketState;
+
+class SocketLock;
+
+
+// Tópico com ritmo fixo: o último frame publicado (como em LatestTopic) e
+// o estado dos seus ticks
+struct ScheduledTopic {
+    explicit ScheduledTopic(const std::string& name) : topic(name) {}
+
+    const std::string topic;
+
+    // Serializa produtores do mesmo tópico (o TripleBuffer só admite um)
+    std::mutex write_mutex;
+
+    TripleBuffer<std::vector<unsigned char>> frames;
+
+    // Período pedido e flags (ZMQ_BRIDGE_SCHEDULE_*); podem mudar com o
+    // tópico já registado
+    std::atomic<int64_t> requested_period_ns{ 0 };
+
+    std::atomic<int> flags{ 0 };
+
+    // Só a thread do scheduler: período em uso, número do próximo tick e
+    // se Front() já tem um frame
+    int64_t period_ns = 0;
+
+    int64_t tick = 0;
+
+    bool has_frame = false;
+
+    std::atomic<uint64_t> published{ 0 };
+
+    std::atomic<uint64_t> sent{ 0 };
+
+    std::atomic<uint64_t> coalesced{ 0 };
+
+    std::atomic<uint64_t> idle_ticks{ 0 };
+
+    std::atomic<uint64_t> missed_ticks{ 0 };
+
+    std::atomic<uint64_t> dropped{ 0 };
+
+    // Atraso de cada tick em relação ao seu prazo
+    Histogram jitter;
+};
+
+
+// Envia, para um socket existente, cada tópico registado ao seu ritmo. Os
+// prazos são absolutos (base + tick * período), por isso o tempo de envio
+// não se acumula em deriva, e partem todos da mesma base: um tópico a 10 Hz
+// sai nos mesmos instantes que um em cada 20 ticks de outro a 200 Hz.
+// Publish() só substitui o último frame do tópico; se o produtor for mais
+// rápido do que o ritmo, os frames intermédios contam em coalesced. Um tick
+// atrasado mais de um período não é recuperado em rajada: os ticks
+// perdidos contam em missed_ticks e o tópico volta à grelha.
+class Scheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Scheduler() = default;
+
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    bool Start(int socket_id);
+
+    void Stop();
+
+    // Regista o tópico, ou muda o ritmo de um já registado
+    bool AddTopic(const std::string& topic, double rate_hz, int flags);
+
+    // ZMQ_BRIDGE_ERROR_TOPIC se o tópico não estiver registado
+    int Publish(const std::string& topic, const void* data, size_t size);
+
+    bool GetStats(const std::string& topic, zmq_bridge_schedule_stats& stats);
+
+private:
+    void Run();
+
+    std::shared_ptr<ScheduledTopic> FindTopic(const std::string& topic);
+
+    // Processa um tick vencido do tópico
+    void Tick(ScheduledTopic& topic, Clock::time_point now, SocketLock& lock);
+
+    int m_socket_id = -1;
+
+    // Origem comum dos prazos de todos os tópicos
+    Clock::time_point m_base;
+
+    std::thread m_thread;
+
+    std::atomic<bool> m_running{ false };
+
+    // Protege m_topics e m_topic_list
+    std::mutex m_topics_mutex;
+
+    std::unordered_map<std::string, std::shared_ptr<ScheduledTopic>> m_topics;
+
+    std::vector<std::shared_ptr<ScheduledTopic>> m_topic_list;
+
+    // Acorda a thread quando um tópico é registado ou o ritmo muda
+    std::mutex m_wake_mutex;
+
+    std::condition_variable m_wake;
+
+    bool m_signaled = false;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,534 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include "ZMQBridge.h"
+#include "Internal.h"
+#include "Schema.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    static const unsigned char kRecordMagic[2] = { 'Z', 'R' };
+
+    // Limite de campos por esquema
+    static const size_t kMaxFields = 256;
+
+
+    static bool ParseFieldType(const std::string& name, FieldType& type)
+    {
+        static const struct
+        {
+            const char* name;
+            FieldType type;
+        } kTypes[] = {
+            { "u8", FieldType::U8 },   { "i8", FieldType::I8 },
+            { "u16", FieldType::U16 }, { "i16", FieldType::I16 },
+            { "u32", FieldType::U32 }, { "i32", FieldType::I32 },
+            { "u64", FieldType::U64 }, { "i64", FieldType::I64 },
+            { "f32", FieldType::F32 }, { "f64", FieldType::F64 },
+        };
+
+        for (const auto& entry : kTypes)
+        {
+            if (name == entry.name)
+            {
+                type = entry.type;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    static uint32_t FieldSize(FieldType type)
+    {
+        switch (type)
+        {
+        case FieldType::U8:
+        case FieldType::I8: return 1;
+        case FieldType::U16:
+        case FieldType::I16: return 2;
+        case FieldType::U32:
+        case FieldType::I32:
+        case FieldType::F32: return 4;
+        default: return 8;
+        }
+    }
+
+
+    static std::string Trim(const std::string& text)
+    {
+        size_t begin = text.find_first_not_of(" \t");
+        if (begin == std::string::npos)
+        {
+            return std::string();
+        }
+
+        size_t end = text.find_last_not_of(" \t");
+        return text.substr(begin, end - begin + 1);
+    }
+
+
+    static bool ParseLayout(const std::string& layout, Schema& schema)
+    {
+        schema.layout = layout;
+        schema.fields.clear();
+        schema.payload_size = 0;
+
+        size_t start = 0;
+        while (start <= layout.size())
+        {
+            size_t end = layout.find(',', start);
+            if (end == std::string::npos)
+            {
+                end = layout.size();
+            }
+
+            std::string field = layout.substr(start, end - start);
+            size_t colon = field.find(':');
+            if (colon == std::string::npos)
+            {
+                SetLastError("Invalid schema field: '" + Trim(field) + "'");
+                return false;
+            }
+
+            SchemaField entry;
+            entry.name = Trim(field.substr(0, colon));
+            std::string type = Trim(field.substr(colon + 1));
+
+            if (entry.name.empty() || !ParseFieldType(type, entry.type))
+            {
+                SetLastError("Invalid schema field: '" + Trim(field) + "'");
+                return false;
+            }
+
+            if (schema.fields.size() >= kMaxFields)
+            {
+                SetLastError("Too many schema fields");
+                return false;
+            }
+
+            entry.offset = schema.payload_size;
+            schema.payload_size += FieldSize(entry.type);
+            schema.fields.push_back(std::move(entry));
+
+            start = end + 1;
+        }
+
+        return true;
+    }
+
+
+    // Limites dos campos inteiros; u64 não cabe em int64_t e é tratado à parte
+    static void IntegerLimits(FieldType type, int64_t& min, int64_t& max)
+    {
+        switch (type)
+        {
+        case FieldType::U8: min = 0; max = UINT8_MAX; break;
+        case FieldType::I8: min = INT8_MIN; max = INT8_MAX; break;
+        case FieldType::U16: min = 0; max = UINT16_MAX; break;
+        case FieldType::I16: min = INT16_MIN; max = INT16_MAX; break;
+        case FieldType::U32: min = 0; max = UINT32_MAX; break;
+        case FieldType::I32: min = INT32_MIN; max = INT32_MAX; break;
+        default: min = INT64_MIN; max = INT64_MAX; break;
+        }
+    }
+
+
+    // Conversões com saturação: NaN passa a 0 e valores fora do intervalo
+    // ficam no limite (converter diretamente seria comportamento indefinido)
+    static int64_t SaturateSigned(double value, int64_t min, int64_t max)
+    {
+        if (std::isnan(value))
+        {
+            return 0;
+        }
+
+        if (value <= static_cast<double>(min))
+        {
+            return min;
+        }
+
+        // static_cast<double>(INT64_MAX) arredonda para 2^63, fora do intervalo
+        if (value >= static_cast<double>(max))
+        {
+            return max;
+        }
+
+        return static_cast<int64_t>(value);
+    }
+
+
+    static uint64_t SaturateUnsigned(double value)
+    {
+        if (!(value > 0.0))
+        {
+            return 0;
+        }
+
+        if (value >= static_cast<double>(UINT64_MAX))
+        {
+            return UINT64_MAX;
+        }
+
+        return static_cast<uint64_t>(value);
+    }
+
+
+    static void StoreBits(unsigned char* out, FieldType type, uint64_t bits)
+    {
+        for (uint32_t i = 0; i < FieldSize(type); ++i)
+        {
+            out[i] = static_cast<unsigned char>(bits >> (8 * i));
+        }
+    }
+
+
+    static uint64_t LoadBits(const unsigned char* in, FieldType type)
+    {
+        uint64_t bits = 0;
+        for (uint32_t i = 0; i < FieldSize(type); ++i)
+        {
+            bits |= static_cast<uint64_t>(in[i]) << (8 * i);
+        }
+
+        return bits;
+    }
+
+
+    // Escreve value em little-endian com o tamanho do tipo
+    static void StoreField(unsigned char* out, FieldType type, double value)
+    {
+        uint64_t bits = 0;
+
+        switch (type)
+        {
+        case FieldType::F32:
+        {
+            float single = static_cast<float>(value);
+            uint32_t single_bits;
+            memcpy(&single_bits, &single, sizeof(single_bits));
+            bits = single_bits;
+            break;
+        }
+        case FieldType::F64:
+            memcpy(&bits, &value, sizeof(bits));
+            break;
+        case FieldType::U64:
+            bits = SaturateUnsigned(value);
+            break;
+        default:
+        {
+            // Inteiros com sinal ou de até 32 bits: complemento para dois
+            int64_t min, max;
+            IntegerLimits(type, min, max);
+            bits = static_cast<uint64_t>(SaturateSigned(value, min, max));
+            break;
+        }
+        }
+
+        StoreBits(out, type, bits);
+    }
+
+
+    static double LoadField(const unsigned char* in, FieldType type)
+    {
+        uint64_t bits = LoadBits(in, type);
+
+        switch (type)
+        {
+        case FieldType::U8: return static_cast<uint8_t>(bits);
+        case FieldType::I8: return static_cast<int8_t>(bits);
+        case FieldType::U16: return static_cast<uint16_t>(bits);
+        case FieldType::I16: return static_cast<int16_t>(bits);
+        case FieldType::U32: return static_cast<uint32_t>(bits);
+        case FieldType::I32: return static_cast<int32_t>(bits);
+        case FieldType::U64: return static_cast<double>(bits);
+        case FieldType::I64: return static_cast<double>(static_cast<int64_t>(bits));
+        case FieldType::F32:
+        {
+            uint32_t single_bits = static_cast<uint32_t>(bits);
+            float single;
+            memcpy(&single, &single_bits, sizeof(single));
+            return single;
+        }
+        default:
+        {
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        }
+    }
+
+
+    // Escreve um inteiro sem passar por double; em u64 value é o padrão de bits
+    static void StoreInteger(unsigned char* out, FieldType type, int64_t value)
+    {
+        switch (type)
+        {
+        case FieldType::F32:
+        case FieldType::F64:
+            StoreField(out, type, static_cast<double>(value));
+            break;
+        case FieldType::U64:
+        case FieldType::I64:
+            StoreBits(out, type, static_cast<uint64_t>(value));
+            break;
+        default:
+        {
+            int64_t min, max;
+            IntegerLimits(type, min, max);
+            StoreBits(out, type, static_cast<uint64_t>(std::min(std::max(value, min), max)));
+            break;
+        }
+        }
+    }
+
+
+    static int64_t LoadInteger(const unsigned char* in, FieldType type)
+    {
+        switch (type)
+        {
+        case FieldType::F32:
+        case FieldType::F64:
+            return SaturateSigned(LoadField(in, type), INT64_MIN, INT64_MAX);
+        case FieldType::U64:
+        case FieldType::I64:
+            return static_cast<int64_t>(LoadBits(in, type));
+        default:
+            // Até 32 bits o double é exato
+            return static_cast<int64_t>(LoadField(in, type));
+        }
+    }
+
+
+    bool SchemaRegistry::Register(int schema_id, const std::string& layout)
+    {
+        if (schema_id <= 0 || schema_id > 0xFFFF)
+        {
+            SetLastError("Invalid schema ID");
+            return false;
+        }
+
+        Schema schema;
+        if (!ParseLayout(layout, schema))
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_schemas.find(schema_id);
+        if (it != m_schemas.end())
+        {
+            if (it->second.layout != layout)
+            {
+                SetLastError("Schema ID already registered with a different layout");
+                return false;
+            }
+
+            return true;
+        }
+
+        m_schemas.emplace(schema_id, std::move(schema));
+        return true;
+    }
+
+
+    const Schema* SchemaRegistry::Find(int schema_id)
+    {
+        auto it = m_schemas.find(schema_id);
+        if (it == m_schemas.end())
+        {
+            SetLastError("Unknown schema ID");
+            return nullptr;
+        }
+
+        return &it->second;
+    }
+
+
+    int SchemaRegistry::RecordSize(int schema_id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const Schema* schema = Find(schema_id);
+        return schema ? static_cast<int>(kRecordHeaderSize + schema->payload_size) : -1;
+    }
+
+
+    int SchemaRegistry::FieldCount(int schema_id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const Schema* schema = Find(schema_id);
+        return schema ? static_cast<int>(schema->fields.size()) : -1;
+    }
+
+
+    int SchemaRegistry::Encode(int schema_id, const double* values, int count,
+                               void* buffer, size_t buffer_size)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const Schema* schema = Find(schema_id);
+        if (!schema)
+        {
+            return -1;
+        }
+
+        if (count != static_cast<int>(schema->fields.size()))
+        {
+            SetLastError("Value count does not match schema");
+            return -1;
+        }
+
+        size_t record_size = kRecordHeaderSize + schema->payload_size;
+        if (buffer_size < record_size)
+        {
+            SetLastError("Buffer too small for record");
+            return -1;
+        }
+
+        unsigned char* out = static_cast<unsigned char*>(buffer);
+        out[0] = kRecordMagic[0];
+        out[1] = kRecordMagic[1];
+        out[2] = static_cast<unsigned char>(schema_id);
+        out[3] = static_cast<unsigned char>(schema_id >> 8);
+        out[4] = static_cast<unsigned char>(schema->payload_size);
+        out[5] = static_cast<unsigned char>(schema->payload_size >> 8);
+        out[6] = static_cast<unsigned char>(schema->payload_size >> 16);
+        out[7] = static_cast<unsigned char>(schema->payload_size >> 24);
+
+        unsigned char* payload = out + kRecordHeaderSize;
+        for (size_t i = 0; i < schema->fields.size(); ++i)
+        {
+            const SchemaField& field = schema->fields[i];
+            StoreField(payload + field.offset, field.type, values[i]);
+        }
+
+        return static_cast<int>(record_size);
+    }
+
+
+    const Schema* SchemaRegistry::FindRecord(const void* record, size_t size, int& schema_id)
+    {
+        const unsigned char* in = static_cast<const unsigned char*>(record);
+
+        if (!record || size < kRecordHeaderSize || in[0] != kRecordMagic[0]
+            || in[1] != kRecordMagic[1])
+        {
+            SetLastError("Not a binary record");
+            return nullptr;
+        }
+
+        schema_id = in[2] | (in[3] << 8);
+        uint32_t payload_size = static_cast<uint32_t>(in[4])
+            | (static_cast<uint32_t>(in[5]) << 8)
+            | (static_cast<uint32_t>(in[6]) << 16)
+            | (static_cast<uint32_t>(in[7]) << 24);
+
+        const Schema* schema = Find(schema_id);
+        if (!schema)
+        {
+            return nullptr;
+        }
+
+        if (payload_size != schema->payload_size
+            || size < kRecordHeaderSize + payload_size)
+        {
+            SetLastError("Record does not match schema");
+            return nullptr;
+        }
+
+        return schema;
+    }
+
+
+    int SchemaRegistry::Decode(const void* record, size_t size, int* schema_id,
+                               double* values, int max_values)
+    {
+        const unsigned char* in = static_cast<const unsigned char*>(record);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        int id;
+        const Schema* schema = FindRecord(record, size, id);
+        if (!schema)
+        {
+            return -1;
+        }
+
+        int count = static_cast<int>(schema->fields.size());
+        if (max_values < count)
+        {
+            SetLastError("Buffer too small for record fields");
+            return -1;
+        }
+
+        const unsigned char* payload = in + kRecordHeaderSize;
+        for (int i = 0; i < count; ++i)
+        {
+            const SchemaField& field = schema->fields[i];
+            values[i] = LoadField(payload + field.offset, field.type);
+        }
+
+        *schema_id = id;
+        return count;
+    }
+
+
+    bool SchemaRegistry::SetInteger(void* record, size_t size, int field, int64_t value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        int id;
+        const Schema* schema = FindRecord(record, size, id);
+        if (!schema)
+        {
+            return false;
+        }
+
+        if (field < 0 || field >= static_cast<int>(schema->fields.size()))
+        {
+            SetLastError("Invalid record field index");
+            return false;
+        }
+
+        const SchemaField& entry = schema->fields[field];
+        StoreInteger(static_cast<unsigned char*>(record) + kRecordHeaderSize + entry.offset,
+                     entry.type, value);
+        return true;
+    }
+
+
+    bool SchemaRegistry::GetInteger(const void* record, size_t size, int field, int64_t& value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        int id;
+        const Schema* schema = FindRecord(record, size, id);
+        if (!schema)
+        {
+            return false;
+        }
+
+        if (field < 0 || field >= static_cast<int>(schema->fields.size()))
+        {
+            SetLastError("Invalid record field index");
+            return false;
+        }
+
+        const SchemaField& entry = schema->fields[field];
+        value = LoadInteger(static_cast<const unsigned char*>(record) + kRecordHeaderSize
+                                + entry.offset,
+                            entry.type);
+        return true;
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,89 @@
+// Schema.h - Registo de esquemas de registos binários de layout fixo
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Cabeçalho (little-endian) de cada registo:
+//   0  magic "ZR"
+//   2  u16 schema_id
+//   4  u32 tamanho dos campos
+// seguido dos campos, empacotados sem padding pela ordem do esquema.
+constexpr size_t kRecordHeaderSize = 8;
+
+
+enum class FieldType : uint8_t { U8, I8, U16, I16, U32, I32, U64, I64, F32, F64 };
+
+
+struct SchemaField {
+    std::string name;
+
+    FieldType type;
+
+    uint32_t offset;
+};
+
+
+struct Schema {
+    std::string layout;
+
+    std::vector<SchemaField> fields;
+
+    // Tamanho dos campos, sem o cabeçalho
+    uint32_t payload_size = 0;
+};
+
+
+// Esquemas por ID (1-65535). Os dois lados registam o mesmo layout com o
+// mesmo ID; o ID viaja no cabeçalho de cada registo.
+class SchemaRegistry {
+public:
+    // layout: "nome:tipo,nome:tipo,..." com tipos u8, i8, u16, i16, u32,
+    // i32, u64, i64, f32 e f64. Registar de novo o mesmo layout não tem
+    // efeito; um layout diferente para um ID já usado é um erro.
+    bool Register(int schema_id, const std::string& layout);
+
+    // Tamanho do registo completo (cabeçalho incluído), ou -1
+    int RecordSize(int schema_id);
+
+    int FieldCount(int schema_id);
+
+    // Escreve o registo em buffer convertendo cada valor para o tipo do
+    // campo (com saturação; NaN passa a 0). Devolve o número de bytes
+    // escritos, ou -1.
+    int Encode(int schema_id, const double* values, int count, void* buffer,
+               size_t buffer_size);
+
+    // Lê um registo para values (um double por campo). Devolve o número de
+    // campos lidos, ou -1.
+    int Decode(const void* record, size_t size, int* schema_id, double* values,
+               int max_values);
+
+    // Lê ou escreve um campo de um registo já codificado como inteiro de
+    // 64 bits, sem passar por double (u64 leva o padrão de bits)
+    bool SetInteger(void* record, size_t size, int field, int64_t value);
+
+    bool GetInteger(const void* record, size_t size, int field, int64_t& value);
+
+private:
+    // Chamado com m_mutex bloqueado
+    const Schema* Find(int schema_id);
+
+    // Valida o cabeçalho do registo e devolve o seu esquema (com m_mutex)
+    const Schema* FindRecord(const void* record, size_t size, int& schema_id);
+
+    std::unordered_map<int, Schema> m_schemas;
+
+    std::mutex m_mutex;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,599 @@
+#include <zmq.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
+#include "ZMQBridge.h"
+#include "BufferPool.h"
+#include "Endian.h"
+#include "Internal.h"
+#include "SharedMemory.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    static const unsigned char kSegmentMagic[4] = { 'Z', 'B', 'S', '1' };
+
+    static const unsigned char kNotifyMagic[4] = { 'Z', 'B', 'N', '1' };
+
+    static const size_t kMaxNameLength = 64;
+
+    static const int kMaxSlotCount = 65536;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                  "Shared memory sequences need lock-free 64-bit atomics");
+
+
+    // Primeiro campo de cada slot; alinhado a 64 bytes dentro do segmento
+    static std::atomic<uint64_t>* SlotSequence(unsigned char* slot)
+    {
+        return reinterpret_cast<std::atomic<uint64_t>*>(slot);
+    }
+
+
+    // Nomes portáveis entre shm_open, CreateFileMapping e o cliente Python
+    static bool IsValidName(const std::string& name)
+    {
+        if (name.empty() || name.size() > kMaxNameLength)
+        {
+            return false;
+        }
+
+        for (char c : name)
+        {
+            bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+                || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.';
+            if (!valid)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    // Endpoints cujos pares estão garantidamente neste host
+    static bool IsLocalEndpoint(const std::string& endpoint)
+    {
+        if (endpoint.rfind("ipc://", 0) == 0 || endpoint.rfind("inproc://", 0) == 0)
+        {
+            return true;
+        }
+
+        const char* loopback[] = { "tcp://127.", "tcp://localhost:", "tcp://[::1]:" };
+        for (const char* prefix : loopback)
+        {
+            if (endpoint.rfind(prefix, 0) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    ShmSegment::~ShmSegment()
+    {
+        Close();
+    }
+
+
+#ifdef _WIN32
+
+    bool ShmSegment::Create(const std::string& name, size_t size)
+    {
+        Close();
+
+        uint64_t size64 = static_cast<uint64_t>(size);
+        HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                            static_cast<DWORD>(size64 >> 32),
+                                            static_cast<DWORD>(size64), name.c_str());
+        if (!mapping)
+        {
+            SetLastError("Failed to create shared memory segment '" + name + "'");
+            return false;
+        }
+
+        // Um segmento com o mesmo nome ainda aberto noutro processo não pode
+        // ser substituído
+        if (::GetLastError() == ERROR_ALREADY_EXISTS)
+        {
+            CloseHandle(mapping);
+            SetLastError("Shared memory segment '" + name + "' already exists");
+            return false;
+        }
+
+        void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!data)
+        {
+            CloseHandle(mapping);
+            SetLastError("Failed to map shared memory segment '" + name + "'");
+            return false;
+        }
+
+        m_name = name;
+        m_owner = true;
+        m_mapping = mapping;
+        m_data = static_cast<unsigned char*>(data);
+        m_size = size;
+        return true;
+    }
+
+
+    bool ShmSegment::Open(const std::string& name)
+    {
+        Close();
+
+        HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+        if (!mapping)
+        {
+            SetLastError("Shared memory segment '" + name + "' not available on this host");
+            return false;
+        }
+
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        MEMORY_BASIC_INFORMATION info;
+        if (!data || VirtualQuery(data, &info, sizeof(info)) == 0)
+        {
+            if (data)
+            {
+                UnmapViewOfFile(data);
+            }
+
+            CloseHandle(mapping);
+            SetLastError("Failed to map shared memory segment '" + name + "'");
+            return false;
+        }
+
+        m_name = name;
+        m_owner = false;
+        m_mapping = mapping;
+        m_data = static_cast<unsigned char*>(data);
+        m_size = info.RegionSize;
+        return true;
+    }
+
+
+    void ShmSegment::Close()
+    {
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+            m_data = nullptr;
+        }
+
+        // O Windows remove o segmento quando o último handle é fechado
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        }
+
+        m_size = 0;
+        m_owner = false;
+        m_name.clear();
+    }
+
+#else
+
+    bool ShmSegment::Create(const std::string& name, size_t size)
+    {
+        Close();
+
+        std::string path = "/" + name;
+
+        // Os leitores que ainda tenham o segmento antigo mapeado mantêm-no
+        shm_unlink(path.c_str());
+
+        int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+        {
+            SetLastError("Failed to create shared memory segment '" + name + "'");
+            return false;
+        }
+
+        void* data = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+        {
+            data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+
+        close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            shm_unlink(path.c_str());
+            SetLastError("Failed to map shared memory segment '" + name + "'");
+            return false;
+        }
+
+        m_name = name;
+        m_owner = true;
+        m_data = static_cast<unsigned char*>(data);
+        m_size = size;
+        return true;
+    }
+
+
+    bool ShmSegment::Open(const std::string& name)
+    {
+        Close();
+
+        std::string path = "/" + name;
+        int fd = shm_open(path.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+        {
+            SetLastError("Shared memory segment '" + name + "' not available on this host");
+            return false;
+        }
+
+        struct stat info;
+        void* data = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED,
+                        fd, 0);
+        }
+
+        close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            SetLastError("Failed to map shared memory segment '" + name + "'");
+            return false;
+        }
+
+        m_name = name;
+        m_owner = false;
+        m_data = static_cast<unsigned char*>(data);
+        m_size = static_cast<size_t>(info.st_size);
+        return true;
+    }
+
+
+    void ShmSegment::Close()
+    {
+        if (m_data)
+        {
+            munmap(m_data, m_size);
+            m_data = nullptr;
+        }
+
+        if (m_owner)
+        {
+            shm_unlink(("/" + m_name).c_str());
+        }
+
+        m_size = 0;
+        m_owner = false;
+        m_name.clear();
+    }
+
+#endif
+
+
+    ShmPublisher::~ShmPublisher()
+    {
+        Stop();
+    }
+
+
+    bool ShmPublisher::Start(int socket_id, const std::string& name, int slot_count,
+                             int slot_size, int flags)
+    {
+        if (!IsValidName(name))
+        {
+            SetLastError("Invalid shared memory name (use up to 64 letters, digits, '_', '-' or '.')");
+            return false;
+        }
+
+        if (slot_count <= 0 || slot_count > kMaxSlotCount || slot_size <= 0)
+        {
+            SetLastError("Invalid shared memory slot count or size");
+            return false;
+        }
+
+        bool local = (flags & ZMQ_BRIDGE_SHM_ALWAYS) != 0;
+
+        {
+            SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+            if (!lock)
+            {
+                return false;
+            }
+
+            if (!local)
+            {
+                local = IsLocalEndpoint(lock.Socket().get(zmq::sockopt::last_endpoint));
+            }
+        }
+
+        // Dados de cada slot alinhados a 64 bytes, como os cabeçalhos
+        size_t stride = kShmSlotHeaderSize + ((static_cast<size_t>(slot_size) + 63) & ~size_t(63));
+        size_t total = kShmHeaderSize + stride * static_cast<size_t>(slot_count);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_segment.Create(name, total))
+        {
+            return false;
+        }
+
+        std::random_device device;
+        m_token = (static_cast<uint64_t>(device()) << 32) | device();
+
+        m_socket_id = socket_id;
+        m_name = name;
+        m_slot_count = static_cast<uint32_t>(slot_count);
+        m_slot_size = static_cast<uint32_t>(slot_size);
+        m_slot_stride = static_cast<uint32_t>(stride);
+        m_next_slot = 0;
+        m_local = local;
+
+        unsigned char* header = m_segment.Data();
+        StoreLE(header + 4, m_slot_count, 4);
+        StoreLE(header + 8, m_slot_size, 4);
+        StoreLE(header + 12, m_slot_stride, 4);
+        StoreLE(header + 16, m_token, 8);
+
+        // O magic por último: um leitor nunca vê um cabeçalho incompleto
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(header, kSegmentMagic, sizeof(kSegmentMagic));
+        return true;
+    }
+
+
+    void ShmPublisher::Stop()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_segment.Close();
+        m_socket_id = -1;
+    }
+
+
+    bool ShmPublisher::Write(const void* data, size_t size, zmq::message_t& notification)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_segment.Data() || !m_local || size > m_slot_size)
+        {
+            return false;
+        }
+
+        uint32_t slot = m_next_slot;
+        m_next_slot = (m_next_slot + 1) % m_slot_count;
+
+        unsigned char* base =
+            m_segment.Data() + kShmHeaderSize + static_cast<size_t>(slot) * m_slot_stride;
+        std::atomic<uint64_t>* sequence = SlotSequence(base);
+
+        // Seqlock: ímpar durante a escrita
+        uint64_t value = sequence->load(std::memory_order_relaxed);
+        sequence->store(value + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        StoreLE(base + 8, size, 4);
+        if (size > 0)
+        {
+            memcpy(base + kShmSlotHeaderSize, data, size);
+        }
+
+        sequence->store(value + 2, std::memory_order_release);
+
+        notification = BufferPool::Instance().AllocateMessage(
+            ZMQ_BRIDGE_SHM_NOTIFY_HEADER_SIZE + m_name.size());
+
+        unsigned char* out = static_cast<unsigned char*>(notification.data());
+        memcpy(out, kNotifyMagic, sizeof(kNotifyMagic));
+        StoreLE(out + 4, slot, 4);
+        StoreLE(out + 8, value + 2, 8);
+        StoreLE(out + 16, m_token, 8);
+        StoreLE(out + 24, size, 4);
+        StoreLE(out + 28, m_name.size(), 2);
+        StoreLE(out + 30, 0, 2);
+        memcpy(out + ZMQ_BRIDGE_SHM_NOTIFY_HEADER_SIZE, m_name.data(), m_name.size());
+        return true;
+    }
+
+
+    void ShmReaders::ExpireRetired()
+    {
+        auto now = std::chrono::steady_clock::now();
+        m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(),
+                                       [now](const std::unique_ptr<Mapping>& mapping) {
+                                           return now - mapping->retired_at
+                                               >= std::chrono::milliseconds(kRetiredMs);
+                                       }),
+                        m_retired.end());
+    }
+
+
+    ShmReaders::Mapping* ShmReaders::FindOrOpen(const std::string& name, uint64_t token)
+    {
+        auto it = m_mappings.find(name);
+        if (it != m_mappings.end() && it->second->token == token)
+        {
+            return it->second.get();
+        }
+
+        if (!IsValidName(name))
+        {
+            SetLastError("Invalid shared memory name in notification");
+            return nullptr;
+        }
+
+        ExpireRetired();
+
+        if (it == m_mappings.end() && m_mappings.size() >= kMaxMappings)
+        {
+            SetLastError("Too many shared memory segments mapped");
+            return nullptr;
+        }
+
+        if (it != m_mappings.end() && m_retired.size() >= kMaxRetired)
+        {
+            SetLastError("Shared memory segment '" + name + "' recreated too often");
+            return nullptr;
+        }
+
+        auto mapping = std::make_unique<Mapping>();
+        if (!mapping->segment.Open(name))
+        {
+            return nullptr;
+        }
+
+        const unsigned char* header = mapping->segment.Data();
+        if (mapping->segment.Size() < kShmHeaderSize
+            || memcmp(header, kSegmentMagic, sizeof(kSegmentMagic)) != 0)
+        {
+            SetLastError("Invalid shared memory segment '" + name + "'");
+            return nullptr;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        mapping->slot_count = static_cast<uint32_t>(LoadLE(header + 4, 4));
+        mapping->slot_size = static_cast<uint32_t>(LoadLE(header + 8, 4));
+        mapping->slot_stride = static_cast<uint32_t>(LoadLE(header + 12, 4));
+        mapping->token = LoadLE(header + 16, 8);
+
+        // Um segmento local com o mesmo nome mas outro token não é o do
+        // publicador (que pode estar noutro host)
+        if (mapping->token != token)
+        {
+            SetLastError("Shared memory segment '" + name + "' not available on this host");
+            return nullptr;
+        }
+
+        size_t needed = kShmHeaderSize
+            + static_cast<size_t>(mapping->slot_stride) * mapping->slot_count;
+        if (mapping->segment.Size() < needed
+            || mapping->slot_stride < kShmSlotHeaderSize + mapping->slot_size)
+        {
+            SetLastError("Invalid shared memory segment '" + name + "'");
+            return nullptr;
+        }
+
+        // Só um segmento novo válido substitui o atual (uma notificação
+        // com outro token não retira o mapeamento em uso)
+        if (it != m_mappings.end())
+        {
+            it->second->retired_at = std::chrono::steady_clock::now();
+            m_retired.push_back(std::move(it->second));
+            m_mappings.erase(it);
+        }
+
+        Mapping* result = mapping.get();
+        m_mappings.emplace(name, std::move(mapping));
+        return result;
+    }
+
+
+    int ShmReaders::Resolve(const void* frame, size_t size, zmq_bridge_shm_view& view)
+    {
+        memset(&view, 0, sizeof(view));
+
+        const unsigned char* in = static_cast<const unsigned char*>(frame);
+        if (!in || size < ZMQ_BRIDGE_SHM_NOTIFY_HEADER_SIZE
+            || memcmp(in, kNotifyMagic, sizeof(kNotifyMagic)) != 0)
+        {
+            // Mensagem normal: os dados estão no próprio frame
+            view.data = frame;
+            view.size = static_cast<int>(size);
+            view.slot = -1;
+            return ZMQ_BRIDGE_SHM_INLINE;
+        }
+
+        uint32_t slot = static_cast<uint32_t>(LoadLE(in + 4, 4));
+        uint64_t sequence = LoadLE(in + 8, 8);
+        uint64_t token = LoadLE(in + 16, 8);
+        uint32_t length = static_cast<uint32_t>(LoadLE(in + 24, 4));
+        size_t name_length = static_cast<size_t>(LoadLE(in + 28, 2));
+
+        if (size != ZMQ_BRIDGE_SHM_NOTIFY_HEADER_SIZE + name_length)
+        {
+            SetLastError("Invalid shared memory notification");
+            return ZMQ_BRIDGE_ERROR_SHM;
+        }
+
+        std::string name(reinterpret_cast<const char*>(in + ZMQ_BRIDGE_SHM_NOTIFY_HEADER_SIZE),
+                         name_length);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Mapping* mapping = FindOrOpen(name, token);
+        if (!mapping)
+        {
+            return ZMQ_BRIDGE_ERROR_SHM;
+        }
+
+        if (slot >= mapping->slot_count || length > mapping->slot_size)
+        {
+            SetLastError("Invalid shared memory notification");
+            return ZMQ_BRIDGE_ERROR_SHM;
+        }
+
+        unsigned char* base = mapping->segment.Data() + kShmHeaderSize
+            + static_cast<size_t>(slot) * mapping->slot_stride;
+        std::atomic<uint64_t>* slot_sequence = SlotSequence(base);
+
+        if (slot_sequence->load(std::memory_order_acquire) != sequence)
+        {
+            SetLastError("Shared memory slot already overwritten");
+            return ZMQ_BRIDGE_ERROR_SHM;
+        }
+
+        view.data = base + kShmSlotHeaderSize;
+        view.size = static_cast<int>(length);
+        view.slot = static_cast<int>(slot);
+        view.sequence = static_cast<long long>(sequence);
+        view.internal = slot_sequence;
+        return ZMQ_BRIDGE_OK;
+    }
+
+
+    bool ShmReaders::IsValid(const zmq_bridge_shm_view& view)
+    {
+        // Vistas de mensagens normais nunca deixam de ser válidas
+        if (!view.internal)
+        {
+            return true;
+        }
+
+        // Garante que as leituras dos dados terminaram antes de reler a sequência
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        const auto* sequence = static_cast<const std::atomic<uint64_t>*>(view.internal);
+        return sequence->load(std::memory_order_relaxed)
+            == static_cast<uint64_t>(view.sequence);
+    }
+
+
+    void ShmReaders::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_mappings.clear();
+        m_retired.clear();
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
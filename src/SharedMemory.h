@@ -0,0 +1,164 @@
+// SharedMemory.h - Canal de memória partilhada: dados num anel de slots,
+// notificações pelo ZeroMQ
+#pragma once
+
+#include <zmq.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ZMQBridge.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Layout do segmento (little-endian, ver ZMQ_BRIDGE_SHM_* em ZMQBridge.h):
+//   cabeçalho (64 bytes): "ZBS1", u32 slot_count, u32 slot_size,
+//     u32 slot_stride, u64 token
+//   slot i em 64 + i * slot_stride: u64 sequência, u32 tamanho, e os dados
+//     a partir do byte 64 do slot
+// A sequência de cada slot é um seqlock: ímpar enquanto o slot é escrito,
+// par (e diferente da anterior) depois de escrito.
+constexpr size_t kShmHeaderSize = 64;
+constexpr size_t kShmSlotHeaderSize = 64;
+
+
+// Segmento de memória partilhada com nome (shm_open + mmap em POSIX,
+// CreateFileMapping no Windows)
+class ShmSegment {
+public:
+    ShmSegment() = default;
+
+    ~ShmSegment();
+
+    ShmSegment(const ShmSegment&) = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+
+    // Cria o segmento, substituindo um anterior com o mesmo nome (ex.: de
+    // um processo que terminou sem o remover)
+    bool Create(const std::string& name, size_t size);
+
+    // Mapeia só para leitura um segmento existente
+    bool Open(const std::string& name);
+
+    // Desmapeia; o criador também remove o nome
+    void Close();
+
+    unsigned char* Data() const { return m_data; }
+
+    size_t Size() const { return m_size; }
+
+private:
+    std::string m_name;
+
+    bool m_owner = false;
+
+    unsigned char* m_data = nullptr;
+
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void* m_mapping = nullptr;
+#endif
+};
+
+
+// Lado do publicador: copia cada mensagem para o próximo slot do anel e
+// produz a notificação que viaja pelo ZeroMQ no lugar dos dados. O anel
+// nunca espera pelos leitores; um leitor atrasado deteta pela sequência
+// que o slot já foi reescrito.
+class ShmPublisher {
+public:
+    ~ShmPublisher();
+
+    bool Start(int socket_id, const std::string& name, int slot_count, int slot_size,
+               int flags);
+
+    void Stop();
+
+    int SocketId() const { return m_socket_id; }
+
+    // Escreve data num slot e preenche notification. Devolve false se a
+    // mensagem deve seguir pelo caminho normal (endpoint remoto ou
+    // mensagem maior do que um slot).
+    bool Write(const void* data, size_t size, zmq::message_t& notification);
+
+private:
+    std::mutex m_mutex;
+
+    int m_socket_id = -1;
+
+    std::string m_name;
+
+    ShmSegment m_segment;
+
+    uint32_t m_slot_count = 0;
+
+    uint32_t m_slot_size = 0;
+
+    uint32_t m_slot_stride = 0;
+
+    uint32_t m_next_slot = 0;
+
+    uint64_t m_token = 0;
+
+    // false: os subscritores podem estar noutro host
+    bool m_local = false;
+};
+
+
+// Lado do leitor: mapeia (uma vez por nome) os segmentos referidos pelas
+// notificações. Os nomes vêm da rede: só nomes válidos para
+// zmq_bridge_shm_create são abertos, e no máximo kMaxMappings segmentos
+// ficam mapeados. Um segmento recriado com o mesmo nome (token diferente) é
+// mapeado de novo; o mapeamento antigo ainda pode ter vistas a apontar para
+// ele e só é libertado kRetiredMs depois (ou em Clear()).
+class ShmReaders {
+public:
+    int Resolve(const void* frame, size_t size, zmq_bridge_shm_view& view);
+
+    static bool IsValid(const zmq_bridge_shm_view& view);
+
+    void Clear();
+
+private:
+    struct Mapping
+    {
+        ShmSegment segment;
+
+        uint64_t token = 0;
+
+        uint32_t slot_count = 0;
+
+        uint32_t slot_size = 0;
+
+        uint32_t slot_stride = 0;
+
+        std::chrono::steady_clock::time_point retired_at;
+    };
+
+    static constexpr size_t kMaxMappings = 64;
+
+    static constexpr size_t kMaxRetired = 16;
+
+    static constexpr int64_t kRetiredMs = 10000;
+
+    Mapping* FindOrOpen(const std::string& name, uint64_t token);
+
+    // Liberta os mapeamentos retirados há mais de kRetiredMs
+    void ExpireRetired();
+
+    std::map<std::string, std::unique_ptr<Mapping>> m_mappings;
+
+    std::vector<std::unique_ptr<Mapping>> m_retired;
+
+    std::mutex m_mutex;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
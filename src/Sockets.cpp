@@ -1,19 +1,574 @@
 #include <zmq.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
 #include "ZMQBridge.h"
+#include "Endian.h"
 #include "Internal.h"
 
 namespace zmq_bridge {
 namespace internal {
 
 
+    // Nome usado nas mensagens de erro
+    static const char* SocketTypeName(zmq::socket_type type)
+    {
+        switch (type)
+        {
+        case zmq::socket_type::pub: return "publisher";
+        case zmq::socket_type::sub: return "subscriber";
+        case zmq::socket_type::req: return "request";
+        case zmq::socket_type::rep: return "reply";
+        case zmq::socket_type::push: return "push";
+        case zmq::socket_type::pull: return "pull";
+        case zmq::socket_type::dealer: return "dealer";
+        case zmq::socket_type::router: return "router";
+        default: return "";
+        }
+    }
+
+
+    // Correspondência entre ZMQ_BRIDGE_OPT_* e as opções do ZeroMQ
+    struct OptionInfo {
+        int option;
+        int zmq_option;
+        bool is_uint64;
+    };
+
+    static const OptionInfo kOptions[] = {
+        { ZMQ_BRIDGE_OPT_SNDHWM, ZMQ_SNDHWM, false },
+        { ZMQ_BRIDGE_OPT_RCVHWM, ZMQ_RCVHWM, false },
+        { ZMQ_BRIDGE_OPT_SNDBUF, ZMQ_SNDBUF, false },
+        { ZMQ_BRIDGE_OPT_RCVBUF, ZMQ_RCVBUF, false },
+        { ZMQ_BRIDGE_OPT_LINGER, ZMQ_LINGER, false },
+        { ZMQ_BRIDGE_OPT_CONFLATE, ZMQ_CONFLATE, false },
+        { ZMQ_BRIDGE_OPT_IMMEDIATE, ZMQ_IMMEDIATE, false },
+        { ZMQ_BRIDGE_OPT_TCP_KEEPALIVE, ZMQ_TCP_KEEPALIVE, false },
+        { ZMQ_BRIDGE_OPT_TCP_KEEPALIVE_IDLE, ZMQ_TCP_KEEPALIVE_IDLE, false },
+        { ZMQ_BRIDGE_OPT_TCP_KEEPALIVE_INTVL, ZMQ_TCP_KEEPALIVE_INTVL, false },
+        { ZMQ_BRIDGE_OPT_TCP_KEEPALIVE_CNT, ZMQ_TCP_KEEPALIVE_CNT, false },
+        { ZMQ_BRIDGE_OPT_AFFINITY, ZMQ_AFFINITY, true },
+        { ZMQ_BRIDGE_OPT_SNDTIMEO, ZMQ_SNDTIMEO, false },
+        { ZMQ_BRIDGE_OPT_RCVTIMEO, ZMQ_RCVTIMEO, false },
+    };
+
+
+    static const OptionInfo* FindOption(int option)
+    {
+        for (const auto& info : kOptions)
+        {
+            if (info.option == option)
+            {
+                return &info;
+            }
+        }
+
+        SetLastError("Unknown socket option");
+        return nullptr;
+    }
+
+
+    bool SetSocketOption(zmq::socket_t& socket, int option, long long value)
+    {
+        const OptionInfo* info = FindOption(option);
+        if (!info)
+        {
+            return false;
+        }
+
+        int rc;
+        if (info->is_uint64)
+        {
+            uint64_t option_value = static_cast<uint64_t>(value);
+            rc = zmq_setsockopt(socket.handle(), info->zmq_option, &option_value,
+                                sizeof(option_value));
+        }
+        else
+        {
+            int option_value = static_cast<int>(value);
+            rc = zmq_setsockopt(socket.handle(), info->zmq_option, &option_value,
+                                sizeof(option_value));
+        }
+
+        if (rc != 0)
+        {
+            throw zmq::error_t();
+        }
+
+        return true;
+    }
+
+
+    bool GetSocketOption(zmq::socket_t& socket, int option, long long& value)
+    {
+        const OptionInfo* info = FindOption(option);
+        if (!info)
+        {
+            return false;
+        }
+
+        int rc;
+        if (info->is_uint64)
+        {
+            uint64_t option_value = 0;
+            size_t size = sizeof(option_value);
+            rc = zmq_getsockopt(socket.handle(), info->zmq_option, &option_value, &size);
+            value = static_cast<long long>(option_value);
+        }
+        else
+        {
+            int option_value = 0;
+            size_t size = sizeof(option_value);
+            rc = zmq_getsockopt(socket.handle(), info->zmq_option, &option_value, &size);
+            value = option_value;
+        }
+
+        if (rc != 0)
+        {
+            throw zmq::error_t();
+        }
+
+        return true;
+    }
+
+
+    void InitSocketOptions(zmq_bridge_socket_options& options)
+    {
+        options.sndhwm = -1;
+        options.rcvhwm = -1;
+        options.sndbuf = -1;
+        options.rcvbuf = -1;
+        options.linger = -1;
+        options.conflate = -1;
+        options.immediate = -1;
+        options.tcp_keepalive = -1;
+        options.tcp_keepalive_idle = -1;
+        options.tcp_keepalive_intvl = -1;
+        options.tcp_keepalive_cnt = -1;
+        options.sndtimeo = -1;
+        options.rcvtimeo = -1;
+        options.affinity = -1;
+    }
+
+
+    void ApplySocketOptions(zmq::socket_t& socket, const zmq_bridge_socket_options& options)
+    {
+        const struct
+        {
+            int option;
+            long long value;
+        } values[] = {
+            { ZMQ_BRIDGE_OPT_SNDHWM, options.sndhwm },
+            { ZMQ_BRIDGE_OPT_RCVHWM, options.rcvhwm },
+            { ZMQ_BRIDGE_OPT_SNDBUF, options.sndbuf },
+            { ZMQ_BRIDGE_OPT_RCVBUF, options.rcvbuf },
+            { ZMQ_BRIDGE_OPT_LINGER, options.linger },
+            { ZMQ_BRIDGE_OPT_CONFLATE, options.conflate },
+            { ZMQ_BRIDGE_OPT_IMMEDIATE, options.immediate },
+            { ZMQ_BRIDGE_OPT_TCP_KEEPALIVE, options.tcp_keepalive },
+            { ZMQ_BRIDGE_OPT_TCP_KEEPALIVE_IDLE, options.tcp_keepalive_idle },
+            { ZMQ_BRIDGE_OPT_TCP_KEEPALIVE_INTVL, options.tcp_keepalive_intvl },
+            { ZMQ_BRIDGE_OPT_TCP_KEEPALIVE_CNT, options.tcp_keepalive_cnt },
+            { ZMQ_BRIDGE_OPT_SNDTIMEO, options.sndtimeo },
+            { ZMQ_BRIDGE_OPT_RCVTIMEO, options.rcvtimeo },
+            { ZMQ_BRIDGE_OPT_AFFINITY, options.affinity },
+        };
+
+        for (const auto& entry : values)
+        {
+            if (entry.value != -1)
+            {
+                SetSocketOption(socket, entry.option, entry.value);
+            }
+        }
+    }
+
+
+    static uint64_t ElapsedNs(std::chrono::steady_clock::time_point start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now() - start)
+                                         .count());
+    }
+
+
+    void SocketStats::Reset()
+    {
+        messages_sent = 0;
+        bytes_sent = 0;
+        messages_received = 0;
+        bytes_received = 0;
+        send_would_block = 0;
+        receive_would_block = 0;
+        send_errors = 0;
+        receive_errors = 0;
+        truncated = 0;
+        send_time.Reset();
+        receive_time.Reset();
+        envelopes_received = 0;
+        sequence_lost = 0;
+        sequence_reordered = 0;
+        latency.Reset();
+    }
+
+
+    static const unsigned char kEnvelopeMagic[4] = { 'Z', 'B', 'E', '1' };
+
+
+    static int64_t SteadyNowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+
+    static bool IsEnvelope(const zmq::message_t& message)
+    {
+        return message.size() == ZMQ_BRIDGE_ENVELOPE_SIZE && message.more()
+               && memcmp(message.data(), kEnvelopeMagic, sizeof(kEnvelopeMagic)) == 0;
+    }
+
+
+    // Envia o envelope da próxima mensagem; cabe dentro do zmq_msg_t
+    // (24 bytes), sem alocação, e não conta como mensagem nas estatísticas.
+    // A sequência é a do fluxo da mensagem (state.envelope_send_key)
+    static uint32_t NewEnvelopeSender()
+    {
+        std::random_device device;
+        std::uniform_int_distribution<uint32_t> distribution(1, UINT32_MAX);
+        return distribution(device);
+    }
+
+
+    static bool SendEnvelope(SocketState& state, zmq::send_flags flags)
+    {
+        // Fluxos a mais: recomeça todos com outro emissor, para que os
+        // recetores não vejam sequências a recuar
+        if (state.envelope_sequence.size() >= ZMQ_BRIDGE_ENVELOPE_MAX_STREAMS
+            && state.envelope_sequence.find(state.envelope_send_key)
+                   == state.envelope_sequence.end())
+        {
+            state.envelope_sequence.clear();
+            state.envelope_sender = NewEnvelopeSender();
+        }
+
+        uint64_t& sequence = state.envelope_sequence[state.envelope_send_key];
+
+        zmq::message_t envelope(ZMQ_BRIDGE_ENVELOPE_SIZE);
+        unsigned char* out = static_cast<unsigned char*>(envelope.data());
+        memcpy(out, kEnvelopeMagic, sizeof(kEnvelopeMagic));
+        StoreLE(out + 4, state.envelope_sender, 4);
+        StoreLE(out + 8, sequence, 8);
+        StoreLE(out + 16, static_cast<uint64_t>(SteadyNowNs()), 8);
+
+        bool sent;
+        try
+        {
+            sent = state.socket->send(envelope, flags | zmq::send_flags::sndmore).has_value();
+        } catch (const zmq::error_t&)
+        {
+            state.stats.send_errors.fetch_add(1, std::memory_order_relaxed);
+            throw;
+        }
+
+        if (!sent)
+        {
+            state.stats.send_would_block.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        sequence++;
+        return true;
+    }
+
+
+    // Esquece a metade dos fluxos recebidos usada há mais tempo (ex.:
+    // identidades de DEALERs que já desligaram, emissores reiniciados)
+    static void TrimEnvelopeStreams(
+        std::unordered_map<std::string, SocketState::EnvelopeStream>& streams)
+    {
+        std::vector<uint64_t> used;
+        used.reserve(streams.size());
+        for (const auto& stream : streams)
+        {
+            used.push_back(stream.second.used);
+        }
+
+        auto middle = used.begin() + used.size() / 2;
+        std::nth_element(used.begin(), middle, used.end());
+        uint64_t oldest = *middle;
+
+        for (auto it = streams.begin(); it != streams.end();)
+        {
+            it = it->second.used <= oldest ? streams.erase(it) : std::next(it);
+        }
+    }
+
+
+    // Se message for um envelope, regista a latência e a sequência do
+    // fluxo (emissor e primeiro frame da mensagem) e devolve true
+    static bool ReadEnvelope(SocketState& state, const zmq::message_t& message)
+    {
+        if (!IsEnvelope(message))
+        {
+            return false;
+        }
+
+        const unsigned char* in = static_cast<const unsigned char*>(message.data());
+
+        uint32_t sender = static_cast<uint32_t>(LoadLE(in + 4, 4));
+        uint64_t sequence = LoadLE(in + 8, 8);
+        int64_t sent_ns = static_cast<int64_t>(LoadLE(in + 16, 8));
+
+        SocketStats& stats = state.stats;
+        stats.envelopes_received.fetch_add(1, std::memory_order_relaxed);
+
+        // Relógios de hosts diferentes não são comparáveis: valores
+        // negativos são ignorados em vez de registados como zero
+        int64_t latency = SteadyNowNs() - sent_ns;
+        if (latency >= 0)
+        {
+            stats.latency.Record(static_cast<uint64_t>(latency));
+        }
+
+        // O primeiro frame já está em envelope_receive_key (ver Receive);
+        // o emissor vai à frente
+        std::string& key = state.envelope_receive_key;
+        key.insert(0, 4, '\0');
+        StoreLE(reinterpret_cast<unsigned char*>(&key[0]), sender, 4);
+
+        auto& streams = state.envelope_last_sequence;
+        uint64_t tick = ++state.envelope_receive_tick;
+
+        auto it = streams.find(key);
+        if (it == streams.end())
+        {
+            if (streams.size() >= ZMQ_BRIDGE_ENVELOPE_MAX_STREAMS)
+            {
+                TrimEnvelopeStreams(streams);
+            }
+
+            streams.emplace(key, SocketState::EnvelopeStream{ sequence, tick });
+        }
+        else if (sequence > it->second.sequence)
+        {
+            stats.sequence_lost.fetch_add(sequence - it->second.sequence - 1,
+                                          std::memory_order_relaxed);
+            it->second.sequence = sequence;
+            it->second.used = tick;
+        }
+        else
+        {
+            stats.sequence_reordered.fetch_add(1, std::memory_order_relaxed);
+            it->second.used = tick;
+        }
+
+        return true;
+    }
+
+
+    void SocketState::EnableEnvelope(bool enabled)
+    {
+        envelope = enabled;
+
+        if (enabled && envelope_sender == 0)
+        {
+            // Identificador aleatório: um emissor que reabre o socket
+            // recomeça a sequência sem parecer fora de ordem
+            envelope_sender = NewEnvelopeSender();
+        }
+    }
+
+
+    // Copia um frame para o gravador (o send esvazia a mensagem); grava a
+    // mensagem completa depois de o último frame ser aceite
+    static void TapFrame(SocketState& state, const zmq::message_t& message)
+    {
+        const unsigned char* data = static_cast<const unsigned char*>(message.data());
+        state.tap_buffer.insert(state.tap_buffer.end(), data, data + message.size());
+        state.tap_sizes.push_back(message.size());
+    }
+
+
+    static void FlushTap(SocketState& state)
+    {
+        state.tap_frames.clear();
+        const unsigned char* data = state.tap_buffer.data();
+        for (size_t size : state.tap_sizes)
+        {
+            state.tap_frames.push_back({ data, size });
+            data += size;
+        }
+
+        state.recorder->Append(state.recorder_channel, state.tap_frames.data(),
+                               state.tap_frames.size());
+
+        state.tap_buffer.clear();
+        state.tap_sizes.clear();
+    }
+
+
+    zmq::send_result_t SocketState::Send(zmq::message_t& message, zmq::send_flags flags)
+    {
+        size_t size = message.size();
+        auto start = std::chrono::steady_clock::now();
+
+        bool last = (static_cast<int>(flags) & static_cast<int>(zmq::send_flags::sndmore)) == 0;
+
+        // O primeiro frame identifica o fluxo da sequência; copiado antes
+        // do send, que esvazia a mensagem
+        if (envelope && envelope_send_start)
+        {
+            if (last)
+            {
+                envelope_send_key.clear();
+            }
+            else
+            {
+                envelope_send_key.assign(static_cast<const char*>(message.data()),
+                                         message.size());
+            }
+        }
+
+        // O envelope vai imediatamente antes do último frame
+        if (envelope && last && !SendEnvelope(*this, flags))
+        {
+            tap_buffer.clear();
+            tap_sizes.clear();
+            return {};
+        }
+
+        if (recorder)
+        {
+            TapFrame(*this, message);
+        }
+
+        zmq::send_result_t result;
+        try
+        {
+            result = socket->send(message, flags);
+        } catch (const zmq::error_t&)
+        {
+            stats.send_errors.fetch_add(1, std::memory_order_relaxed);
+            tap_buffer.clear();
+            tap_sizes.clear();
+            throw;
+        }
+
+        stats.send_time.Record(ElapsedNs(start));
+
+        if (result.has_value())
+        {
+            envelope_send_start = last;
+            stats.messages_sent.fetch_add(1, std::memory_order_relaxed);
+            stats.bytes_sent.fetch_add(size, std::memory_order_relaxed);
+
+            if (recorder && last)
+            {
+                FlushTap(*this);
+            }
+        }
+        else
+        {
+            stats.send_would_block.fetch_add(1, std::memory_order_relaxed);
+            tap_buffer.clear();
+            tap_sizes.clear();
+        }
+
+        return result;
+    }
+
+
+    bool SocketState::Receive(zmq::message_t& message, zmq::recv_flags flags)
+    {
+        if (!pending.empty())
+        {
+            message = std::move(pending.front());
+            pending.pop_front();
+            has_pending.store(!pending.empty(), std::memory_order_release);
+            pending_frames.store(static_cast<uint32_t>(pending.size()),
+                                 std::memory_order_relaxed);
+            return true;
+        }
+
+        // Só os frames lidos do libzmq contam (um frame devolvido com
+        // Unread() e lido de novo não é contado duas vezes)
+        auto start = std::chrono::steady_clock::now();
+
+        bool received;
+        try
+        {
+            received = socket->recv(message, flags).has_value();
+        } catch (const zmq::error_t&)
+        {
+            stats.receive_errors.fetch_add(1, std::memory_order_relaxed);
+            throw;
+        }
+
+        if (!received)
+        {
+            stats.receive_would_block.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (envelope && envelope_receive_start)
+        {
+            // Mesmo fluxo que o emissor usou: o primeiro frame, ou vazio se
+            // a mensagem começar pelo envelope
+            envelope_receive_key.clear();
+            if (message.more() && !IsEnvelope(message))
+            {
+                envelope_receive_key.assign(static_cast<const char*>(message.data()),
+                                            message.size());
+            }
+        }
+
+        // O resto da mensagem chega sempre junto com o envelope
+        while (envelope && ReadEnvelope(*this, message))
+        {
+            if (!socket->recv(message, flags).has_value())
+            {
+                stats.receive_errors.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        envelope_receive_start = !message.more();
+
+        stats.receive_time.Record(ElapsedNs(start));
+        stats.messages_received.fetch_add(1, std::memory_order_relaxed);
+        stats.bytes_received.fetch_add(message.size(), std::memory_order_relaxed);
+        return true;
+    }
+
+
+    void SocketState::Unread(zmq::message_t&& message)
+    {
+        pending.push_front(std::move(message));
+        has_pending.store(true, std::memory_order_release);
+        pending_frames.store(static_cast<uint32_t>(pending.size()), std::memory_order_relaxed);
+    }
+
+
+    void SocketState::ClearPending()
+    {
+        pending.clear();
+        has_pending.store(false, std::memory_order_release);
+        pending_frames.store(0, std::memory_order_relaxed);
+    }
+
+
     int SocketManager::CreateSocket(zmq::socket_type type,
                                     const std::string& endpoint,
-                                    bool bind_socket)
+                                    bool bind_socket,
+                                    const zmq_bridge_socket_options* options,
+                                    const std::string* topic)
     {
         auto context = Context::Instance().GetContext();
         if (!context)
         {
-            m_error = "Context not initialized";
             return -1;
         }
 
@@ -25,6 +580,17 @@ namespace internal {
             int linger = 0;
             socket->set(zmq::sockopt::linger, linger);
 
+            // As opções têm de ser definidas antes de bind/connect para
+            // valerem para todas as ligações
+            if (options)
+            {
+                ApplySocketOptions(*socket, *options);
+            }
+
+            if (topic)
+            {
+                socket->set(zmq::sockopt::subscribe, *topic);
+            }
 
             if (bind_socket)
             {
@@ -36,100 +602,136 @@ namespace internal {
             }
 
             // Atribui um ID e armazena o socket
-            int socket_id = m_next_socket_id++;
-
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_sockets[socket_id] = std::move(socket);
-
-            return socket_id;
+            return Register(std::move(socket));
         } catch (const zmq::error_t& e)
         {
-            m_error = "Failed to create socket: " + std::string(e.what());
+            SetLastError("Failed to create " + std::string(SocketTypeName(type))
+                         + " socket: " + std::string(e.what()));
             return -1;
         }
     }
 
 
     int SocketManager::CreateSubscriber(const std::string& endpoint,
-                                        const std::string& topic)
+                                        const std::string& topic,
+                                        bool conflate)
     {
-        auto context = Context::Instance().GetContext();
-        if (!context)
+        zmq_bridge_socket_options options;
+        InitSocketOptions(options);
+
+        if (conflate)
         {
-            m_error = "Context not initialized";
-            return -1;
+            options.conflate = 1;
         }
 
-        try
-        {
-            auto socket = std::make_unique<zmq::socket_t>(
-                *context, zmq::socket_type::sub);
+        return CreateSocket(zmq::socket_type::sub, endpoint, false, &options, &topic);
+    }
 
-            // Configura o socket para não bloquear quando fechado
-            int linger = 0;
-            socket->set(zmq::sockopt::linger, linger);
 
-            // Define o tópico de inscrição
-            socket->set(zmq::sockopt::subscribe, topic);
+    int SocketManager::Register(std::unique_ptr<zmq::socket_t> socket)
+    {
+        int socket_id = m_sockets.Insert([&](SocketState& state) {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.socket = std::move(socket);
+            state.ClearPending();
+            state.stats.Reset();
+            state.envelope = false;
+            state.envelope_sender = 0;
+            state.envelope_sequence.clear();
+            state.envelope_send_key.clear();
+            state.envelope_send_start = true;
+            state.envelope_last_sequence.clear();
+            state.envelope_receive_tick = 0;
+            state.envelope_receive_key.clear();
+            state.envelope_receive_start = true;
+            state.rpc_client.reset();
+            state.rpc_server.reset();
+            state.recorder = nullptr;
+            state.recorder_channel = 0;
+            state.tap_buffer.clear();
+            state.tap_sizes.clear();
+        });
+
+        if (socket_id < 0)
+        {
+            SetLastError("Too many open sockets");
+        }
 
-            // Conecta ao endpoint
-            socket->connect(endpoint);
+        return socket_id;
+    }
 
-            // Atribui um ID e armazena o socket
-            int socket_id = m_next_socket_id++;
 
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_sockets[socket_id] = std::move(socket);
+    SocketLock SocketManager::Acquire(int socket_id)
+    {
+        SocketState* state = m_sockets.Lookup(socket_id);
+        if (!state)
+        {
+            SetLastError("Invalid socket ID");
+            return SocketLock();
+        }
 
-            return socket_id;
-        } catch (const zmq::error_t& e)
+        std::unique_lock<std::mutex> lock(state->mutex);
+
+        // O socket pode ter sido fechado (e o slot reutilizado) enquanto
+        // esperávamos pelo lock
+        if (!m_sockets.IsCurrent(socket_id) || !state->socket)
         {
-            m_error =
-                "Failed to create subscriber socket: " + std::string(e.what());
-            return -1;
+            SetLastError("Invalid socket ID");
+            return SocketLock();
         }
+
+        return SocketLock(state, std::move(lock));
     }
 
 
-    zmq::socket_t* SocketManager::GetSocket(int socket_id)
+    bool SocketManager::HasPending(int socket_id) const
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
+        const SocketState* state = m_sockets.Lookup(socket_id);
+        return state && state->HasPending();
+    }
+
 
-        auto it = m_sockets.find(socket_id);
-        if (it == m_sockets.end())
+    bool SocketManager::CloseSocket(int socket_id)
+    {
+        // Retira o socket dos pollers antes de o fechar
+        if (m_sockets.IsCurrent(socket_id))
         {
-            m_error = "Invalid socket ID";
-            return nullptr;
+            Context::Instance().GetPollers().ForEach([socket_id](int, Poller& poller) {
+                poller.Forget(socket_id);
+            });
         }
 
-        return it->second.get();
-    }
+        // Espera que a operação em curso termine antes de fechar o socket
+        bool closed = m_sockets.Remove(socket_id, [socket_id](SocketState& state) {
+            std::lock_guard<std::mutex> lock(state.mutex);
 
+            Context::Instance().GetEncoder().ForgetSocket(socket_id);
 
-    bool SocketManager::CloseSocket(int socket_id)
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
+            if (std::shared_ptr<ReactorChannel> channel =
+                    std::atomic_exchange(&state.reactor, std::shared_ptr<ReactorChannel>()))
+            {
+                Context::Instance().GetReactor().Retire(*channel);
+            }
+
+            state.ClearPending();
+            state.socket.reset();
+        });
 
-        auto it = m_sockets.find(socket_id);
-        if (it == m_sockets.end())
+        if (!closed)
         {
-            m_error = "Invalid socket ID";
-            return false;
+            SetLastError("Invalid socket ID");
         }
 
-        m_sockets.erase(it);
-        return true;
+        return closed;
     }
 
 
     void SocketManager::CloseAllSockets()
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_sockets.clear();
+        m_sockets.ForEach([this](int socket_id, SocketState&) {
+            CloseSocket(socket_id);
+        });
     }
 
-
-    const std::string& SocketManager::GetLastError() const { return m_error; }
-
 } // namespace internal
 } // namespace zmq_bridge
@@ -0,0 +1,103 @@
+// SpscRing.h - Fila circular sem locks para um produtor e um consumidor
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Fila circular de capacidade fixa (potência de 2) para exatamente uma
+// thread produtora e uma thread consumidora. TryPush/Free só podem ser
+// chamados pelo produtor; Front/Pop só pelo consumidor.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        m_buffer.reset(new T[size]);
+        m_mask = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t Capacity() const { return m_mask + 1; }
+
+    // Produtor: devolve false se a fila estiver cheia
+    bool TryPush(T&& value)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+
+        if (head - tail > m_mask)
+        {
+            return false;
+        }
+
+        m_buffer[head & m_mask] = std::move(value);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Produtor: lugares livres
+    size_t Free() const
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        return Capacity() - (head - tail);
+    }
+
+    // Consumidor: próximo elemento, ou nullptr se a fila estiver vazia
+    T* Front()
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+
+        if (tail == head)
+        {
+            return nullptr;
+        }
+
+        return &m_buffer[tail & m_mask];
+    }
+
+    // Consumidor: descarta o elemento devolvido por Front()
+    void Pop()
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        // Liberta já os recursos do elemento (ex.: o buffer da mensagem)
+        m_buffer[tail & m_mask] = T();
+        m_tail.store(tail + 1, std::memory_order_release);
+    }
+
+    // Aproximado quando lido fora das threads produtora/consumidora
+    size_t Size() const
+    {
+        // tail antes de head: head só cresce, por isso nunca fica abaixo de tail
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        size_t head = m_head.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+private:
+    // Em linhas de cache separadas para o produtor e o consumidor
+    alignas(64) std::atomic<size_t> m_head{ 0 };
+    alignas(64) std::atomic<size_t> m_tail{ 0 };
+
+    std::unique_ptr<T[]> m_buffer;
+
+    size_t m_mask = 0;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include "ZMQBridge.h"
+#include "Internal.h"
+#include "TopicRegistry.h"
+
+namespace zmq_bridge {
+namespace internal {
+
+
+    uint32_t TopicRegistry::Child(const Node& node, unsigned char value) const
+    {
+        auto it = std::lower_bound(
+            node.children.begin(), node.children.end(), value,
+            [](const std::pair<unsigned char, uint32_t>& child, unsigned char key) {
+                return child.first < key;
+            });
+
+        return it != node.children.end() && it->first == value ? it->second : 0;
+    }
+
+
+    int TopicRegistry::Register(const std::string& topic)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        uint32_t index = 0;
+        for (char c : topic)
+        {
+            unsigned char value = static_cast<unsigned char>(c);
+            uint32_t child = Child(m_nodes[index], value);
+
+            if (child == 0)
+            {
+                child = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.emplace_back();
+
+                auto& children = m_nodes[index].children;
+                auto it = std::lower_bound(
+                    children.begin(), children.end(), value,
+                    [](const std::pair<unsigned char, uint32_t>& entry, unsigned char key) {
+                        return entry.first < key;
+                    });
+                children.insert(it, { value, child });
+            }
+
+            index = child;
+        }
+
+        if (m_nodes[index].topic_id >= 0)
+        {
+            return m_nodes[index].topic_id;
+        }
+
+        if (m_names.size() >= static_cast<size_t>(kMaxTopics))
+        {
+            SetLastError("Too many topics");
+            return -1;
+        }
+
+        // Os nós criados sem ID ficam na trie; não alteram o resultado de Match()
+        m_nodes[index].topic_id = static_cast<int>(m_names.size());
+        m_names.push_back(topic);
+        return m_nodes[index].topic_id;
+    }
+
+
+    bool TopicRegistry::Name(int topic_id, std::string& topic)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (topic_id < 0 || static_cast<size_t>(topic_id) >= m_names.size())
+        {
+            SetLastError("Unknown topic ID");
+            return false;
+        }
+
+        topic = m_names[topic_id];
+        return true;
+    }
+
+
+    int TopicRegistry::Match(const void* data, size_t size, size_t& length)
+    {
+        const unsigned char* in = static_cast<const unsigned char*>(data);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        int topic_id = m_nodes[0].topic_id;
+        length = 0;
+
+        uint32_t index = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            index = Child(m_nodes[index], in[i]);
+            if (index == 0)
+            {
+                break;
+            }
+
+            if (m_nodes[index].topic_id >= 0)
+            {
+                topic_id = m_nodes[index].topic_id;
+                length = i + 1;
+            }
+        }
+
+        return topic_id;
+    }
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,53 @@
+// TopicRegistry.h - Tópicos registados como IDs inteiros, numa trie de prefixos
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Cada tópico registado recebe um ID sequencial (a partir de 0). Match()
+// percorre a trie byte a byte e devolve o tópico registado mais longo que
+// é prefixo do frame, a mesma regra das subscrições do ZeroMQ: com
+// "camera" registado, "camera/front" tem o ID de "camera".
+class TopicRegistry {
+public:
+    static constexpr int kMaxTopics = 65536;
+
+    // ID do tópico (o mesmo se já estiver registado), ou -1
+    int Register(const std::string& topic);
+
+    // false se topic_id não existir
+    bool Name(int topic_id, std::string& topic);
+
+    // ID do tópico registado mais longo que é prefixo de data, ou -1;
+    // length recebe o tamanho desse tópico
+    int Match(const void* data, size_t size, size_t& length);
+
+private:
+    struct Node
+    {
+        int topic_id = -1;
+
+        // (byte, índice do nó), ordenados por byte
+        std::vector<std::pair<unsigned char, uint32_t>> children;
+    };
+
+    // Índice do filho de node com o byte value, ou 0 (a raiz nunca é filha)
+    uint32_t Child(const Node& node, unsigned char value) const;
+
+    std::vector<Node> m_nodes{ Node() };
+
+    std::vector<std::string> m_names;
+
+    std::mutex m_mutex;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
@@ -0,0 +1,74 @@
+// TripleBuffer.h - Último valor partilhado entre um produtor e um consumidor
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace zmq_bridge {
+namespace internal {
+
+
+// Três buffers rodados atomicamente: o produtor escreve sempre em Back() e
+// publica sem esperar; o consumidor lê sempre o valor publicado mais
+// recente em Front(). Um valor publicado que ainda não foi lido é
+// substituído pelo seguinte em vez de ficar em fila.
+//
+// Back()/Publish() só podem ser chamados por uma thread produtora de cada
+// vez; Update()/Front() só pela thread consumidora.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Produtor: buffer onde escrever o próximo valor
+    T& Back() { return m_buffers[m_back]; }
+
+    // Produtor: publica Back(). Devolve true se substituiu um valor que o
+    // consumidor ainda não tinha lido.
+    bool Publish()
+    {
+        uint8_t previous =
+            m_middle.exchange(static_cast<uint8_t>(m_back | kDirty),
+                              std::memory_order_acq_rel);
+        m_back = previous & kIndexMask;
+        return (previous & kDirty) != 0;
+    }
+
+    // Consumidor: passa o valor publicado mais recente para Front().
+    // Devolve false se não houver nada novo desde a última chamada.
+    bool Update()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & kDirty) == 0)
+        {
+            return false;
+        }
+
+        uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & kIndexMask;
+        return true;
+    }
+
+    // Consumidor: último valor obtido com Update()
+    T& Front() { return m_buffers[m_front]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kDirty = 0x4;
+
+    T m_buffers[3];
+
+    // Só o produtor
+    alignas(64) uint8_t m_back = 0;
+
+    // Índice do buffer partilhado, com kDirty se ainda não foi lido
+    alignas(64) std::atomic<uint8_t> m_middle{ 1 };
+
+    // Só o consumidor
+    alignas(64) uint8_t m_front = 2;
+};
+
+} // namespace internal
+} // namespace zmq_bridge
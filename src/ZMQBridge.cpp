@@ -1,319 +1,383 @@
 #include "ZMQBridge.h"
+#include "Internal.h"
+#include "Codec.h"
+#include "BufferPool.h"
 #include <zmq.hpp>
 #include <string>
-#include <vector>
-#include <unordered_map>
-#include <mutex>
-#include <memory>
+#include <algorithm>
 #include <cstring>
+#include <climits>
+#include <cstdlib>
+#include <memory>
+#include <vector>
 
-// Contexto global ZeroMQ
-static std::unique_ptr<zmq::context_t> g_context = nullptr;
-
-// Armazena os sockets criados
-static std::unordered_map<int, std::unique_ptr<zmq::socket_t>> g_sockets;
-
-// Próximo ID de socket disponível
-static int g_next_socket_id = 1;
-
-// Mutex para operações thread-safe
-static std::mutex g_mutex;
-
-// Último erro
-static std::string g_last_error;
+using zmq_bridge::internal::BufferPool;
+using zmq_bridge::internal::Context;
+using zmq_bridge::internal::LatestPublisher;
+using zmq_bridge::internal::Poller;
+using zmq_bridge::internal::ReactorChannel;
+using zmq_bridge::internal::ReactorFrame;
+using zmq_bridge::internal::Recorder;
+using zmq_bridge::internal::Replayer;
+using zmq_bridge::internal::RpcClient;
+using zmq_bridge::internal::RpcServer;
+using zmq_bridge::internal::Scheduler;
+using zmq_bridge::internal::ShmPublisher;
+using zmq_bridge::internal::SocketLock;
 
 // Define o último erro
 static void set_last_error(const std::string& error)
 {
-    std::lock_guard<std::mutex> lock(g_mutex);
-    g_last_error = error;
+    zmq_bridge::internal::SetLastError(error);
 }
 
- 
-EXPORT_API int zmq_bridge_init()
+// Confirma que o contexto foi inicializado
+static bool check_context()
 {
-    try
+    if (!Context::Instance().IsInitialized())
     {
-        std::lock_guard<std::mutex> lock(g_mutex);
-
-   
-        if (g_context)
-        {
-            return ZMQ_BRIDGE_OK;
-        }
+        set_last_error("ZeroMQ context not initialized");
+        return false;
+    }
 
-     
-        g_context = std::make_unique<zmq::context_t>(1);
-        g_next_socket_id = 1;
-        g_sockets.clear();
+    return true;
+}
 
-        return ZMQ_BRIDGE_OK;
-    } catch (const zmq::error_t& e)
-    {
-        set_last_error("ZMQ initialization error: " + std::string(e.what()));
-        return ZMQ_BRIDGE_ERROR_INIT;
-    } catch (const std::exception& e)
+// Cria um socket e converte falhas em códigos de erro da API
+static int create_socket(zmq::socket_type type, const char* endpoint,
+                         bool bind_socket)
+{
+    if (!check_context())
     {
-        set_last_error("General error during initialization: "
-                       + std::string(e.what()));
         return ZMQ_BRIDGE_ERROR_INIT;
     }
-}
 
- 
-EXPORT_API void zmq_bridge_shutdown()
-{
-    std::lock_guard<std::mutex> lock(g_mutex);
+    int socket_id = Context::Instance().GetSocketManager().CreateSocket(
+        type, endpoint, bind_socket);
 
- 
-    g_sockets.clear();
+    return socket_id < 0 ? ZMQ_BRIDGE_ERROR_SOCKET : socket_id;
+}
 
-  
-    g_context.reset();
+// Devolve ao pool buffers obtidos com zmq_bridge_alloc_buffer
+static void free_bridge_buffer(void* data, void* hint)
+{
+    BufferPool::Free(data, hint);
 }
 
- 
-EXPORT_API int zmq_bridge_create_publisher(const char* endpoint)
+// Cria uma mensagem que aponta para data sem a copiar. A partir daqui a
+// mensagem é dona do buffer; se falhar, o buffer é libertado de imediato.
+static bool make_zero_copy_message(zmq::message_t& message, void* data,
+                                   int size, zmq_bridge_free_fn free_fn,
+                                   void* hint)
 {
-    if (!g_context)
+    if (!free_fn)
     {
-        set_last_error("ZeroMQ context not initialized");
-        return ZMQ_BRIDGE_ERROR_INIT;
+        free_fn = free_bridge_buffer;
     }
 
-    try
+    if (size < 0 || (size > 0 && !data))
     {
-        std::lock_guard<std::mutex> lock(g_mutex);
+        free_fn(data, hint);
+        set_last_error("Invalid data");
+        return false;
+    }
 
-        auto socket =
-            std::make_unique<zmq::socket_t>(*g_context, zmq::socket_type::pub);
+    try
+    {
+        message = zmq::message_t(data, static_cast<size_t>(size), free_fn, hint);
+        return true;
+    } catch (const zmq::error_t& e)
+    {
+        free_fn(data, hint);
+        set_last_error("Failed to create message: " + std::string(e.what()));
+        return false;
+    }
+}
 
-        // Configura o socket
-        int linger = 0;
-        socket->set(zmq::sockopt::linger, linger);
+// Envia [tópico][mensagem] (ou só [mensagem] se topic for NULL) num socket
+// bloqueado
+static int publish_message_locked(SocketLock& lock, const char* topic,
+                                  zmq::message_t& data_msg)
+{
+    try
+    {
+        if (topic)
+        {
+            // Envia o tópico
+            zmq::message_t topic_msg(topic, strlen(topic));
+            auto topic_result =
+                lock.State().Send(topic_msg, zmq::send_flags::sndmore);
+
+            if (!topic_result.has_value())
+            {
+                set_last_error("Failed to send topic");
+                return ZMQ_BRIDGE_ERROR_SEND;
+            }
+        }
 
-        // Vincula ao endpoint
-        socket->bind(endpoint);
+        // Envia os dados
+        auto data_result = lock.State().Send(data_msg, zmq::send_flags::none);
 
-        // Atribui um ID e armazena o socket
-        int socket_id = g_next_socket_id++;
-        g_sockets[socket_id] = std::move(socket);
+        if (!data_result.has_value())
+        {
+            set_last_error("Failed to send data");
+            return ZMQ_BRIDGE_ERROR_SEND;
+        }
 
-        return socket_id;
+        return ZMQ_BRIDGE_OK;
     } catch (const zmq::error_t& e)
     {
-        set_last_error("Failed to create publisher socket: "
-                       + std::string(e.what()));
-        return ZMQ_BRIDGE_ERROR_SOCKET;
+        set_last_error("Publish error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_SEND;
     }
 }
 
- 
-EXPORT_API int zmq_bridge_create_subscriber(const char* endpoint,
-                                            const char* topic)
+// Envia [tópico][dados] (ou só [dados] se topic for NULL) num socket bloqueado
+static int publish_locked(SocketLock& lock, const char* topic, const void* data,
+                          int size)
 {
-    if (!g_context)
+    if (size < 0 || (size > 0 && !data))
     {
-        set_last_error("ZeroMQ context not initialized");
-        return ZMQ_BRIDGE_ERROR_INIT;
+        set_last_error("Invalid data");
+        return ZMQ_BRIDGE_ERROR_SEND;
     }
 
-    try
-    {
-        std::lock_guard<std::mutex> lock(g_mutex);
-
-        auto socket =
-            std::make_unique<zmq::socket_t>(*g_context, zmq::socket_type::sub);
-
-        // Configura o socket
-        int linger = 0;
-        socket->set(zmq::sockopt::linger, linger);
-
-        // Define o tópico de inscrição
-        socket->set(zmq::sockopt::subscribe, topic);
+    zmq::message_t data_msg =
+        BufferPool::Instance().CopyMessage(data, static_cast<size_t>(size));
+    return publish_message_locked(lock, topic, data_msg);
+}
 
-        // Conecta ao endpoint
-        socket->connect(endpoint);
 
-        // Atribui um ID e armazena o socket
-        int socket_id = g_next_socket_id++;
-        g_sockets[socket_id] = std::move(socket);
+EXPORT_API int zmq_bridge_init()
+{
+    try
+    {
+        if (!Context::Instance().Initialize())
+        {
+            return ZMQ_BRIDGE_ERROR_INIT;
+        }
 
-        return socket_id;
-    } catch (const zmq::error_t& e)
+        return ZMQ_BRIDGE_OK;
+    } catch (const std::exception& e)
     {
-        set_last_error("Failed to create subscriber socket: "
+        set_last_error("General error during initialization: "
                        + std::string(e.what()));
-        return ZMQ_BRIDGE_ERROR_SOCKET;
+        return ZMQ_BRIDGE_ERROR_INIT;
     }
 }
 
- 
-EXPORT_API int zmq_bridge_create_request(const char* endpoint)
+
+EXPORT_API void zmq_bridge_config_init(zmq_bridge_config* config)
+{
+    config->io_threads = -1;
+    config->max_sockets = -1;
+    config->thread_sched_policy = -1;
+    config->thread_priority = -1;
+    config->affinity_cpus = nullptr;
+    config->affinity_cpu_count = 0;
+}
+
+
+EXPORT_API int zmq_bridge_init_ex(zmq_bridge_config* config)
 {
-    if (!g_context)
+    try
     {
-        set_last_error("ZeroMQ context not initialized");
+        if (!Context::Instance().Initialize(config))
+        {
+            return ZMQ_BRIDGE_ERROR_INIT;
+        }
+
+        if (config)
+        {
+            Context::Instance().GetEffectiveConfig(*config);
+        }
+
+        return ZMQ_BRIDGE_OK;
+    } catch (const std::exception& e)
+    {
+        set_last_error("General error during initialization: "
+                       + std::string(e.what()));
         return ZMQ_BRIDGE_ERROR_INIT;
     }
+}
 
-    try
-    {
-        std::lock_guard<std::mutex> lock(g_mutex);
 
-        auto socket =
-            std::make_unique<zmq::socket_t>(*g_context, zmq::socket_type::req);
+EXPORT_API void zmq_bridge_shutdown()
+{
+    Context::Instance().Shutdown();
+}
 
-        // Configura o socket
-        int linger = 0;
-        socket->set(zmq::sockopt::linger, linger);
 
-        // Conecta ao endpoint
-        socket->connect(endpoint);
+EXPORT_API int zmq_bridge_create_publisher(const char* endpoint)
+{
+    return create_socket(zmq::socket_type::pub, endpoint, true);
+}
 
-        // Atribui um ID e armazena o socket
-        int socket_id = g_next_socket_id++;
-        g_sockets[socket_id] = std::move(socket);
 
-        return socket_id;
-    } catch (const zmq::error_t& e)
+EXPORT_API int zmq_bridge_create_subscriber(const char* endpoint,
+                                            const char* topic)
+{
+    if (!check_context())
     {
-        set_last_error("Failed to create request socket: "
-                       + std::string(e.what()));
-        return ZMQ_BRIDGE_ERROR_SOCKET;
+        return ZMQ_BRIDGE_ERROR_INIT;
     }
+
+    int socket_id =
+        Context::Instance().GetSocketManager().CreateSubscriber(endpoint, topic);
+
+    return socket_id < 0 ? ZMQ_BRIDGE_ERROR_SOCKET : socket_id;
 }
 
- 
-EXPORT_API int zmq_bridge_create_reply(const char* endpoint)
+
+EXPORT_API int zmq_bridge_create_subscriber_conflate(const char* endpoint,
+                                                     const char* topic)
 {
-    if (!g_context)
+    if (!check_context())
     {
-        set_last_error("ZeroMQ context not initialized");
         return ZMQ_BRIDGE_ERROR_INIT;
     }
 
-    try
-    {
-        std::lock_guard<std::mutex> lock(g_mutex);
+    int socket_id = Context::Instance().GetSocketManager().CreateSubscriber(
+        endpoint, topic, true);
 
-        auto socket =
-            std::make_unique<zmq::socket_t>(*g_context, zmq::socket_type::rep);
+    return socket_id < 0 ? ZMQ_BRIDGE_ERROR_SOCKET : socket_id;
+}
 
-        // Configura o socket
-        int linger = 0;
-        socket->set(zmq::sockopt::linger, linger);
 
-        // Vincula ao endpoint
-        socket->bind(endpoint);
+EXPORT_API int zmq_bridge_create_request(const char* endpoint)
+{
+    return create_socket(zmq::socket_type::req, endpoint, false);
+}
 
-        // Atribui um ID e armazena o socket
-        int socket_id = g_next_socket_id++;
-        g_sockets[socket_id] = std::move(socket);
 
-        return socket_id;
-    } catch (const zmq::error_t& e)
-    {
-        set_last_error("Failed to create reply socket: "
-                       + std::string(e.what()));
-        return ZMQ_BRIDGE_ERROR_SOCKET;
-    }
+EXPORT_API int zmq_bridge_create_reply(const char* endpoint)
+{
+    return create_socket(zmq::socket_type::rep, endpoint, true);
 }
 
- 
+
 EXPORT_API int zmq_bridge_create_push(const char* endpoint)
 {
-    if (!g_context)
-    {
-        set_last_error("ZeroMQ context not initialized");
-        return ZMQ_BRIDGE_ERROR_INIT;
-    }
+    return create_socket(zmq::socket_type::push, endpoint, false);
+}
 
-    try
-    {
-        std::lock_guard<std::mutex> lock(g_mutex);
 
-        auto socket =
-            std::make_unique<zmq::socket_t>(*g_context, zmq::socket_type::push);
+EXPORT_API int zmq_bridge_create_pull(const char* endpoint)
+{
+    return create_socket(zmq::socket_type::pull, endpoint, true);
+}
+
 
-        // Configura o socket
-        int linger = 0;
-        socket->set(zmq::sockopt::linger, linger);
+EXPORT_API void zmq_bridge_socket_options_init(zmq_bridge_socket_options* options)
+{
+    zmq_bridge::internal::InitSocketOptions(*options);
+}
 
-        // Conecta ao endpoint
-        socket->connect(endpoint);
 
-        // Atribui um ID e armazena o socket
-        int socket_id = g_next_socket_id++;
-        g_sockets[socket_id] = std::move(socket);
+EXPORT_API int zmq_bridge_create_socket_ex(int socket_type, const char* endpoint,
+                                           int bind,
+                                           const zmq_bridge_socket_options* options,
+                                           const char* topic)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
 
-        return socket_id;
-    } catch (const zmq::error_t& e)
+    zmq::socket_type type;
+    switch (socket_type)
     {
-        set_last_error("Failed to create push socket: "
-                       + std::string(e.what()));
+    case ZMQ_BRIDGE_SOCKET_PUB: type = zmq::socket_type::pub; break;
+    case ZMQ_BRIDGE_SOCKET_SUB: type = zmq::socket_type::sub; break;
+    case ZMQ_BRIDGE_SOCKET_REQ: type = zmq::socket_type::req; break;
+    case ZMQ_BRIDGE_SOCKET_REP: type = zmq::socket_type::rep; break;
+    case ZMQ_BRIDGE_SOCKET_PUSH: type = zmq::socket_type::push; break;
+    case ZMQ_BRIDGE_SOCKET_PULL: type = zmq::socket_type::pull; break;
+    case ZMQ_BRIDGE_SOCKET_DEALER: type = zmq::socket_type::dealer; break;
+    case ZMQ_BRIDGE_SOCKET_ROUTER: type = zmq::socket_type::router; break;
+    default:
+        set_last_error("Invalid socket type");
         return ZMQ_BRIDGE_ERROR_SOCKET;
     }
+
+    std::string subscription = topic ? topic : "";
+
+    int socket_id = Context::Instance().GetSocketManager().CreateSocket(
+        type, endpoint, bind != 0, options,
+        type == zmq::socket_type::sub ? &subscription : nullptr);
+
+    return socket_id < 0 ? ZMQ_BRIDGE_ERROR_SOCKET : socket_id;
 }
 
- 
-EXPORT_API int zmq_bridge_create_pull(const char* endpoint)
+
+EXPORT_API int zmq_bridge_set_option(int socket_id, int option, long long value)
 {
-    if (!g_context)
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
     {
-        set_last_error("ZeroMQ context not initialized");
-        return ZMQ_BRIDGE_ERROR_INIT;
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
     }
 
     try
     {
-        std::lock_guard<std::mutex> lock(g_mutex);
-
-        auto socket =
-            std::make_unique<zmq::socket_t>(*g_context, zmq::socket_type::pull);
+        return zmq_bridge::internal::SetSocketOption(lock.Socket(), option, value)
+            ? ZMQ_BRIDGE_OK
+            : ZMQ_BRIDGE_ERROR_OPTION;
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("Failed to set socket option: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_OPTION;
+    }
+}
 
-        // Configura o socket
-        int linger = 0;
-        socket->set(zmq::sockopt::linger, linger);
 
-        // Vincula ao endpoint
-        socket->bind(endpoint);
+EXPORT_API int zmq_bridge_get_option(int socket_id, int option, long long* value)
+{
+    *value = 0;
 
-        // Atribui um ID e armazena o socket
-        int socket_id = g_next_socket_id++;
-        g_sockets[socket_id] = std::move(socket);
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
 
-        return socket_id;
+    try
+    {
+        return zmq_bridge::internal::GetSocketOption(lock.Socket(), option, *value)
+            ? ZMQ_BRIDGE_OK
+            : ZMQ_BRIDGE_ERROR_OPTION;
     } catch (const zmq::error_t& e)
     {
-        set_last_error("Failed to create pull socket: "
-                       + std::string(e.what()));
-        return ZMQ_BRIDGE_ERROR_SOCKET;
+        set_last_error("Failed to get socket option: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_OPTION;
     }
 }
 
- 
+
 EXPORT_API int zmq_bridge_send(int socket_id, const void* data, int size)
 {
-    if (!g_context)
+    if (!check_context())
     {
-        set_last_error("ZeroMQ context not initialized");
         return ZMQ_BRIDGE_ERROR_INIT;
     }
 
-    std::lock_guard<std::mutex> lock(g_mutex);
+    if (size < 0 || (size > 0 && !data))
+    {
+        set_last_error("Invalid data");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
 
-    auto it = g_sockets.find(socket_id);
-    if (it == g_sockets.end())
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
     {
-        set_last_error("Invalid socket ID");
         return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
     }
 
     try
     {
-        zmq::message_t message(data, size);
-        auto result = it->second->send(message, zmq::send_flags::none);
+        zmq::message_t message =
+            BufferPool::Instance().CopyMessage(data, static_cast<size_t>(size));
+        auto result = lock.State().Send(message, zmq::send_flags::none);
 
         if (!result.has_value())
         {
@@ -329,117 +393,326 @@ EXPORT_API int zmq_bridge_send(int socket_id, const void* data, int size)
     }
 }
 
- 
+
 EXPORT_API int zmq_bridge_send_string(int socket_id, const char* message)
 {
+    if (!message)
+    {
+        set_last_error("Invalid data");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
     return zmq_bridge_send(socket_id, message,
                            static_cast<int>(strlen(message)));
 }
 
- 
+
 EXPORT_API int zmq_bridge_publish(int socket_id, const char* topic,
                                   const void* data, int size)
 {
-    if (!g_context)
+    if (!check_context())
     {
-        set_last_error("ZeroMQ context not initialized");
         return ZMQ_BRIDGE_ERROR_INIT;
     }
 
-    std::lock_guard<std::mutex> lock(g_mutex);
-
-    auto it = g_sockets.find(socket_id);
-    if (it == g_sockets.end())
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
     {
-        set_last_error("Invalid socket ID");
         return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
     }
 
-    try
+    return publish_locked(lock, topic, data, size);
+}
+
+
+EXPORT_API int zmq_bridge_send_multipart(int socket_id, const void* data,
+                                         const int* frame_sizes,
+                                         int frame_count)
+{
+    if (!check_context())
     {
-        // Envia o tópico
-        zmq::message_t topic_msg(topic, strlen(topic));
-        auto topic_result =
-            it->second->send(topic_msg, zmq::send_flags::sndmore);
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
 
-        if (!topic_result.has_value())
+    if (frame_count <= 0)
+    {
+        set_last_error("Multipart message needs at least one frame");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    for (int i = 0; i < frame_count; ++i)
+    {
+        if (frame_sizes[i] < 0 || (frame_sizes[i] > 0 && !data))
         {
-            set_last_error("Failed to send topic");
+            set_last_error("Invalid frame size");
             return ZMQ_BRIDGE_ERROR_SEND;
         }
+    }
 
-        // Envia os dados
-        zmq::message_t data_msg(data, size);
-        auto data_result = it->second->send(data_msg, zmq::send_flags::none);
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
 
-        if (!data_result.has_value())
+    const char* frame = static_cast<const char*>(data);
+
+    try
+    {
+        for (int i = 0; i < frame_count; ++i)
         {
-            set_last_error("Failed to send data");
-            return ZMQ_BRIDGE_ERROR_SEND;
+            zmq::message_t message = BufferPool::Instance().CopyMessage(
+                frame, static_cast<size_t>(frame_sizes[i]));
+            frame += frame_sizes[i];
+
+            auto flags = i + 1 < frame_count ? zmq::send_flags::sndmore
+                                             : zmq::send_flags::none;
+            if (!lock.State().Send(message, flags).has_value())
+            {
+                set_last_error("Failed to send frame");
+                return ZMQ_BRIDGE_ERROR_SEND;
+            }
         }
 
         return ZMQ_BRIDGE_OK;
     } catch (const zmq::error_t& e)
     {
-        set_last_error("Publish error: " + std::string(e.what()));
+        set_last_error("Send error: " + std::string(e.what()));
         return ZMQ_BRIDGE_ERROR_SEND;
     }
 }
 
- 
-EXPORT_API int zmq_bridge_receive(int socket_id, void* buffer, int buffer_size,
-                                  int* bytes_received)
+
+EXPORT_API int zmq_bridge_publish_batch(const zmq_bridge_publish_item* items,
+                                        int count, int* items_sent)
 {
-    if (!g_context)
+    *items_sent = 0;
+
+    if (!check_context())
     {
-        set_last_error("ZeroMQ context not initialized");
         return ZMQ_BRIDGE_ERROR_INIT;
     }
 
-    std::lock_guard<std::mutex> lock(g_mutex);
-
-    auto it = g_sockets.find(socket_id);
-    if (it == g_sockets.end())
-    {
-        set_last_error("Invalid socket ID");
-        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
-    }
+    auto& manager = Context::Instance().GetSocketManager();
 
-    try
+    int i = 0;
+    while (i < count)
     {
-        zmq::message_t message;
-        auto result = it->second->recv(message, zmq::recv_flags::dontwait);
-
-        if (!result.has_value())
+        // Itens consecutivos do mesmo socket partilham o mesmo lock
+        int socket_id = items[i].socket_id;
+        SocketLock lock = manager.Acquire(socket_id);
+        if (!lock)
         {
-            // Não há mensagem disponível
-            *bytes_received = 0;
-            return ZMQ_BRIDGE_NO_MESSAGE;
+            return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
         }
 
-        // Copia os dados para o buffer
-        size_t bytes_to_copy =
-            std::min(static_cast<size_t>(buffer_size), message.size());
-        memcpy(buffer, message.data(), bytes_to_copy);
-        *bytes_received = static_cast<int>(bytes_to_copy);
+        for (; i < count && items[i].socket_id == socket_id; ++i)
+        {
+            const zmq_bridge_publish_item& item = items[i];
 
-        return ZMQ_BRIDGE_OK;
-    } catch (const zmq::error_t& e)
-    {
-        set_last_error("Receive error: " + std::string(e.what()));
-        return ZMQ_BRIDGE_ERROR_RECEIVE;
+            int result = publish_locked(lock, item.topic, item.data, item.size);
+            if (result != ZMQ_BRIDGE_OK)
+            {
+                return result;
+            }
+
+            ++*items_sent;
+        }
     }
+
+    return ZMQ_BRIDGE_OK;
 }
 
- 
-EXPORT_API int zmq_bridge_receive_string(int socket_id, char* buffer,
-                                         int buffer_size)
-{
-    int bytes_received = 0;
-    int result =
-        zmq_bridge_receive(socket_id, buffer, buffer_size - 1, &bytes_received);
 
-    if (result == ZMQ_BRIDGE_OK)
+EXPORT_API void* zmq_bridge_alloc_buffer(int size)
+{
+    if (size < 0)
+    {
+        set_last_error("Invalid buffer size");
+        return nullptr;
+    }
+
+    void* buffer = BufferPool::Instance().Allocate(static_cast<size_t>(size));
+    if (!buffer)
+    {
+        set_last_error("Failed to allocate buffer");
+    }
+
+    return buffer;
+}
+
+
+EXPORT_API void zmq_bridge_free_buffer(void* buffer)
+{
+    BufferPool::Instance().Release(buffer);
+}
+
+
+EXPORT_API void zmq_bridge_get_pool_stats(zmq_bridge_pool_stats* stats)
+{
+    BufferPool::Instance().GetStats(*stats);
+}
+
+
+EXPORT_API void zmq_bridge_pool_trim()
+{
+    BufferPool::Instance().Trim();
+}
+
+
+EXPORT_API int zmq_bridge_send_zero_copy(int socket_id, void* data, int size,
+                                         zmq_bridge_free_fn free_fn,
+                                         void* hint)
+{
+    // A mensagem passa a ser dona do buffer, mesmo nos retornos de erro
+    zmq::message_t message;
+    if (!make_zero_copy_message(message, data, size, free_fn, hint))
+    {
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    try
+    {
+        auto result = lock.State().Send(message, zmq::send_flags::none);
+
+        if (!result.has_value())
+        {
+            set_last_error("Failed to send message");
+            return ZMQ_BRIDGE_ERROR_SEND;
+        }
+
+        return ZMQ_BRIDGE_OK;
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("Send error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+}
+
+
+EXPORT_API int zmq_bridge_publish_zero_copy(int socket_id, const char* topic,
+                                            void* data, int size,
+                                            zmq_bridge_free_fn free_fn,
+                                            void* hint)
+{
+    // A mensagem passa a ser dona do buffer, mesmo nos retornos de erro
+    zmq::message_t data_msg;
+    if (!make_zero_copy_message(data_msg, data, size, free_fn, hint))
+    {
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    if (!topic)
+    {
+        set_last_error("Invalid topic");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    try
+    {
+        // Envia o tópico (pequeno, copiado)
+        zmq::message_t topic_msg(topic, strlen(topic));
+        auto topic_result =
+            lock.State().Send(topic_msg, zmq::send_flags::sndmore);
+
+        if (!topic_result.has_value())
+        {
+            set_last_error("Failed to send topic");
+            return ZMQ_BRIDGE_ERROR_SEND;
+        }
+
+        // Envia os dados sem cópia
+        auto data_result = lock.State().Send(data_msg, zmq::send_flags::none);
+
+        if (!data_result.has_value())
+        {
+            set_last_error("Failed to send data");
+            return ZMQ_BRIDGE_ERROR_SEND;
+        }
+
+        return ZMQ_BRIDGE_OK;
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("Publish error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+}
+
+
+EXPORT_API int zmq_bridge_receive(int socket_id, void* buffer, int buffer_size,
+                                  int* bytes_received)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    try
+    {
+        zmq::message_t message;
+        if (!lock.State().Receive(message, zmq::recv_flags::dontwait))
+        {
+            // Não há mensagem disponível
+            *bytes_received = 0;
+            return ZMQ_BRIDGE_NO_MESSAGE;
+        }
+
+        // Copia os dados para o buffer
+        size_t bytes_to_copy =
+            std::min(static_cast<size_t>(buffer_size), message.size());
+        if (bytes_to_copy < message.size())
+        {
+            lock.State().stats.truncated.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        memcpy(buffer, message.data(), bytes_to_copy);
+        *bytes_received = static_cast<int>(bytes_to_copy);
+
+        return ZMQ_BRIDGE_OK;
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("Receive error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_RECEIVE;
+    }
+}
+
+
+EXPORT_API int zmq_bridge_receive_string(int socket_id, char* buffer,
+                                         int buffer_size)
+{
+    int bytes_received = 0;
+    int result =
+        zmq_bridge_receive(socket_id, buffer, buffer_size - 1, &bytes_received);
+
+    if (result == ZMQ_BRIDGE_OK)
     {
         // Adiciona terminador nulo
         buffer[bytes_received] = '\0';
@@ -448,87 +721,2035 @@ EXPORT_API int zmq_bridge_receive_string(int socket_id, char* buffer,
     return result;
 }
 
- 
-EXPORT_API int zmq_bridge_check_message(int socket_id)
+
+EXPORT_API int zmq_bridge_peek_size(int socket_id, int* size)
 {
-    if (!g_context)
+    *size = 0;
+
+    if (!check_context())
     {
-        set_last_error("ZeroMQ context not initialized");
         return ZMQ_BRIDGE_ERROR_INIT;
     }
 
-    std::lock_guard<std::mutex> lock(g_mutex);
-
-    auto it = g_sockets.find(socket_id);
-    if (it == g_sockets.end())
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
     {
-        set_last_error("Invalid socket ID");
         return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
     }
 
     try
     {
-        zmq::pollitem_t items[] = { { it->second->handle(), 0, ZMQ_POLLIN,
-                                      0 } };
+        zmq::message_t message;
+        if (!lock.State().Receive(message, zmq::recv_flags::dontwait))
+        {
+            // Não há mensagem disponível
+            return ZMQ_BRIDGE_NO_MESSAGE;
+        }
 
-        zmq::poll(&items[0], 1, std::chrono::milliseconds(0));
+        // Fica pendente para o próximo receive
+        *size = static_cast<int>(std::min(message.size(), static_cast<size_t>(INT_MAX)));
+        lock.State().Unread(std::move(message));
 
-        return (items[0].revents & ZMQ_POLLIN) ? 1 : 0;
+        return ZMQ_BRIDGE_OK;
     } catch (const zmq::error_t& e)
     {
-        set_last_error("Poll error: " + std::string(e.what()));
+        set_last_error("Receive error: " + std::string(e.what()));
         return ZMQ_BRIDGE_ERROR_RECEIVE;
     }
 }
 
- 
-EXPORT_API int zmq_bridge_poll(int socket_id, int timeout_ms)
+
+EXPORT_API int zmq_bridge_receive_ex(int socket_id, void* buffer,
+                                     int buffer_size, int options,
+                                     int* message_size, int* flags)
 {
-    if (!g_context)
+    *message_size = 0;
+    *flags = 0;
+
+    if (!check_context())
     {
-        set_last_error("ZeroMQ context not initialized");
         return ZMQ_BRIDGE_ERROR_INIT;
     }
 
-    std::lock_guard<std::mutex> lock(g_mutex);
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
 
-    auto it = g_sockets.find(socket_id);
-    if (it == g_sockets.end())
+    try
+    {
+        zmq::message_t message;
+        if (!lock.State().Receive(message, zmq::recv_flags::dontwait))
+        {
+            // Não há mensagem disponível
+            return ZMQ_BRIDGE_NO_MESSAGE;
+        }
+
+        size_t size = message.size();
+        size_t capacity = buffer_size > 0 ? static_cast<size_t>(buffer_size) : 0;
+
+        *message_size = static_cast<int>(std::min(size, static_cast<size_t>(INT_MAX)));
+        *flags = message.more() ? ZMQ_BRIDGE_MSG_MORE : 0;
+
+        if (size > capacity)
+        {
+            if (!(options & ZMQ_BRIDGE_RECV_TRUNCATE))
+            {
+                // O chamador aumenta o buffer e tenta de novo
+                lock.State().Unread(std::move(message));
+                set_last_error("Buffer too small for message");
+                return ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL;
+            }
+
+            size = capacity;
+            *flags |= ZMQ_BRIDGE_MSG_TRUNCATED;
+            lock.State().stats.truncated.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (size > 0)
+        {
+            memcpy(buffer, message.data(), size);
+        }
+
+        return ZMQ_BRIDGE_OK;
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("Receive error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_RECEIVE;
+    }
+}
+
+
+EXPORT_API int zmq_bridge_receive_borrowed(int socket_id, void** message,
+                                           const void** data, int* size)
+{
+    *message = nullptr;
+    *data = nullptr;
+    *size = 0;
+
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
     {
-        set_last_error("Invalid socket ID");
         return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
     }
 
     try
     {
-        zmq::pollitem_t items[] = { { it->second->handle(), 0, ZMQ_POLLIN,
-                                      0 } };
+        // Os objetos de mensagem vêm do pool; voltam lá se não houver mensagem
+        std::unique_ptr<zmq::message_t, void (*)(zmq::message_t*)> borrowed(
+            BufferPool::Instance().AcquireHandle(), [](zmq::message_t* unused) {
+                BufferPool::Instance().ReleaseHandle(unused);
+            });
+        if (!lock.State().Receive(*borrowed, zmq::recv_flags::dontwait))
+        {
+            // Não há mensagem disponível
+            return ZMQ_BRIDGE_NO_MESSAGE;
+        }
 
-        zmq::poll(&items[0], 1, std::chrono::milliseconds(timeout_ms));
+        // O chamador lê diretamente do buffer do libzmq até libertar a mensagem
+        *data = borrowed->data();
+        *size = static_cast<int>(borrowed->size());
+        *message = borrowed.release();
 
-        return (items[0].revents & ZMQ_POLLIN) ? 1 : 0;
+        return ZMQ_BRIDGE_OK;
     } catch (const zmq::error_t& e)
     {
-        set_last_error("Poll error: " + std::string(e.what()));
+        set_last_error("Receive error: " + std::string(e.what()));
         return ZMQ_BRIDGE_ERROR_RECEIVE;
     }
 }
 
- 
-EXPORT_API void zmq_bridge_close_socket(int socket_id)
+
+EXPORT_API void zmq_bridge_release_message(void* message)
+{
+    BufferPool::Instance().ReleaseHandle(static_cast<zmq::message_t*>(message));
+}
+
+
+EXPORT_API int zmq_bridge_receive_batch(int socket_id, void* buffer,
+                                        int buffer_size,
+                                        zmq_bridge_batch_entry* entries,
+                                        int max_messages,
+                                        int* messages_received)
+{
+    *messages_received = 0;
+
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    char* out = static_cast<char*>(buffer);
+    size_t capacity = buffer_size > 0 ? static_cast<size_t>(buffer_size) : 0;
+    size_t used = 0;
+    int count = 0;
+
+    try
+    {
+        zmq::message_t message;
+        while (count < max_messages
+               && lock.State().Receive(message, zmq::recv_flags::dontwait))
+        {
+            size_t size = message.size();
+            int flags = message.more() ? ZMQ_BRIDGE_MSG_MORE : 0;
+
+            if (size > capacity - used)
+            {
+                if (count > 0)
+                {
+                    // Fica para a próxima chamada
+                    lock.State().Unread(std::move(message));
+                    break;
+                }
+
+                // Nem sozinho cabe no buffer: entrega truncado
+                size = capacity;
+                flags |= ZMQ_BRIDGE_MSG_TRUNCATED;
+                lock.State().stats.truncated.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            memcpy(out + used, message.data(), size);
+
+            entries[count].offset = static_cast<int>(used);
+            entries[count].size = static_cast<int>(size);
+            entries[count].flags = flags;
+
+            used += size;
+            ++count;
+        }
+    } catch (const zmq::error_t& e)
+    {
+        // Entrega o que já foi copiado; o erro aparece na próxima chamada
+        if (count == 0)
+        {
+            set_last_error("Receive error: " + std::string(e.what()));
+            return ZMQ_BRIDGE_ERROR_RECEIVE;
+        }
+    }
+
+    *messages_received = count;
+    return count > 0 ? ZMQ_BRIDGE_OK : ZMQ_BRIDGE_NO_MESSAGE;
+}
+
+
+// Devolve os frames já lidos para os pendentes, pela ordem original
+static void unread_message_frames(SocketLock& lock, std::vector<zmq::message_t>& frames)
+{
+    while (!frames.empty())
+    {
+        lock.State().Unread(std::move(frames.back()));
+        frames.pop_back();
+    }
+}
+
+
+// Lê todos os frames da próxima mensagem para frames. Devolve false se não
+// houver mensagem; em caso de erro, os frames já lidos voltam aos pendentes.
+static bool receive_message_frames(SocketLock& lock, std::vector<zmq::message_t>& frames)
 {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    try
+    {
+        zmq::message_t message;
+        if (!lock.State().Receive(message, zmq::recv_flags::dontwait))
+        {
+            return false;
+        }
+
+        // O ZeroMQ entrega os frames de uma mensagem todos juntos, por isso
+        // os seguintes já estão disponíveis
+        bool more = message.more();
+        frames.push_back(std::move(message));
 
-    auto it = g_sockets.find(socket_id);
-    if (it != g_sockets.end())
+        while (more)
+        {
+            zmq::message_t next;
+            if (!lock.State().Receive(next, zmq::recv_flags::dontwait))
+            {
+                break;
+            }
+
+            more = next.more();
+            frames.push_back(std::move(next));
+        }
+    } catch (const zmq::error_t&)
     {
-        g_sockets.erase(it);
+        unread_message_frames(lock, frames);
+        throw;
     }
+
+    return true;
 }
 
- 
-EXPORT_API const char* zmq_bridge_get_last_error()
+
+EXPORT_API int zmq_bridge_receive_multipart(int socket_id, void* buffer,
+                                            int buffer_size, int* frame_sizes,
+                                            int max_frames, int* frame_count,
+                                            int* total_size)
 {
-    std::lock_guard<std::mutex> lock(g_mutex);
-    return g_last_error.c_str();
+    *frame_count = 0;
+    *total_size = 0;
+
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    // Reutilizado entre chamadas da mesma thread
+    static thread_local std::vector<zmq::message_t> frames;
+    frames.clear();
+
+    try
+    {
+        if (!receive_message_frames(lock, frames))
+        {
+            // Não há mensagem disponível
+            return ZMQ_BRIDGE_NO_MESSAGE;
+        }
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("Receive error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_RECEIVE;
+    }
+
+    size_t total = 0;
+    for (const auto& frame : frames)
+    {
+        total += frame.size();
+    }
+
+    *frame_count = static_cast<int>(frames.size());
+    *total_size = static_cast<int>(std::min(total, static_cast<size_t>(INT_MAX)));
+
+    if (*frame_count > max_frames || total > static_cast<size_t>(std::max(buffer_size, 0)))
+    {
+        unread_message_frames(lock, frames);
+        set_last_error("Buffer too small for multipart message");
+        return ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    char* out = static_cast<char*>(buffer);
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        if (frames[i].size() > 0)
+        {
+            memcpy(out, frames[i].data(), frames[i].size());
+        }
+
+        frame_sizes[i] = static_cast<int>(frames[i].size());
+        out += frames[i].size();
+    }
+
+    frames.clear();
+    return ZMQ_BRIDGE_OK;
+}
+
+
+static int set_subscription(int socket_id, const char* topic, bool subscribe)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    try
+    {
+        if (lock.Socket().get(zmq::sockopt::type) != ZMQ_SUB)
+        {
+            set_last_error("Socket is not a subscriber");
+            return ZMQ_BRIDGE_ERROR_SOCKET;
+        }
+
+        std::string subscription = topic ? topic : "";
+        if (subscribe)
+        {
+            lock.Socket().set(zmq::sockopt::subscribe, subscription);
+        }
+        else
+        {
+            lock.Socket().set(zmq::sockopt::unsubscribe, subscription);
+        }
+
+        return ZMQ_BRIDGE_OK;
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("Subscription error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_SOCKET;
+    }
+}
+
+
+EXPORT_API int zmq_bridge_subscribe(int socket_id, const char* topic)
+{
+    return set_subscription(socket_id, topic, true);
+}
+
+
+EXPORT_API int zmq_bridge_unsubscribe(int socket_id, const char* topic)
+{
+    return set_subscription(socket_id, topic, false);
+}
+
+
+EXPORT_API int zmq_bridge_topic_register(const char* topic)
+{
+    if (!topic)
+    {
+        set_last_error("Invalid topic");
+        return ZMQ_BRIDGE_ERROR_TOPIC;
+    }
+
+    int topic_id = Context::Instance().GetTopics().Register(topic);
+    return topic_id < 0 ? ZMQ_BRIDGE_ERROR_TOPIC : topic_id;
+}
+
+
+EXPORT_API int zmq_bridge_topic_name(int topic_id, char* buffer, int buffer_size)
+{
+    std::string topic;
+    if (!Context::Instance().GetTopics().Name(topic_id, topic))
+    {
+        return ZMQ_BRIDGE_ERROR_TOPIC;
+    }
+
+    if (topic.size() >= static_cast<size_t>(std::max(buffer_size, 0)))
+    {
+        set_last_error("Buffer too small for topic");
+        return ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    memcpy(buffer, topic.c_str(), topic.size() + 1);
+    return static_cast<int>(topic.size());
+}
+
+
+EXPORT_API int zmq_bridge_topic_match(const void* data, int size, int* topic_length)
+{
+    size_t length = 0;
+    int topic_id = Context::Instance().GetTopics().Match(
+        data, static_cast<size_t>(std::max(size, 0)), length);
+
+    *topic_length = static_cast<int>(length);
+    return topic_id < 0 ? ZMQ_BRIDGE_TOPIC_NONE : topic_id;
+}
+
+
+EXPORT_API int zmq_bridge_receive_topic(int socket_id, int* topic_id, void* buffer,
+                                        int buffer_size, int* message_size)
+{
+    *topic_id = ZMQ_BRIDGE_TOPIC_NONE;
+    *message_size = 0;
+
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    // Reutilizado entre chamadas da mesma thread
+    static thread_local std::vector<zmq::message_t> frames;
+    frames.clear();
+
+    try
+    {
+        if (!receive_message_frames(lock, frames))
+        {
+            // Não há mensagem disponível
+            return ZMQ_BRIDGE_NO_MESSAGE;
+        }
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("Receive error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_RECEIVE;
+    }
+
+    // O tópico é o primeiro frame ou, numa mensagem de um só frame
+    // (ZMQ_BRIDGE_LATEST_SINGLE_FRAME), o início desse frame
+    size_t length = 0;
+    int id = Context::Instance().GetTopics().Match(frames[0].data(), frames[0].size(), length);
+
+    size_t first = 0;
+    size_t skip = 0;
+    if (frames.size() > 1)
+    {
+        first = 1;
+    }
+    else if (id >= 0)
+    {
+        skip = length;
+    }
+
+    size_t total = 0;
+    for (size_t i = first; i < frames.size(); ++i)
+    {
+        total += frames[i].size();
+    }
+    total -= skip;
+
+    *message_size = static_cast<int>(std::min(total, static_cast<size_t>(INT_MAX)));
+
+    if (total > static_cast<size_t>(std::max(buffer_size, 0)))
+    {
+        unread_message_frames(lock, frames);
+        set_last_error("Buffer too small for message");
+        return ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    *topic_id = id < 0 ? ZMQ_BRIDGE_TOPIC_NONE : id;
+
+    char* out = static_cast<char*>(buffer);
+    for (size_t i = first; i < frames.size(); ++i)
+    {
+        size_t size = frames[i].size() - skip;
+        if (size > 0)
+        {
+            memcpy(out, static_cast<const char*>(frames[i].data()) + skip, size);
+        }
+
+        out += size;
+        skip = 0;
+    }
+
+    frames.clear();
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_create_rpc_client(const char* endpoint)
+{
+    return create_socket(zmq::socket_type::dealer, endpoint, false);
+}
+
+
+EXPORT_API int zmq_bridge_create_rpc_server(const char* endpoint)
+{
+    return create_socket(zmq::socket_type::router, endpoint, true);
+}
+
+
+// Estado RPC de um socket bloqueado, criado no primeiro uso; NULL (com o
+// último erro definido) se o socket não for do tipo socket_type
+template <typename T>
+static T* rpc_state(SocketLock& lock, std::unique_ptr<T>& state, int socket_type)
+{
+    if (!state)
+    {
+        try
+        {
+            if (lock.Socket().get(zmq::sockopt::type) != socket_type)
+            {
+                set_last_error(socket_type == ZMQ_DEALER ? "RPC client requires a DEALER socket"
+                                                         : "RPC server requires a ROUTER socket");
+                return nullptr;
+            }
+        } catch (const zmq::error_t& e)
+        {
+            set_last_error("Failed to query socket type: " + std::string(e.what()));
+            return nullptr;
+        }
+
+        state = std::make_unique<T>();
+    }
+
+    return state.get();
+}
+
+
+EXPORT_API int zmq_bridge_rpc_request(int socket_id, const void* data, int size,
+                                      int timeout_ms, long long* request_id)
+{
+    *request_id = 0;
+
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (size < 0 || (size > 0 && !data))
+    {
+        set_last_error("Invalid data");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    RpcClient* client = rpc_state(lock, lock.State().rpc_client, ZMQ_DEALER);
+    if (!client)
+    {
+        return ZMQ_BRIDGE_ERROR_SOCKET;
+    }
+
+    try
+    {
+        uint64_t id = 0;
+        int result = client->Request(lock.State(), data, static_cast<size_t>(size),
+                                     timeout_ms, id);
+        *request_id = static_cast<long long>(id);
+        return result;
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("RPC request error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+}
+
+
+EXPORT_API int zmq_bridge_rpc_receive_reply(int socket_id, long long* request_id,
+                                            void* buffer, int buffer_size,
+                                            int* reply_size)
+{
+    *request_id = 0;
+    *reply_size = 0;
+
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    RpcClient* client = rpc_state(lock, lock.State().rpc_client, ZMQ_DEALER);
+    if (!client)
+    {
+        return ZMQ_BRIDGE_ERROR_SOCKET;
+    }
+
+    try
+    {
+        uint64_t id = 0;
+        size_t size = 0;
+        int result = client->Receive(lock.State(), id,
+                                     buffer, buffer_size > 0 ? static_cast<size_t>(buffer_size) : 0,
+                                     size);
+        *request_id = static_cast<long long>(id);
+        *reply_size = static_cast<int>(std::min(size, static_cast<size_t>(INT_MAX)));
+        return result;
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("RPC receive error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_RECEIVE;
+    }
+}
+
+
+EXPORT_API int zmq_bridge_rpc_cancel(int socket_id, long long request_id)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    RpcClient* client = rpc_state(lock, lock.State().rpc_client, ZMQ_DEALER);
+    if (!client)
+    {
+        return ZMQ_BRIDGE_ERROR_SOCKET;
+    }
+
+    return client->Cancel(static_cast<uint64_t>(request_id))
+        ? ZMQ_BRIDGE_OK
+        : ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+}
+
+
+EXPORT_API int zmq_bridge_rpc_receive_request(int socket_id, long long* request_handle,
+                                              void* buffer, int buffer_size,
+                                              int* request_size)
+{
+    *request_handle = 0;
+    *request_size = 0;
+
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    RpcServer* server = rpc_state(lock, lock.State().rpc_server, ZMQ_ROUTER);
+    if (!server)
+    {
+        return ZMQ_BRIDGE_ERROR_SOCKET;
+    }
+
+    try
+    {
+        uint64_t handle = 0;
+        size_t size = 0;
+        int result = server->Receive(lock.State(), handle,
+                                     buffer, buffer_size > 0 ? static_cast<size_t>(buffer_size) : 0,
+                                     size);
+        *request_handle = static_cast<long long>(handle);
+        *request_size = static_cast<int>(std::min(size, static_cast<size_t>(INT_MAX)));
+        return result;
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("RPC receive error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_RECEIVE;
+    }
+}
+
+
+EXPORT_API int zmq_bridge_rpc_reply(int socket_id, long long request_handle,
+                                    const void* data, int size)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (size < 0 || (size > 0 && !data))
+    {
+        set_last_error("Invalid data");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    RpcServer* server = rpc_state(lock, lock.State().rpc_server, ZMQ_ROUTER);
+    if (!server)
+    {
+        return ZMQ_BRIDGE_ERROR_SOCKET;
+    }
+
+    try
+    {
+        return server->Reply(lock.State(), static_cast<uint64_t>(request_handle), data,
+                             static_cast<size_t>(size));
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("RPC reply error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+}
+
+
+EXPORT_API int zmq_bridge_check_message(int socket_id)
+{
+    return zmq_bridge_poll(socket_id, 0);
+}
+
+
+EXPORT_API int zmq_bridge_poll(int socket_id, int timeout_ms)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    // Frames já lidos e ainda não entregues contam como mensagem disponível
+    if (lock.State().HasPending())
+    {
+        return 1;
+    }
+
+    try
+    {
+        zmq::pollitem_t items[] = { { lock.Socket().handle(), 0, ZMQ_POLLIN,
+                                      0 } };
+
+        zmq::poll(&items[0], 1, std::chrono::milliseconds(timeout_ms));
+
+        return (items[0].revents & ZMQ_POLLIN) ? 1 : 0;
+    } catch (const zmq::error_t& e)
+    {
+        set_last_error("Poll error: " + std::string(e.what()));
+        return ZMQ_BRIDGE_ERROR_RECEIVE;
+    }
+}
+
+
+// Procura um poller pelo ID
+static Poller* find_poller(int poller_id)
+{
+    Poller* poller = Context::Instance().GetPollers().Lookup(poller_id);
+    if (!poller)
+    {
+        set_last_error("Invalid poller ID");
+    }
+
+    return poller;
+}
+
+
+EXPORT_API int zmq_bridge_poller_create()
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    auto& pollers = Context::Instance().GetPollers();
+
+    bool opened = false;
+    int poller_id = pollers.Insert([&](Poller& poller) { opened = poller.Open(); });
+
+    if (poller_id < 0)
+    {
+        set_last_error("Too many pollers");
+        return ZMQ_BRIDGE_ERROR_SOCKET;
+    }
+
+    if (!opened)
+    {
+        pollers.Remove(poller_id, [](Poller& poller) { poller.Close(); });
+        return ZMQ_BRIDGE_ERROR_SOCKET;
+    }
+
+    return poller_id;
+}
+
+
+EXPORT_API int zmq_bridge_poller_add(int poller_id, int socket_id, int events)
+{
+    Poller* poller = find_poller(poller_id);
+    if (!poller)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    if (!poller->Add(socket_id, events))
+    {
+        return Context::Instance().GetSocketManager().IsValid(socket_id)
+            ? ZMQ_BRIDGE_ERROR_SOCKET
+            : ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_poller_modify(int poller_id, int socket_id,
+                                        int events)
+{
+    Poller* poller = find_poller(poller_id);
+    if (!poller)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    return poller->Modify(socket_id, events) ? ZMQ_BRIDGE_OK
+                                             : ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+}
+
+
+EXPORT_API int zmq_bridge_poller_remove(int poller_id, int socket_id)
+{
+    Poller* poller = find_poller(poller_id);
+    if (!poller)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    return poller->Remove(socket_id) ? ZMQ_BRIDGE_OK
+                                     : ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+}
+
+
+EXPORT_API int zmq_bridge_poller_wait(int poller_id,
+                                      zmq_bridge_poll_event* events,
+                                      int max_events, int timeout_ms)
+{
+    Poller* poller = find_poller(poller_id);
+    if (!poller)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    int count = poller->Wait(events, max_events, timeout_ms);
+    return count < 0 ? ZMQ_BRIDGE_ERROR_RECEIVE : count;
+}
+
+
+EXPORT_API void zmq_bridge_poller_destroy(int poller_id)
+{
+    Context::Instance().GetPollers().Remove(
+        poller_id, [](Poller& poller) { poller.Close(); });
+}
+
+// Procura o canal do reactor de um socket; a referência mantém-no válido
+// mesmo que o socket seja desligado ou o reactor parado entretanto
+static std::shared_ptr<ReactorChannel> find_channel(int socket_id)
+{
+    std::shared_ptr<ReactorChannel> channel = Context::Instance().GetReactor().Find(socket_id);
+    if (!channel)
+    {
+        set_last_error("Socket not attached to reactor");
+    }
+
+    return channel;
+}
+
+
+EXPORT_API int zmq_bridge_reactor_start(int idle_timeout_ms)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    return Context::Instance().GetReactor().Start(idle_timeout_ms)
+        ? ZMQ_BRIDGE_OK
+        : ZMQ_BRIDGE_ERROR_INIT;
+}
+
+
+EXPORT_API void zmq_bridge_reactor_stop()
+{
+    Context::Instance().GetReactor().Stop();
+}
+
+
+EXPORT_API int zmq_bridge_reactor_attach(int socket_id, int queue_capacity)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    auto& reactor = Context::Instance().GetReactor();
+    if (!reactor.Attach(socket_id, queue_capacity))
+    {
+        return Context::Instance().GetSocketManager().IsValid(socket_id)
+            ? ZMQ_BRIDGE_ERROR_SOCKET
+            : ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_reactor_detach(int socket_id)
+{
+    return Context::Instance().GetReactor().Detach(socket_id)
+        ? ZMQ_BRIDGE_OK
+        : ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+}
+
+
+EXPORT_API int zmq_bridge_reactor_send(int socket_id, const void* data,
+                                       int size)
+{
+    if (size < 0 || (size > 0 && !data))
+    {
+        set_last_error("Invalid data");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    std::shared_ptr<ReactorChannel> channel = find_channel(socket_id);
+    if (!channel)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    ReactorFrame frame;
+    frame.message = BufferPool::Instance().CopyMessage(data, static_cast<size_t>(size));
+
+    std::lock_guard<std::mutex> lock(channel->send_mutex);
+    if (!channel->outgoing.TryPush(std::move(frame)))
+    {
+        set_last_error("Reactor send queue full");
+        return ZMQ_BRIDGE_ERROR_QUEUE_FULL;
+    }
+
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_reactor_publish(int socket_id, const char* topic,
+                                          const void* data, int size)
+{
+    if (!topic || size < 0 || (size > 0 && !data))
+    {
+        set_last_error("Invalid topic or data");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    std::shared_ptr<ReactorChannel> channel = find_channel(socket_id);
+    if (!channel)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    // Os dois frames entram juntos ou nenhum entra
+    std::lock_guard<std::mutex> lock(channel->send_mutex);
+    if (channel->outgoing.Free() < 2)
+    {
+        set_last_error("Reactor send queue full");
+        return ZMQ_BRIDGE_ERROR_QUEUE_FULL;
+    }
+
+    ReactorFrame topic_frame;
+    topic_frame.message = zmq::message_t(topic, strlen(topic));
+    topic_frame.more = true;
+    channel->outgoing.TryPush(std::move(topic_frame));
+
+    ReactorFrame data_frame;
+    data_frame.message = BufferPool::Instance().CopyMessage(data, static_cast<size_t>(size));
+    channel->outgoing.TryPush(std::move(data_frame));
+
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_reactor_receive(int socket_id, void* buffer,
+                                          int buffer_size,
+                                          int* bytes_received, int* flags)
+{
+    *bytes_received = 0;
+    *flags = 0;
+
+    std::shared_ptr<ReactorChannel> channel = find_channel(socket_id);
+    if (!channel)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    std::lock_guard<std::mutex> lock(channel->receive_mutex);
+    ReactorFrame* frame = channel->incoming.Front();
+    if (!frame)
+    {
+        return ZMQ_BRIDGE_NO_MESSAGE;
+    }
+
+    size_t size = frame->message.size();
+    size_t capacity = buffer_size > 0 ? static_cast<size_t>(buffer_size) : 0;
+    size_t bytes_to_copy = std::min(capacity, size);
+    memcpy(buffer, frame->message.data(), bytes_to_copy);
+
+    *bytes_received = static_cast<int>(bytes_to_copy);
+    *flags = (frame->more ? ZMQ_BRIDGE_MSG_MORE : 0)
+        | (bytes_to_copy < size ? ZMQ_BRIDGE_MSG_TRUNCATED : 0);
+
+    if (bytes_to_copy < size)
+    {
+        if (auto* state = Context::Instance().GetSocketManager().Find(socket_id))
+        {
+            state->stats.truncated.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    channel->incoming.Pop();
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_reactor_peek_size(int socket_id, int* size)
+{
+    *size = 0;
+
+    std::shared_ptr<ReactorChannel> channel = find_channel(socket_id);
+    if (!channel)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    std::lock_guard<std::mutex> lock(channel->receive_mutex);
+    ReactorFrame* frame = channel->incoming.Front();
+    if (!frame)
+    {
+        return ZMQ_BRIDGE_NO_MESSAGE;
+    }
+
+    *size = static_cast<int>(std::min(frame->message.size(), static_cast<size_t>(INT_MAX)));
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_set_callback(int socket_id,
+                                       zmq_bridge_message_callback fn,
+                                       void* user_data)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (!Context::Instance().GetDispatcher().SetCallback(socket_id, fn, user_data))
+    {
+        return Context::Instance().GetSocketManager().IsValid(socket_id)
+            ? ZMQ_BRIDGE_ERROR_SOCKET
+            : ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    return ZMQ_BRIDGE_OK;
+}
+
+
+// Procura um publicador "último valor" pelo ID
+static LatestPublisher* find_latest(int latest_id)
+{
+    LatestPublisher* latest =
+        Context::Instance().GetLatestPublishers().Lookup(latest_id);
+    if (!latest)
+    {
+        set_last_error("Invalid latest publisher ID");
+    }
+
+    return latest;
+}
+
+
+EXPORT_API int zmq_bridge_latest_create(int socket_id, int flags)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (!Context::Instance().GetSocketManager().IsValid(socket_id))
+    {
+        set_last_error("Invalid socket ID");
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    auto& publishers = Context::Instance().GetLatestPublishers();
+
+    bool started = false;
+    int latest_id = publishers.Insert([&](LatestPublisher& latest) {
+        started = latest.Start(socket_id, flags);
+    });
+
+    if (latest_id < 0)
+    {
+        set_last_error("Too many latest publishers");
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (!started)
+    {
+        publishers.Remove(latest_id, [](LatestPublisher& latest) { latest.Stop(); });
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    return latest_id;
+}
+
+
+EXPORT_API int zmq_bridge_latest_publish(int latest_id, const char* topic,
+                                         const void* data, int size)
+{
+    LatestPublisher* latest = find_latest(latest_id);
+    if (!latest)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    if (!topic || size < 0 || (size > 0 && !data))
+    {
+        set_last_error("Invalid topic or data");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    return latest->Publish(topic, data, static_cast<size_t>(size))
+        ? ZMQ_BRIDGE_OK
+        : ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+}
+
+
+EXPORT_API int zmq_bridge_latest_get_stats(int latest_id, const char* topic,
+                                           zmq_bridge_latest_stats* stats)
+{
+    LatestPublisher* latest = find_latest(latest_id);
+    if (!latest)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    latest->GetStats(topic, stats);
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API void zmq_bridge_latest_destroy(int latest_id)
+{
+    Context::Instance().GetLatestPublishers().Remove(
+        latest_id, [](LatestPublisher& latest) { latest.Stop(); });
+}
+
+
+// Procura um scheduler pelo ID
+static Scheduler* find_scheduler(int scheduler_id)
+{
+    Scheduler* scheduler = Context::Instance().GetSchedulers().Lookup(scheduler_id);
+    if (!scheduler)
+    {
+        set_last_error("Invalid scheduler ID");
+    }
+
+    return scheduler;
+}
+
+
+EXPORT_API int zmq_bridge_scheduler_create(int socket_id)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (!Context::Instance().GetSocketManager().IsValid(socket_id))
+    {
+        set_last_error("Invalid socket ID");
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    auto& schedulers = Context::Instance().GetSchedulers();
+
+    bool started = false;
+    int scheduler_id = schedulers.Insert([&](Scheduler& scheduler) {
+        started = scheduler.Start(socket_id);
+    });
+
+    if (scheduler_id < 0)
+    {
+        set_last_error("Too many schedulers");
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (!started)
+    {
+        schedulers.Remove(scheduler_id, [](Scheduler& scheduler) { scheduler.Stop(); });
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    return scheduler_id;
+}
+
+
+EXPORT_API int zmq_bridge_scheduler_add_topic(int scheduler_id, const char* topic,
+                                              double rate_hz, int flags)
+{
+    Scheduler* scheduler = find_scheduler(scheduler_id);
+    if (!scheduler)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    if (!topic)
+    {
+        set_last_error("Invalid topic");
+        return ZMQ_BRIDGE_ERROR_TOPIC;
+    }
+
+    return scheduler->AddTopic(topic, rate_hz, flags) ? ZMQ_BRIDGE_OK
+                                                      : ZMQ_BRIDGE_ERROR_TOPIC;
+}
+
+
+EXPORT_API int zmq_bridge_scheduler_publish(int scheduler_id, const char* topic,
+                                            const void* data, int size)
+{
+    Scheduler* scheduler = find_scheduler(scheduler_id);
+    if (!scheduler)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    if (!topic || size < 0 || (size > 0 && !data))
+    {
+        set_last_error("Invalid topic or data");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    return scheduler->Publish(topic, data, static_cast<size_t>(size));
+}
+
+
+EXPORT_API int zmq_bridge_scheduler_get_stats(int scheduler_id, const char* topic,
+                                              zmq_bridge_schedule_stats* stats)
+{
+    Scheduler* scheduler = find_scheduler(scheduler_id);
+    if (!scheduler)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    if (!topic || !stats)
+    {
+        set_last_error("Invalid topic or stats pointer");
+        return ZMQ_BRIDGE_ERROR_TOPIC;
+    }
+
+    return scheduler->GetStats(topic, *stats) ? ZMQ_BRIDGE_OK : ZMQ_BRIDGE_ERROR_TOPIC;
+}
+
+
+EXPORT_API void zmq_bridge_scheduler_destroy(int scheduler_id)
+{
+    Context::Instance().GetSchedulers().Remove(
+        scheduler_id, [](Scheduler& scheduler) { scheduler.Stop(); });
+}
+
+
+// Procura um canal de memória partilhada pelo ID
+static ShmPublisher* find_shm(int shm_id)
+{
+    ShmPublisher* shm = Context::Instance().GetShmPublishers().Lookup(shm_id);
+    if (!shm)
+    {
+        set_last_error("Invalid shared memory ID");
+    }
+
+    return shm;
+}
+
+
+EXPORT_API int zmq_bridge_shm_create(int socket_id, const char* name,
+                                     int slot_count, int slot_size, int flags)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (!name)
+    {
+        set_last_error("Invalid shared memory name");
+        return ZMQ_BRIDGE_ERROR_SHM;
+    }
+
+    if (!Context::Instance().GetSocketManager().IsValid(socket_id))
+    {
+        set_last_error("Invalid socket ID");
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    auto& publishers = Context::Instance().GetShmPublishers();
+
+    bool started = false;
+    int shm_id = publishers.Insert([&](ShmPublisher& shm) {
+        started = shm.Start(socket_id, name, slot_count, slot_size, flags);
+    });
+
+    if (shm_id < 0)
+    {
+        set_last_error("Too many shared memory channels");
+        return ZMQ_BRIDGE_ERROR_SHM;
+    }
+
+    if (!started)
+    {
+        publishers.Remove(shm_id, [](ShmPublisher& shm) { shm.Stop(); });
+        return ZMQ_BRIDGE_ERROR_SHM;
+    }
+
+    return shm_id;
+}
+
+
+EXPORT_API int zmq_bridge_shm_publish(int shm_id, const char* topic,
+                                      const void* data, int size)
+{
+    ShmPublisher* shm = find_shm(shm_id);
+    if (!shm)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    if (size < 0 || (size > 0 && !data))
+    {
+        set_last_error("Invalid data");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(shm->SocketId());
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    // Com o mutex do socket, slots e notificações saem pela mesma ordem
+    zmq::message_t data_msg;
+    if (!shm->Write(data, static_cast<size_t>(size), data_msg))
+    {
+        data_msg = BufferPool::Instance().CopyMessage(data, static_cast<size_t>(size));
+    }
+
+    return publish_message_locked(lock, topic, data_msg);
+}
+
+
+EXPORT_API void zmq_bridge_shm_destroy(int shm_id)
+{
+    Context::Instance().GetShmPublishers().Remove(
+        shm_id, [](ShmPublisher& shm) { shm.Stop(); });
+}
+
+
+EXPORT_API int zmq_bridge_shm_resolve(const void* frame, int size,
+                                      zmq_bridge_shm_view* view)
+{
+    if (!view || size < 0 || (size > 0 && !frame))
+    {
+        set_last_error("Invalid frame or view");
+        return ZMQ_BRIDGE_ERROR_SHM;
+    }
+
+    return Context::Instance().GetShmReaders().Resolve(frame, static_cast<size_t>(size),
+                                                       *view);
+}
+
+
+EXPORT_API int zmq_bridge_shm_valid(const zmq_bridge_shm_view* view)
+{
+    return view && zmq_bridge::internal::ShmReaders::IsValid(*view) ? 1 : 0;
+}
+
+
+static Recorder* find_recorder(int recorder_id)
+{
+    Recorder* recorder = Context::Instance().GetRecorders().Lookup(recorder_id);
+    if (!recorder)
+    {
+        set_last_error("Invalid recorder ID");
+    }
+
+    return recorder;
+}
+
+
+static Replayer* find_replayer(int replayer_id)
+{
+    Replayer* replayer = Context::Instance().GetReplayers().Lookup(replayer_id);
+    if (!replayer)
+    {
+        set_last_error("Invalid replayer ID");
+    }
+
+    return replayer;
+}
+
+
+EXPORT_API int zmq_bridge_recorder_open(const char* path, long long segment_size)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (!path || !*path || segment_size <= 0 || segment_size > UINT32_MAX)
+    {
+        set_last_error("Invalid log path or segment size");
+        return ZMQ_BRIDGE_ERROR_LOG;
+    }
+
+    auto& recorders = Context::Instance().GetRecorders();
+
+    bool opened = false;
+    int recorder_id = recorders.Insert([&](Recorder& recorder) {
+        opened = recorder.Open(path, static_cast<size_t>(segment_size));
+    });
+
+    if (recorder_id < 0)
+    {
+        set_last_error("Too many recorders");
+        return ZMQ_BRIDGE_ERROR_LOG;
+    }
+
+    if (!opened)
+    {
+        recorders.Remove(recorder_id, [](Recorder& recorder) { recorder.Close(); });
+        return ZMQ_BRIDGE_ERROR_LOG;
+    }
+
+    return recorder_id;
+}
+
+
+EXPORT_API int zmq_bridge_recorder_tap(int recorder_id, int socket_id, int channel)
+{
+    Recorder* recorder = find_recorder(recorder_id);
+    if (!recorder)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    return recorder->Tap(socket_id, channel) ? ZMQ_BRIDGE_OK : ZMQ_BRIDGE_ERROR_LOG;
+}
+
+
+EXPORT_API int zmq_bridge_recorder_attach(int recorder_id, int socket_id, int channel)
+{
+    Recorder* recorder = find_recorder(recorder_id);
+    if (!recorder)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    return recorder->Attach(socket_id, channel) ? ZMQ_BRIDGE_OK : ZMQ_BRIDGE_ERROR_LOG;
+}
+
+
+EXPORT_API int zmq_bridge_recorder_get_stats(int recorder_id, zmq_bridge_log_stats* stats)
+{
+    if (!stats)
+    {
+        set_last_error("Invalid stats pointer");
+        return ZMQ_BRIDGE_ERROR_LOG;
+    }
+
+    Recorder* recorder = find_recorder(recorder_id);
+    if (!recorder)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    recorder->GetStats(*stats);
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API void zmq_bridge_recorder_close(int recorder_id)
+{
+    Context::Instance().GetRecorders().Remove(
+        recorder_id, [](Recorder& recorder) { recorder.Close(); });
+}
+
+
+EXPORT_API int zmq_bridge_replayer_open(const char* path)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (!path || !*path)
+    {
+        set_last_error("Invalid log path");
+        return ZMQ_BRIDGE_ERROR_LOG;
+    }
+
+    auto& replayers = Context::Instance().GetReplayers();
+
+    bool opened = false;
+    int replayer_id = replayers.Insert([&](Replayer& replayer) {
+        opened = replayer.Open(path);
+    });
+
+    if (replayer_id < 0)
+    {
+        set_last_error("Too many replayers");
+        return ZMQ_BRIDGE_ERROR_LOG;
+    }
+
+    if (!opened)
+    {
+        replayers.Remove(replayer_id, [](Replayer& replayer) { replayer.Close(); });
+        return ZMQ_BRIDGE_ERROR_LOG;
+    }
+
+    return replayer_id;
+}
+
+
+EXPORT_API int zmq_bridge_replayer_route(int replayer_id, int channel, int socket_id)
+{
+    Replayer* replayer = find_replayer(replayer_id);
+    if (!replayer)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    return replayer->Route(channel, socket_id) ? ZMQ_BRIDGE_OK : ZMQ_BRIDGE_ERROR_LOG;
+}
+
+
+EXPORT_API int zmq_bridge_replayer_start(int replayer_id, double speed, long long start_ns)
+{
+    Replayer* replayer = find_replayer(replayer_id);
+    if (!replayer)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    return replayer->Start(speed, start_ns) ? ZMQ_BRIDGE_OK : ZMQ_BRIDGE_ERROR_LOG;
+}
+
+
+EXPORT_API void zmq_bridge_replayer_stop(int replayer_id)
+{
+    Replayer* replayer = find_replayer(replayer_id);
+    if (replayer)
+    {
+        replayer->Stop();
+    }
+}
+
+
+EXPORT_API int zmq_bridge_replayer_is_running(int replayer_id)
+{
+    Replayer* replayer = find_replayer(replayer_id);
+    return replayer && replayer->IsRunning() ? 1 : 0;
+}
+
+
+EXPORT_API int zmq_bridge_replayer_get_stats(int replayer_id, zmq_bridge_log_stats* stats)
+{
+    if (!stats)
+    {
+        set_last_error("Invalid stats pointer");
+        return ZMQ_BRIDGE_ERROR_LOG;
+    }
+
+    Replayer* replayer = find_replayer(replayer_id);
+    if (!replayer)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_HANDLE;
+    }
+
+    replayer->GetStats(*stats);
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API void zmq_bridge_replayer_close(int replayer_id)
+{
+    Context::Instance().GetReplayers().Remove(
+        replayer_id, [](Replayer& replayer) { replayer.Close(); });
+}
+
+
+EXPORT_API int zmq_bridge_codec_available(int codec)
+{
+    return zmq_bridge::internal::CodecAvailable(codec) ? 1 : 0;
+}
+
+
+EXPORT_API int zmq_bridge_encoder_start(int worker_threads, int queue_capacity)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    return Context::Instance().GetEncoder().Start(worker_threads, queue_capacity)
+        ? ZMQ_BRIDGE_OK
+        : ZMQ_BRIDGE_ERROR_INIT;
+}
+
+
+EXPORT_API void zmq_bridge_encoder_stop()
+{
+    Context::Instance().GetEncoder().Stop();
+}
+
+
+EXPORT_API int zmq_bridge_set_topic_codec(int socket_id, const char* topic,
+                                          int codec, int quality)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (!topic)
+    {
+        set_last_error("Invalid topic");
+        return ZMQ_BRIDGE_ERROR_CODEC;
+    }
+
+    // Com o socket bloqueado: um CloseSocket() concorrente só esquece os
+    // codecs do socket depois de este ficar registado
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    return Context::Instance().GetEncoder().SetTopicCodec(socket_id, topic, codec,
+                                                          quality)
+        ? ZMQ_BRIDGE_OK
+        : ZMQ_BRIDGE_ERROR_CODEC;
+}
+
+
+EXPORT_API int zmq_bridge_publish_image(int socket_id, const char* topic,
+                                        const void* pixels, int width,
+                                        int height, int channels)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    if (!Context::Instance().GetSocketManager().IsValid(socket_id))
+    {
+        set_last_error("Invalid socket ID");
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    if (!topic || !pixels || width <= 0 || height <= 0 || channels <= 0)
+    {
+        set_last_error("Invalid image");
+        return ZMQ_BRIDGE_ERROR_SEND;
+    }
+
+    // Verificado aqui e não na thread do encoder, onde o frame seria
+    // descartado sem o chamador saber
+    if (channels != 1 && channels != 3 && channels != 4)
+    {
+        set_last_error("Images need 1, 3 or 4 channels");
+        return ZMQ_BRIDGE_ERROR_CODEC;
+    }
+
+    uint64_t image_size = static_cast<uint64_t>(width) * static_cast<uint64_t>(height)
+        * static_cast<uint64_t>(channels);
+    if (image_size > INT_MAX)
+    {
+        set_last_error("Frame too large to encode");
+        return ZMQ_BRIDGE_ERROR_CODEC;
+    }
+
+    size_t size = static_cast<size_t>(image_size);
+    return Context::Instance().GetEncoder().Submit(socket_id, topic, pixels, size,
+                                                   width, height, channels);
+}
+
+
+EXPORT_API int zmq_bridge_decode_info(const void* frame, int size,
+                                      zmq_bridge_frame_info* info)
+{
+    if (size < 0
+        || !zmq_bridge::internal::ReadFrameInfo(frame, static_cast<size_t>(size), info))
+    {
+        return ZMQ_BRIDGE_ERROR_CODEC;
+    }
+
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_decode(const void* frame, int size, void* buffer,
+                                 int buffer_size, int* bytes_written)
+{
+    *bytes_written = 0;
+
+    if (size < 0 || buffer_size < 0)
+    {
+        set_last_error("Invalid frame");
+        return ZMQ_BRIDGE_ERROR_CODEC;
+    }
+
+    int written = zmq_bridge::internal::DecodeFrame(
+        frame, static_cast<size_t>(size), buffer, static_cast<size_t>(buffer_size));
+    if (written < 0)
+    {
+        return ZMQ_BRIDGE_ERROR_CODEC;
+    }
+
+    *bytes_written = written;
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_schema_register(int schema_id, const char* layout)
+{
+    if (!layout)
+    {
+        set_last_error("Invalid schema layout");
+        return ZMQ_BRIDGE_ERROR_SCHEMA;
+    }
+
+    return Context::Instance().GetSchemas().Register(schema_id, layout)
+        ? ZMQ_BRIDGE_OK
+        : ZMQ_BRIDGE_ERROR_SCHEMA;
+}
+
+
+EXPORT_API int zmq_bridge_schema_record_size(int schema_id)
+{
+    int size = Context::Instance().GetSchemas().RecordSize(schema_id);
+    return size < 0 ? ZMQ_BRIDGE_ERROR_SCHEMA : size;
+}
+
+
+EXPORT_API int zmq_bridge_schema_field_count(int schema_id)
+{
+    int count = Context::Instance().GetSchemas().FieldCount(schema_id);
+    return count < 0 ? ZMQ_BRIDGE_ERROR_SCHEMA : count;
+}
+
+
+EXPORT_API int zmq_bridge_record_encode(int schema_id, const double* values,
+                                        int count, void* buffer,
+                                        int buffer_size, int* bytes_written)
+{
+    *bytes_written = 0;
+
+    int written = Context::Instance().GetSchemas().Encode(
+        schema_id, values, count, buffer,
+        buffer_size > 0 ? static_cast<size_t>(buffer_size) : 0);
+    if (written < 0)
+    {
+        return ZMQ_BRIDGE_ERROR_SCHEMA;
+    }
+
+    *bytes_written = written;
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_record_decode(const void* record, int size,
+                                        int* schema_id, double* values,
+                                        int max_values, int* count)
+{
+    *schema_id = 0;
+    *count = 0;
+
+    int decoded = Context::Instance().GetSchemas().Decode(
+        record, size > 0 ? static_cast<size_t>(size) : 0, schema_id, values,
+        max_values);
+    if (decoded < 0)
+    {
+        return ZMQ_BRIDGE_ERROR_SCHEMA;
+    }
+
+    *count = decoded;
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_record_set_int(void* record, int size, int field,
+                                         long long value)
+{
+    if (!Context::Instance().GetSchemas().SetInteger(
+            record, size > 0 ? static_cast<size_t>(size) : 0, field,
+            static_cast<int64_t>(value)))
+    {
+        return ZMQ_BRIDGE_ERROR_SCHEMA;
+    }
+
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_record_get_int(const void* record, int size, int field,
+                                         long long* value)
+{
+    *value = 0;
+
+    int64_t result;
+    if (!Context::Instance().GetSchemas().GetInteger(
+            record, size > 0 ? static_cast<size_t>(size) : 0, field, result))
+    {
+        return ZMQ_BRIDGE_ERROR_SCHEMA;
+    }
+
+    *value = static_cast<long long>(result);
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_publish_record(int socket_id, const char* topic,
+                                         int schema_id, const double* values,
+                                         int count)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    auto& schemas = Context::Instance().GetSchemas();
+
+    int record_size = schemas.RecordSize(schema_id);
+    if (record_size < 0)
+    {
+        return ZMQ_BRIDGE_ERROR_SCHEMA;
+    }
+
+    // Codifica diretamente no buffer da mensagem
+    zmq::message_t record_msg =
+        BufferPool::Instance().AllocateMessage(static_cast<size_t>(record_size));
+    if (schemas.Encode(schema_id, values, count, record_msg.data(),
+                       record_msg.size())
+        < 0)
+    {
+        return ZMQ_BRIDGE_ERROR_SCHEMA;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    return publish_message_locked(lock, topic, record_msg);
+}
+
+
+EXPORT_API int zmq_bridge_set_envelope(int socket_id, int enabled)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    SocketLock lock = Context::Instance().GetSocketManager().Acquire(socket_id);
+    if (!lock)
+    {
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    lock.State().EnableEnvelope(enabled != 0);
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_get_stats(int socket_id, zmq_bridge_socket_stats* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    // Sem o mutex do socket: só contadores atómicos
+    auto* state = Context::Instance().GetSocketManager().Find(socket_id);
+    if (!state)
+    {
+        set_last_error("Invalid socket ID");
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    const auto& counters = state->stats;
+    auto load = [](const std::atomic<uint64_t>& value) {
+        return static_cast<long long>(value.load(std::memory_order_relaxed));
+    };
+
+    stats->messages_sent = load(counters.messages_sent);
+    stats->bytes_sent = load(counters.bytes_sent);
+    stats->messages_received = load(counters.messages_received);
+    stats->bytes_received = load(counters.bytes_received);
+    stats->send_would_block = load(counters.send_would_block);
+    stats->receive_would_block = load(counters.receive_would_block);
+    stats->send_errors = load(counters.send_errors);
+    stats->receive_errors = load(counters.receive_errors);
+    stats->truncated = load(counters.truncated);
+    stats->pending_frames = state->pending_frames.load(std::memory_order_relaxed);
+
+    if (std::shared_ptr<ReactorChannel> channel = std::atomic_load(&state->reactor))
+    {
+        stats->reactor_outgoing = static_cast<long long>(channel->outgoing.Size());
+        stats->reactor_incoming = static_cast<long long>(channel->incoming.Size());
+    }
+
+    counters.send_time.Snapshot(stats->send_time);
+    counters.receive_time.Snapshot(stats->receive_time);
+
+    stats->envelopes_received = load(counters.envelopes_received);
+    stats->sequence_lost = load(counters.sequence_lost);
+    stats->sequence_reordered = load(counters.sequence_reordered);
+    counters.latency.Snapshot(stats->latency);
+
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API int zmq_bridge_reset_stats(int socket_id)
+{
+    if (!check_context())
+    {
+        return ZMQ_BRIDGE_ERROR_INIT;
+    }
+
+    auto* state = Context::Instance().GetSocketManager().Find(socket_id);
+    if (!state)
+    {
+        set_last_error("Invalid socket ID");
+        return ZMQ_BRIDGE_ERROR_INVALID_SOCKET;
+    }
+
+    state->stats.Reset();
+    return ZMQ_BRIDGE_OK;
+}
+
+
+EXPORT_API void zmq_bridge_close_socket(int socket_id)
+{
+    // Garante que a thread de callbacks já não espera pelo socket
+    Context::Instance().GetDispatcher().Forget(socket_id);
+    Context::Instance().GetSocketManager().CloseSocket(socket_id);
+}
+
+
+EXPORT_API const char* zmq_bridge_get_last_error()
+{
+    return zmq_bridge::internal::GetLastError().c_str();
+}
+
+
+EXPORT_API int zmq_bridge_get_background_error(char* buffer, int buffer_size)
+{
+    std::string error;
+    if (!zmq_bridge::internal::TakeBackgroundError(error))
+    {
+        return ZMQ_BRIDGE_NO_MESSAGE;
+    }
+
+    // Trunca ao tamanho do buffer, com terminador
+    if (buffer && buffer_size > 0)
+    {
+        size_t length = std::min(error.size(), static_cast<size_t>(buffer_size - 1));
+        memcpy(buffer, error.data(), length);
+        buffer[length] = '\0';
+    }
+
+    return ZMQ_BRIDGE_OK;
 }
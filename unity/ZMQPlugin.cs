@@ -1,5 +1,7 @@
 using System;
+using System.Buffers.Binary;
 using System.Runtime.InteropServices;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Text;
 using UnityEngine;
@@ -11,6 +13,12 @@ public class ZMQPlugin : MonoBehaviour
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern int zmq_bridge_init();
     
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_config_init(out BridgeConfig config);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_init_ex(ref BridgeConfig config);
+    
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern void zmq_bridge_shutdown();
     
@@ -20,6 +28,9 @@ public class ZMQPlugin : MonoBehaviour
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern int zmq_bridge_create_subscriber(string endpoint, string topic);
     
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_create_subscriber_conflate(string endpoint, string topic);
+    
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern int zmq_bridge_create_request(string endpoint);
     
@@ -32,6 +43,39 @@ public class ZMQPlugin : MonoBehaviour
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern int zmq_bridge_create_pull(string endpoint);
     
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_create_rpc_client(string endpoint);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_create_rpc_server(string endpoint);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_rpc_request(int socketId, byte[] data, int size, int timeoutMs, out long requestId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_rpc_receive_reply(int socketId, out long requestId, byte[] buffer, int bufferSize, out int replySize);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_rpc_cancel(int socketId, long requestId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_rpc_receive_request(int socketId, out long requestHandle, byte[] buffer, int bufferSize, out int requestSize);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_rpc_reply(int socketId, long requestHandle, byte[] data, int size);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_socket_options_init(out SocketOptions options);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_create_socket_ex(int socketType, string endpoint, int bind, ref SocketOptions options, string topic);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_set_option(int socketId, int option, long value);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_get_option(int socketId, int option, out long value);
+    
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern int zmq_bridge_send(int socketId, byte[] data, int size);
     
@@ -41,214 +85,2132 @@ public class ZMQPlugin : MonoBehaviour
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern int zmq_bridge_publish(int socketId, string topic, byte[] data, int size);
     
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_send_multipart(int socketId, byte[] data, int[] frameSizes, int frameCount);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_publish_batch([In] PublishItem[] items, int count, out int itemsSent);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern IntPtr zmq_bridge_alloc_buffer(int size);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_free_buffer(IntPtr buffer);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_get_pool_stats(out PoolStats stats);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_get_stats(int socketId, out SocketStats stats);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_reset_stats(int socketId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_set_envelope(int socketId, int enabled);
+    
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    private delegate void NativeMessageCallback(int socketId, IntPtr data, IntPtr frameSizes, int frameCount, IntPtr userData);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_set_callback(int socketId, NativeMessageCallback fn, IntPtr userData);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_send_zero_copy(int socketId, IntPtr data, int size, IntPtr freeFn, IntPtr hint);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_publish_zero_copy(int socketId, string topic, IntPtr data, int size, IntPtr freeFn, IntPtr hint);
+    
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern int zmq_bridge_receive(int socketId, byte[] buffer, int bufferSize, ref int bytesReceived);
     
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern int zmq_bridge_receive_string(int socketId, StringBuilder buffer, int bufferSize);
     
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_peek_size(int socketId, out int size);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_receive_ex(int socketId, byte[] buffer, int bufferSize, int options, out int messageSize, out int flags);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_receive_borrowed(int socketId, out IntPtr message, out IntPtr data, out int size);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_release_message(IntPtr message);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_receive_batch(int socketId, byte[] buffer, int bufferSize, [Out] BatchEntry[] entries, int maxMessages, out int messagesReceived);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_subscribe(int socketId, string topic);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_unsubscribe(int socketId, string topic);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_topic_register(string topic);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_receive_topic(int socketId, out int topicId, byte[] buffer, int bufferSize, out int messageSize);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_receive_multipart(int socketId, byte[] buffer, int bufferSize, [Out] int[] frameSizes, int maxFrames, out int frameCount, out int totalSize);
+    
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern int zmq_bridge_check_message(int socketId);
     
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern int zmq_bridge_poll(int socketId, int timeoutMs);
     
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_poller_create();
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_poller_add(int pollerId, int socketId, int events);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_poller_remove(int pollerId, int socketId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_poller_wait(int pollerId, [Out] PollEvent[] events, int maxEvents, int timeoutMs);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_poller_destroy(int pollerId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_reactor_start(int idleTimeoutMs);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_reactor_stop();
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_reactor_attach(int socketId, int queueCapacity);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_reactor_detach(int socketId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_reactor_send(int socketId, byte[] data, int size);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_reactor_publish(int socketId, string topic, byte[] data, int size);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_reactor_receive(int socketId, byte[] buffer, int bufferSize, out int bytesReceived, out int flags);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_reactor_peek_size(int socketId, out int size);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_latest_create(int socketId, int flags);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_latest_publish(int latestId, string topic, byte[] data, int size);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_latest_get_stats(int latestId, string topic, out LatestStats stats);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_latest_destroy(int latestId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_scheduler_create(int socketId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_scheduler_add_topic(int schedulerId, string topic, double rateHz, int flags);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_scheduler_publish(int schedulerId, string topic, byte[] data, int size);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_scheduler_get_stats(int schedulerId, string topic, out ScheduleStats stats);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_scheduler_destroy(int schedulerId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_shm_create(int socketId, string name, int slotCount, int slotSize, int flags);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_shm_publish(int shmId, string topic, byte[] data, int size);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_shm_destroy(int shmId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_shm_resolve(byte[] frame, int size, out ShmView view);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_shm_valid(ref ShmView view);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_recorder_open(string path, long segmentSize);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_recorder_tap(int recorderId, int socketId, int channel);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_recorder_attach(int recorderId, int socketId, int channel);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_recorder_get_stats(int recorderId, out LogStats stats);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_recorder_close(int recorderId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_replayer_open(string path);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_replayer_route(int replayerId, int channel, int socketId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_replayer_start(int replayerId, double speed, long startNs);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_replayer_stop(int replayerId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_replayer_is_running(int replayerId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_replayer_get_stats(int replayerId, out LogStats stats);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_replayer_close(int replayerId);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_codec_available(int codec);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_encoder_start(int workerThreads, int queueCapacity);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern void zmq_bridge_encoder_stop();
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_set_topic_codec(int socketId, string topic, int codec, int quality);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_publish_image(int socketId, string topic, byte[] pixels, int width, int height, int channels);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_decode_info(byte[] frame, int size, out FrameInfo info);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_decode(byte[] frame, int size, byte[] buffer, int bufferSize, out int bytesWritten);
+    
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_schema_register(int schemaId, string layout);
+    
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern void zmq_bridge_close_socket(int socketId);
     
     [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
     private static extern IntPtr zmq_bridge_get_last_error();
     
+    [DllImport("ZeroMQUnityBridge", CallingConvention = CallingConvention.Cdecl)]
+    private static extern int zmq_bridge_get_background_error(byte[] buffer, int bufferSize);
+    
     #endregion
     
+    // Posição de um frame no buffer de zmq_bridge_receive_batch
+    [StructLayout(LayoutKind.Sequential)]
+    private struct BatchEntry
+    {
+        public int offset;
+        public int size;
+        public int flags;
+    }
+    
+    // Socket pronto devolvido por zmq_bridge_poller_wait
+    [StructLayout(LayoutKind.Sequential)]
+    private struct PollEvent
+    {
+        public int socketId;
+        public int events;
+    }
+    
+    // Item de zmq_bridge_publish_batch
+    [StructLayout(LayoutKind.Sequential)]
+    private struct PublishItem
+    {
+        public int socketId;
+        public IntPtr topic;
+        public IntPtr data;
+        public int size;
+    }
+    
+    // Slot de memória partilhada resolvido por zmq_bridge_shm_resolve
+    [StructLayout(LayoutKind.Sequential)]
+    private struct ShmView
+    {
+        public IntPtr data;
+        public int size;
+        public int slot;
+        public long sequence;
+        public IntPtr handle;
+    }
+    
+    // Contadores de um publicador "último valor" (zmq_bridge_latest_get_stats)
+    [StructLayout(LayoutKind.Sequential)]
+    public struct LatestStats
+    {
+        public long published;
+        public long sent;        // inclui os que um PUB no HWM descarta em silêncio
+        public long overwritten;
+        public long dropped;     // socket fechado ou erro de envio
+    }
+    
+    // Contadores de um tópico com ritmo fixo (zmq_bridge_scheduler_get_stats)
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ScheduleStats
+    {
+        public long published;
+        public long sent;
+        public long coalesced;
+        public long idleTicks;
+        public long missedTicks;
+        public long dropped;
+        public TimeStats jitter;
+    }
+    
+    // Contadores de uma gravação ou reprodução
+    [StructLayout(LayoutKind.Sequential)]
+    public struct LogStats
+    {
+        public long messages;
+        public long bytes;
+        public long dropped;
+        public long segments;
+    }
+    
+    // Distribuição de tempos em nanossegundos (percentis aproximados)
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TimeStats
+    {
+        public long count;
+        public long p50Ns;
+        public long p90Ns;
+        public long p99Ns;
+        public long p999Ns;
+        public long maxNs;
+    }
+    
+    // Métricas de um socket (zmq_bridge_get_stats)
+    [StructLayout(LayoutKind.Sequential)]
+    public struct SocketStats
+    {
+        public long messagesSent;
+        public long bytesSent;
+        public long messagesReceived;
+        public long bytesReceived;
+        public long sendWouldBlock;
+        public long receiveWouldBlock;
+        public long sendErrors;
+        public long receiveErrors;
+        public long truncated;
+        public long pendingFrames;
+        public long reactorOutgoing;
+        public long reactorIncoming;
+        public TimeStats sendTime;
+        public TimeStats receiveTime;
+        public long envelopesReceived;
+        public long sequenceLost;
+        public long sequenceReordered;
+        public TimeStats latency;
+    }
+    
+    // Contadores do pool de buffers nativo (zmq_bridge_get_pool_stats)
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PoolStats
+    {
+        public long hits;
+        public long misses;
+        public long returned;
+        public long released;
+        public long cachedBytes;
+        public long inUse;
+        public long handleHits;
+        public long handleMisses;
+    }
+    
+    // Configuração do contexto (zmq_bridge_init_ex)
+    [StructLayout(LayoutKind.Sequential)]
+    private struct BridgeConfig
+    {
+        public int ioThreads;
+        public int maxSockets;
+        public int threadSchedPolicy;
+        public int threadPriority;
+        public IntPtr affinityCpus;
+        public int affinityCpuCount;
+    }
+    
+    // Opções aplicadas na criação do socket (campos a -1 mantêm o padrão)
+    [StructLayout(LayoutKind.Sequential)]
+    public struct SocketOptions
+    {
+        public int sndhwm;
+        public int rcvhwm;
+        public int sndbuf;
+        public int rcvbuf;
+        public int linger;
+        public int conflate;
+        public int immediate;
+        public int tcpKeepalive;
+        public int tcpKeepaliveIdle;
+        public int tcpKeepaliveIntvl;
+        public int tcpKeepaliveCnt;
+        public int sndtimeo;
+        public int rcvtimeo;
+        public long affinity;
+    }
+    
+    // Tipos de SetupSocket
+    public const int SocketPub = 1;
+    public const int SocketSub = 2;
+    public const int SocketReq = 3;
+    public const int SocketRep = 4;
+    public const int SocketPush = 5;
+    public const int SocketPull = 6;
+    
+    // Opções de SetSocketOption/GetSocketOption
+    public const int OptSndHwm = 1;
+    public const int OptRcvHwm = 2;
+    public const int OptSndBuf = 3;
+    public const int OptRcvBuf = 4;
+    public const int OptLinger = 5;
+    public const int OptConflate = 6;
+    public const int OptImmediate = 7;
+    public const int OptTcpKeepalive = 8;
+    public const int OptTcpKeepaliveIdle = 9;
+    public const int OptTcpKeepaliveIntvl = 10;
+    public const int OptTcpKeepaliveCnt = 11;
+    public const int OptAffinity = 12;
+    public const int OptSndTimeo = 13;
+    public const int OptRcvTimeo = 14;
+    
+    // Cabeçalho de um frame comprimido (zmq_bridge_decode_info)
+    [StructLayout(LayoutKind.Sequential)]
+    public struct FrameInfo
+    {
+        public int codec;
+        public int width;
+        public int height;
+        public int channels;
+        public int rawSize;
+    }
+    
+    // Codecs de SetTopicCodec
+    public const int CodecNone = 0;
+    public const int CodecLz4 = 1;
+    public const int CodecZstd = 2;
+    public const int CodecJpeg = 3;
+    
+    // Registos binários: cabeçalho "ZR", u16 schemaId, u32 tamanho dos campos
+    public const int RecordHeaderSize = 8;
+    
     // Constantes de erro
     private const int ZMQ_BRIDGE_OK = 0;
     private const int ZMQ_BRIDGE_NO_MESSAGE = 1;
     private const int ZMQ_BRIDGE_ERROR_INIT = -1;
     private const int ZMQ_BRIDGE_ERROR_SOCKET = -2;
     private const int ZMQ_BRIDGE_ERROR_INVALID_SOCKET = -7;
+    private const int ZMQ_BRIDGE_ERROR_QUEUE_FULL = -9;
+    private const int ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL = -13;
+    private const int ZMQ_BRIDGE_ERROR_TIMEOUT = -16;
+    
+    // topicId de mensagens com um tópico não registado
+    public const int TopicNone = -1;
+    private const int ZMQ_BRIDGE_POLLIN = 1;
+    private const int ZMQ_BRIDGE_LATEST_SINGLE_FRAME = 0x1;
+    private const int ZMQ_BRIDGE_SHM_ALWAYS = 0x1;
+    private const int ZMQ_BRIDGE_SCHEDULE_REPEAT = 0x1;
+    private const int ZMQ_BRIDGE_SHM_INLINE = 2;
     
     // Delegados para eventos
     public delegate void MessageReceivedHandler(string topic, byte[] data);
     public delegate void StringMessageReceivedHandler(string topic, string message);
+    public delegate void TopicMessageReceivedHandler(string socketName, string topic, byte[] data);
     
     // Eventos
     public event MessageReceivedHandler OnMessageReceived;
     public event StringMessageReceivedHandler OnStringMessageReceived;
+    // Mensagens [tópico][dados] (ex.: de um publicador), com o tópico separado dos dados
+    public event TopicMessageReceivedHandler OnTopicMessageReceived;
     
     // Sockets ativos
     private Dictionary<string, int> _sockets = new Dictionary<string, int>();
     
+    // Publicadores "último valor", por nome do socket
+    private Dictionary<string, int> _latestPublishers = new Dictionary<string, int>();
+    
+    // Schedulers de ritmo fixo, por nome do socket
+    private Dictionary<string, int> _schedulers = new Dictionary<string, int>();
+    
+    // Canais de memória partilhada, por nome do socket
+    private Dictionary<string, int> _shmChannels = new Dictionary<string, int>();
+    
+    // Gravação e reprodução em curso (uma de cada)
+    private int _recorder = -1;
+    private int _replayer = -1;
+    
+    // Sockets que recebem mensagens, vigiados por um único poller nativo
+    private int _poller = -1;
+    private Dictionary<int, string> _socketNames = new Dictionary<int, string>();
+    private PollEvent[] _pollEvents = new PollEvent[64];
+    
     // Buffers de recepção
-    private byte[] _receiveBuffer = new byte[1024 * 1024]; // 1MB de buffer por padrão
-    private StringBuilder _stringBuffer = new StringBuilder(8192);
+    // Começam pequenos e crescem até à maior mensagem recebida
+    private byte[] _receiveBuffer = new byte[64 * 1024];
+    private int[] _frameSizes = new int[16];
+    
+    // Estado reutilizado por PublishBatch (tópicos ficam em memória nativa)
+    private Dictionary<string, IntPtr> _nativeTopics = new Dictionary<string, IntPtr>();
+    private PublishItem[] _publishItems = new PublishItem[16];
+    
+    // Buffer reutilizado por PublishRecord
+    private byte[] _recordBuffer = new byte[256];
+    private GCHandle[] _publishHandles = new GCHandle[16];
+    
+    // Mensagens entregues pela thread nativa de callbacks (EnableCallback)
+    private struct CallbackMessage
+    {
+        public int socketId;
+        public string topic;
+        public byte[] data;
+    }
+    
+    // Estático para o GC nunca recolher o delegate usado pelo código nativo
+    private static readonly NativeMessageCallback s_messageCallback = OnNativeMessage;
+    private readonly ConcurrentQueue<CallbackMessage> _callbackMessages = new ConcurrentQueue<CallbackMessage>();
+    private GCHandle _selfHandle;
+    
+    // Contexto ZeroMQ: -1 mantém o padrão; ioThreadCpus vazio não restringe as CPUs
+    [Header("Context Settings")]
+    public int ioThreads = 1;
+    public int maxSockets = -1;
+    public int threadSchedPolicy = -1;
+    public int threadPriority = -1;
+    public int[] ioThreadCpus = new int[0];
+    
+    // Configurações de polling
+    [Header("ZeroMQ Settings")]
+    public int pollingIntervalMs = 10;
+    public bool autoPolling = true;
+    public int maxMessagesPerPoll = 1024;
+    
+    // Modo reactor: uma thread nativa faz o I/O dos sockets ligados com AttachToReactor
+    [Header("Reactor Settings")]
+    public bool useReactor = false;
+    public int reactorIdleTimeoutMs = 1;
+    
+    // Compressão de imagens num pool de threads nativo (PublishImage)
+    [Header("Encoder Settings")]
+    public bool useEncoder = false;
+    public int encoderThreads = 0; // 0: núcleos - 1
+    public int encoderQueueCapacity = 4;
+    
+    // Entrega por callback: as mensagens ficam numa fila sem locks e os eventos
+    // são disparados em FixedUpdate/Update (desative para usar TryDequeueCallbackMessage)
+    [Header("Callback Settings")]
+    public bool deliverCallbackMessages = true;
+    
+    // Inicialização do plugin
+    void Awake()
+    {
+        zmq_bridge_config_init(out BridgeConfig config);
+        config.ioThreads = ioThreads;
+        config.maxSockets = maxSockets;
+        config.threadSchedPolicy = threadSchedPolicy;
+        config.threadPriority = threadPriority;
+        
+        // O array fica fixo em memória só durante a chamada
+        GCHandle cpus = GCHandle.Alloc(ioThreadCpus, GCHandleType.Pinned);
+        int result;
+        try
+        {
+            config.affinityCpus = cpus.AddrOfPinnedObject();
+            config.affinityCpuCount = ioThreadCpus.Length;
+            result = zmq_bridge_init_ex(ref config);
+        }
+        finally
+        {
+            cpus.Free();
+        }
+        
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to initialize ZeroMQ bridge: {result} - {GetLastError()}");
+        }
+        else
+        {
+            Debug.Log($"ZeroMQ bridge initialized successfully ({config.ioThreads} I/O threads, max {config.maxSockets} sockets)");
+            
+            _poller = zmq_bridge_poller_create();
+            if (_poller < 0)
+            {
+                Debug.LogError($"Failed to create poller: {GetLastError()}");
+            }
+            
+            if (useReactor && zmq_bridge_reactor_start(reactorIdleTimeoutMs) != ZMQ_BRIDGE_OK)
+            {
+                Debug.LogError($"Failed to start reactor: {GetLastError()}");
+            }
+            
+            if (useEncoder && zmq_bridge_encoder_start(encoderThreads, encoderQueueCapacity) != ZMQ_BRIDGE_OK)
+            {
+                Debug.LogError($"Failed to start encoder: {GetLastError()}");
+            }
+        }
+    }
+    
+  
+    void FixedUpdate()
+    {
+        if (deliverCallbackMessages)
+        {
+            DeliverCallbackMessages();
+        }
+    }
+    
+    void Update()
+    {
+        if (deliverCallbackMessages)
+        {
+            DeliverCallbackMessages();
+        }
+        
+        if (autoPolling && _poller >= 0)
+        {
+            // Uma única espera nativa indica os sockets com mensagens
+            int count = zmq_bridge_poller_wait(_poller, _pollEvents, _pollEvents.Length, 0);
+            for (int i = 0; i < count; i++)
+            {
+                if (_socketNames.TryGetValue(_pollEvents[i].socketId, out string socketName))
+                {
+                    PollSocket(socketName);
+                }
+            }
+        }
+    }
+    
+ 
+    void OnDestroy()
+    {
+        zmq_bridge_reactor_stop();
+        zmq_bridge_encoder_stop();
+        
+        StopReplay();
+        StopRecording();
+        
+        foreach (var latest in _latestPublishers)
+        {
+            zmq_bridge_latest_destroy(latest.Value);
+        }
+        _latestPublishers.Clear();
+        
+        foreach (var scheduler in _schedulers)
+        {
+            zmq_bridge_scheduler_destroy(scheduler.Value);
+        }
+        _schedulers.Clear();
+        
+        foreach (var shm in _shmChannels)
+        {
+            zmq_bridge_shm_destroy(shm.Value);
+        }
+        _shmChannels.Clear();
+        
+        foreach (var socket in _sockets)
+        {
+            zmq_bridge_close_socket(socket.Value);
+        }
+        _sockets.Clear();
+        _socketNames.Clear();
+        
+        if (_poller >= 0)
+        {
+            zmq_bridge_poller_destroy(_poller);
+            _poller = -1;
+        }
+        
+        foreach (var topic in _nativeTopics)
+        {
+            Marshal.FreeHGlobal(topic.Value);
+        }
+        _nativeTopics.Clear();
+        
+        zmq_bridge_shutdown();
+        
+        // A thread de callbacks já terminou: o handle pode ser libertado
+        if (_selfHandle.IsAllocated)
+        {
+            _selfHandle.Free();
+        }
+        
+        Debug.Log("ZeroMQ bridge shutdown");
+    }
+    
+ 
+    public bool SetupPublisher(string name, string endpoint)
+    {
+        if (_sockets.ContainsKey(name))
+        {
+            _socketNames.Remove(_sockets[name]);
+            zmq_bridge_close_socket(_sockets[name]);
+        }
+        
+        int socketId = zmq_bridge_create_publisher(endpoint);
+        if (socketId < 0)
+        {
+            Debug.LogError($"Failed to create publisher socket: {GetLastError()}");
+            return false;
+        }
+        
+        _sockets[name] = socketId;
+        Debug.Log($"Publisher socket '{name}' created at {endpoint}");
+        return true;
+    }
+    
+ 
+    // Com conflate o socket guarda só a última mensagem; o publicador deve
+    // usar EnableLatestPublishing(..., singleFrame: true)
+    public bool SetupSubscriber(string name, string endpoint, string topic, bool conflate = false)
+    {
+        if (_sockets.ContainsKey(name))
+        {
+            _socketNames.Remove(_sockets[name]);
+            zmq_bridge_close_socket(_sockets[name]);
+        }
+        
+        int socketId = conflate
+            ? zmq_bridge_create_subscriber_conflate(endpoint, topic)
+            : zmq_bridge_create_subscriber(endpoint, topic);
+        if (socketId < 0)
+        {
+            Debug.LogError($"Failed to create subscriber socket: {GetLastError()}");
+            return false;
+        }
+        
+        _sockets[name] = socketId;
+        WatchSocket(name, socketId);
+        Debug.Log($"Subscriber socket '{name}' created at {endpoint} for topic '{topic}'");
+        return true;
+    }
+    
+ 
+    // Acrescenta um tópico a um subscritor já criado (uma só ligação para vários tópicos)
+    public bool Subscribe(string socketName, string topic)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        if (zmq_bridge_subscribe(socketId, topic) != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to subscribe '{socketName}' to '{topic}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    public bool Unsubscribe(string socketName, string topic)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        if (zmq_bridge_unsubscribe(socketId, topic) != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to unsubscribe '{socketName}' from '{topic}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    // ID inteiro do tópico (o mesmo em todos os sockets), para TryReceiveTopic
+    public int RegisterTopic(string topic)
+    {
+        int topicId = zmq_bridge_topic_register(topic);
+        if (topicId < 0)
+        {
+            Debug.LogError($"Failed to register topic '{topic}': {GetLastError()}");
+        }
+        
+        return topicId;
+    }
+    
+    // Inclui ou retira o socket do polling automático em Update (ex.: para o ler
+    // só com TryReceiveTopic)
+    public void SetAutoPolling(string socketName, bool enabled)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId) || _poller < 0)
+        {
+            return;
+        }
+        
+        if (enabled)
+        {
+            zmq_bridge_poller_add(_poller, socketId, ZMQ_BRIDGE_POLLIN);
+        }
+        else
+        {
+            zmq_bridge_poller_remove(_poller, socketId);
+        }
+    }
+    
+    // Recebe [tópico][dados] com o ID do tópico registado mais longo que é prefixo
+    // do tópico recebido (TopicNone se nenhum), sem criar strings. data aponta
+    // para o buffer interno e só é válido até à próxima recepção.
+    public bool TryReceiveTopic(string socketName, out int topicId, out ArraySegment<byte> data)
+    {
+        data = default;
+        topicId = TopicNone;
+        
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            return false;
+        }
+        
+        while (true)
+        {
+            int result = zmq_bridge_receive_topic(socketId, out topicId, _receiveBuffer, _receiveBuffer.Length, out int size);
+            if (result == ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL)
+            {
+                // A mensagem continua pendente: aumenta o buffer e tenta de novo
+                EnsureReceiveBuffer(size);
+                continue;
+            }
+            
+            if (result != ZMQ_BRIDGE_OK)
+            {
+                return false;
+            }
+            
+            data = new ArraySegment<byte>(_receiveBuffer, 0, size);
+            return true;
+        }
+    }
+    
+    // Servidor RPC (ROUTER): os pedidos são lidos com TryReceiveRpcRequest e
+    // respondidos com SendRpcReply, por qualquer ordem e mesmo em frames
+    // seguintes. Não é lido pelo polling automático.
+    public bool SetupRpcServer(string name, string endpoint)
+    {
+        if (_sockets.ContainsKey(name))
+        {
+            _socketNames.Remove(_sockets[name]);
+            zmq_bridge_close_socket(_sockets[name]);
+        }
+        
+        int socketId = zmq_bridge_create_rpc_server(endpoint);
+        if (socketId < 0)
+        {
+            Debug.LogError($"Failed to create RPC server socket: {GetLastError()}");
+            return false;
+        }
+        
+        _sockets[name] = socketId;
+        Debug.Log($"RPC server socket '{name}' created at {endpoint}");
+        return true;
+    }
+    
+    // Cliente RPC (DEALER): vários pedidos em curso, respostas por TryReceiveRpcReply
+    public bool SetupRpcClient(string name, string endpoint)
+    {
+        if (_sockets.ContainsKey(name))
+        {
+            _socketNames.Remove(_sockets[name]);
+            zmq_bridge_close_socket(_sockets[name]);
+        }
+        
+        int socketId = zmq_bridge_create_rpc_client(endpoint);
+        if (socketId < 0)
+        {
+            Debug.LogError($"Failed to create RPC client socket: {GetLastError()}");
+            return false;
+        }
+        
+        _sockets[name] = socketId;
+        Debug.Log($"RPC client socket '{name}' created at {endpoint}");
+        return true;
+    }
+    
+    // Envia um pedido sem esperar pela resposta; devolve o ID do pedido, ou -1.
+    // Com timeoutMs > 0 o pedido expira se a resposta não chegar a tempo.
+    public long SendRpcRequest(string socketName, byte[] data, int timeoutMs)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return -1;
+        }
+        
+        if (zmq_bridge_rpc_request(socketId, data, data.Length, timeoutMs, out long requestId) != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to send RPC request through socket '{socketName}': {GetLastError()}");
+            return -1;
+        }
+        
+        return requestId;
+    }
+    
+    // Desiste de um pedido em curso; uma resposta que ainda chegue é descartada
+    public bool CancelRpcRequest(string socketName, long requestId)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        return zmq_bridge_rpc_cancel(socketId, requestId) == ZMQ_BRIDGE_OK;
+    }
+    
+    // Próxima resposta, ou um pedido expirado (timedOut, com reply vazio).
+    // reply aponta para o buffer interno e só é válido até à próxima recepção.
+    public bool TryReceiveRpcReply(string socketName, out long requestId, out ArraySegment<byte> reply, out bool timedOut)
+    {
+        reply = default;
+        requestId = 0;
+        timedOut = false;
+        
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            return false;
+        }
+        
+        while (true)
+        {
+            int result = zmq_bridge_rpc_receive_reply(socketId, out requestId, _receiveBuffer, _receiveBuffer.Length, out int size);
+            if (result == ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL)
+            {
+                EnsureReceiveBuffer(size);
+                continue;
+            }
+            
+            if (result == ZMQ_BRIDGE_ERROR_TIMEOUT)
+            {
+                timedOut = true;
+                return true;
+            }
+            
+            if (result != ZMQ_BRIDGE_OK)
+            {
+                return false;
+            }
+            
+            reply = new ArraySegment<byte>(_receiveBuffer, 0, size);
+            return true;
+        }
+    }
+    
+    // Próximo pedido recebido; requestHandle identifica-o em SendRpcReply
+    public bool TryReceiveRpcRequest(string socketName, out long requestHandle, out ArraySegment<byte> request)
+    {
+        request = default;
+        requestHandle = 0;
+        
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            return false;
+        }
+        
+        while (true)
+        {
+            int result = zmq_bridge_rpc_receive_request(socketId, out requestHandle, _receiveBuffer, _receiveBuffer.Length, out int size);
+            if (result == ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL)
+            {
+                EnsureReceiveBuffer(size);
+                continue;
+            }
+            
+            if (result != ZMQ_BRIDGE_OK)
+            {
+                return false;
+            }
+            
+            request = new ArraySegment<byte>(_receiveBuffer, 0, size);
+            return true;
+        }
+    }
+    
+    // false se o pedido já tiver expirado (o cliente desistiu dele)
+    public bool SendRpcReply(string socketName, long requestHandle, byte[] reply)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        int result = zmq_bridge_rpc_reply(socketId, requestHandle, reply, reply.Length);
+        if (result == ZMQ_BRIDGE_ERROR_TIMEOUT)
+        {
+            return false;
+        }
+        
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to send RPC reply through socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    public bool SetupRequestSocket(string name, string endpoint)
+    {
+        if (_sockets.ContainsKey(name))
+        {
+            _socketNames.Remove(_sockets[name]);
+            zmq_bridge_close_socket(_sockets[name]);
+        }
+        
+        int socketId = zmq_bridge_create_request(endpoint);
+        if (socketId < 0)
+        {
+            Debug.LogError($"Failed to create request socket: {GetLastError()}");
+            return false;
+        }
+        
+        _sockets[name] = socketId;
+        WatchSocket(name, socketId);
+        Debug.Log($"Request socket '{name}' created at {endpoint}");
+        return true;
+    }
+    
+ 
+    public bool SetupReplySocket(string name, string endpoint)
+    {
+        if (_sockets.ContainsKey(name))
+        {
+            _socketNames.Remove(_sockets[name]);
+            zmq_bridge_close_socket(_sockets[name]);
+        }
+        
+        int socketId = zmq_bridge_create_reply(endpoint);
+        if (socketId < 0)
+        {
+            Debug.LogError($"Failed to create reply socket: {GetLastError()}");
+            return false;
+        }
+        
+        _sockets[name] = socketId;
+        WatchSocket(name, socketId);
+        Debug.Log($"Reply socket '{name}' created at {endpoint}");
+        return true;
+    }
+    
+ 
+    public bool SetupPushSocket(string name, string endpoint)
+    {
+        if (_sockets.ContainsKey(name))
+        {
+            _socketNames.Remove(_sockets[name]);
+            zmq_bridge_close_socket(_sockets[name]);
+        }
+        
+        int socketId = zmq_bridge_create_push(endpoint);
+        if (socketId < 0)
+        {
+            Debug.LogError($"Failed to create push socket: {GetLastError()}");
+            return false;
+        }
+        
+        _sockets[name] = socketId;
+        Debug.Log($"Push socket '{name}' created at {endpoint}");
+        return true;
+    }
+    
+ 
+    public bool SetupPullSocket(string name, string endpoint)
+    {
+        if (_sockets.ContainsKey(name))
+        {
+            _socketNames.Remove(_sockets[name]);
+            zmq_bridge_close_socket(_sockets[name]);
+        }
+        
+        int socketId = zmq_bridge_create_pull(endpoint);
+        if (socketId < 0)
+        {
+            Debug.LogError($"Failed to create pull socket: {GetLastError()}");
+            return false;
+        }
+        
+        _sockets[name] = socketId;
+        WatchSocket(name, socketId);
+        Debug.Log($"Pull socket '{name}' created at {endpoint}");
+        return true;
+    }
+    
+    // Opções com todos os campos no valor padrão, para alterar antes de SetupSocket
+    public static SocketOptions DefaultSocketOptions()
+    {
+        zmq_bridge_socket_options_init(out SocketOptions options);
+        return options;
+    }
+    
+    // Cria um socket de qualquer tipo (SocketPub, SocketSub, ...) aplicando as
+    // opções antes de bind/connect. topic só é usado por sockets SUB.
+    public bool SetupSocket(string name, int socketType, string endpoint, bool bind, SocketOptions options, string topic = "")
+    {
+        if (_sockets.ContainsKey(name))
+        {
+            _socketNames.Remove(_sockets[name]);
+            zmq_bridge_close_socket(_sockets[name]);
+        }
+        
+        int socketId = zmq_bridge_create_socket_ex(socketType, endpoint, bind ? 1 : 0, ref options, topic);
+        if (socketId < 0)
+        {
+            Debug.LogError($"Failed to create socket '{name}': {GetLastError()}");
+            return false;
+        }
+        
+        _sockets[name] = socketId;
+        if (socketType != SocketPub && socketType != SocketPush)
+        {
+            WatchSocket(name, socketId);
+        }
+        
+        Debug.Log($"Socket '{name}' created at {endpoint}");
+        return true;
+    }
+    
+    // Altera uma opção (OptSndHwm, ...) de um socket existente; HWM, buffers e
+    // IMMEDIATE só afetam ligações posteriores
+    public bool SetSocketOption(string socketName, int option, long value)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        if (zmq_bridge_set_option(socketId, option, value) != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to set option {option} on socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    // Lê uma opção de um socket (null em caso de erro)
+    public long? GetSocketOption(string socketName, int option)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return null;
+        }
+        
+        if (zmq_bridge_get_option(socketId, option, out long value) != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to get option {option} from socket '{socketName}': {GetLastError()}");
+            return null;
+        }
+        
+        return value;
+    }
+    
+ 
+    public bool SendData(string socketName, byte[] data)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        int result = zmq_bridge_send(socketId, data, data.Length);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to send data through socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+ 
+    public bool SendString(string socketName, string message)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        int result = zmq_bridge_send_string(socketId, message);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to send string through socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+ 
+    // Envia os frames como uma única mensagem de vários frames
+    public bool SendMultipart(string socketName, params byte[][] frames)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        int totalSize = 0;
+        int[] frameSizes = new int[frames.Length];
+        for (int i = 0; i < frames.Length; i++)
+        {
+            frameSizes[i] = frames[i].Length;
+            totalSize += frames[i].Length;
+        }
+        
+        byte[] data = new byte[totalSize];
+        int offset = 0;
+        foreach (byte[] frame in frames)
+        {
+            Buffer.BlockCopy(frame, 0, data, offset, frame.Length);
+            offset += frame.Length;
+        }
+        
+        int result = zmq_bridge_send_multipart(socketId, data, frameSizes, frames.Length);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to send multipart message through socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+ 
+    public bool PublishData(string socketName, string topic, byte[] data)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        int result = zmq_bridge_publish(socketId, topic, data, data.Length);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to publish data on topic '{topic}' through socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+ 
+    public bool PublishString(string socketName, string topic, string message)
+    {
+        byte[] data = Encoding.UTF8.GetBytes(message);
+        return PublishData(socketName, topic, data);
+    }
+    
+    // Publica vários tópicos no mesmo socket com uma única chamada nativa
+    public bool PublishBatch(string socketName, IList<string> topics, IList<byte[]> payloads)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        int count = topics.Count;
+        if (payloads.Count != count)
+        {
+            Debug.LogError("PublishBatch: topics and payloads must have the same length");
+            return false;
+        }
+        
+        if (_publishItems.Length < count)
+        {
+            _publishItems = new PublishItem[count];
+            _publishHandles = new GCHandle[count];
+        }
+        
+        try
+        {
+            for (int i = 0; i < count; i++)
+            {
+                _publishHandles[i] = GCHandle.Alloc(payloads[i], GCHandleType.Pinned);
+                _publishItems[i].socketId = socketId;
+                _publishItems[i].topic = GetNativeTopic(topics[i]);
+                _publishItems[i].data = _publishHandles[i].AddrOfPinnedObject();
+                _publishItems[i].size = payloads[i].Length;
+            }
+            
+            int result = zmq_bridge_publish_batch(_publishItems, count, out int itemsSent);
+            if (result != ZMQ_BRIDGE_OK)
+            {
+                Debug.LogError($"Failed to publish batch through socket '{socketName}' ({itemsSent}/{count} sent): {GetLastError()}");
+                return false;
+            }
+            
+            return true;
+        }
+        finally
+        {
+            for (int i = 0; i < count; i++)
+            {
+                if (_publishHandles[i].IsAllocated)
+                {
+                    _publishHandles[i].Free();
+                }
+            }
+        }
+    }
+    
+    // Converte o tópico para uma string nativa, guardada para as próximas chamadas
+    private IntPtr GetNativeTopic(string topic)
+    {
+        if (topic == null)
+        {
+            return IntPtr.Zero;
+        }
+        
+        if (!_nativeTopics.TryGetValue(topic, out IntPtr nativeTopic))
+        {
+            nativeTopic = Marshal.StringToHGlobalAnsi(topic);
+            _nativeTopics[topic] = nativeTopic;
+        }
+        
+        return nativeTopic;
+    }
+    
+    // Reserva um buffer nativo para envio sem cópia (SendBuffer/PublishBuffer)
+    public IntPtr AllocateBuffer(int size)
+    {
+        IntPtr buffer = zmq_bridge_alloc_buffer(size);
+        if (buffer == IntPtr.Zero)
+        {
+            Debug.LogError($"Failed to allocate native buffer of {size} bytes: {GetLastError()}");
+        }
+        
+        return buffer;
+    }
+    
+    // Liberta um buffer de AllocateBuffer que acabou por não ser enviado
+    public void FreeBuffer(IntPtr buffer)
+    {
+        zmq_bridge_free_buffer(buffer);
+    }
+    
+    // Envia um buffer de AllocateBuffer sem cópia; o buffer deixa de pertencer ao chamador
+    public bool SendBuffer(string socketName, IntPtr buffer, int size)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            zmq_bridge_free_buffer(buffer);
+            return false;
+        }
+        
+        int result = zmq_bridge_send_zero_copy(socketId, buffer, size, IntPtr.Zero, IntPtr.Zero);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to send buffer through socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    // Publica um buffer de AllocateBuffer sem cópia; o buffer deixa de pertencer ao chamador
+    public bool PublishBuffer(string socketName, string topic, IntPtr buffer, int size)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            zmq_bridge_free_buffer(buffer);
+            return false;
+        }
+        
+        int result = zmq_bridge_publish_zero_copy(socketId, topic, buffer, size, IntPtr.Zero, IntPtr.Zero);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to publish buffer on topic '{topic}' through socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+ 
+    public byte[] ReceiveData(string socketName)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return null;
+        }
+        
+        // Copia diretamente do buffer do libzmq para o array final
+        int result = zmq_bridge_receive_borrowed(socketId, out IntPtr message, out IntPtr dataPtr, out int size);
+        
+        if (result == ZMQ_BRIDGE_NO_MESSAGE)
+        {
+            return null; // Nenhuma mensagem disponível
+        }
+        
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to receive data from socket '{socketName}': {GetLastError()}");
+            return null;
+        }
+        
+        byte[] data = new byte[size];
+        Marshal.Copy(dataPtr, data, 0, size);
+        zmq_bridge_release_message(message);
+        return data;
+    }
+    
+    // Recebe sem cópia: data/size são válidos até ReleaseMessage(handle).
+    // Devolve IntPtr.Zero se não houver mensagem.
+    public IntPtr ReceiveBorrowed(string socketName, out IntPtr data, out int size)
+    {
+        data = IntPtr.Zero;
+        size = 0;
+        
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return IntPtr.Zero;
+        }
+        
+        int result = zmq_bridge_receive_borrowed(socketId, out IntPtr message, out data, out size);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            if (result != ZMQ_BRIDGE_NO_MESSAGE)
+            {
+                Debug.LogError($"Failed to receive data from socket '{socketName}': {GetLastError()}");
+            }
+            return IntPtr.Zero;
+        }
+        
+        return message;
+    }
+    
+    // Liberta uma mensagem obtida com ReceiveBorrowed
+    public void ReleaseMessage(IntPtr message)
+    {
+        zmq_bridge_release_message(message);
+    }
+    
+   
+    public string ReceiveString(string socketName)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return null;
+        }
+        
+        int result;
+        int messageSize;
+        while ((result = zmq_bridge_receive_ex(socketId, _receiveBuffer, _receiveBuffer.Length, 0, out messageSize, out int flags)) == ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL)
+        {
+            // A mensagem continua pendente
+            EnsureReceiveBuffer(messageSize);
+        }
+        
+        if (result == ZMQ_BRIDGE_NO_MESSAGE)
+        {
+            return null; // Nenhuma mensagem disponível
+        }
+        
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to receive string from socket '{socketName}': {GetLastError()}");
+            return null;
+        }
+        
+        return Encoding.UTF8.GetString(_receiveBuffer, 0, messageSize);
+    }
+    
+    // Tamanho da próxima mensagem sem a consumir (-1 se não houver)
+    public int PeekMessageSize(string socketName)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return -1;
+        }
+        
+        return zmq_bridge_peek_size(socketId, out int size) == ZMQ_BRIDGE_OK ? size : -1;
+    }
+    
+    // Aumenta o buffer de recepção para pelo menos size bytes
+    private void EnsureReceiveBuffer(int size)
+    {
+        if (size > _receiveBuffer.Length)
+        {
+            _receiveBuffer = new byte[Math.Max(size, _receiveBuffer.Length * 2)];
+        }
+    }
+    
+   
+    public bool CheckMessage(string socketName)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        int result = zmq_bridge_check_message(socketId);
+        return result == 1;
+    }
+    
+    // Aguarda mensagens com timeout
+    public bool WaitForMessage(string socketName, int timeoutMs)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        int result = zmq_bridge_poll(socketId, timeoutMs);
+        return result == 1;
+    }
+    
+    // Verifica e processa as mensagens disponíveis, várias por chamada nativa
+    public void PollSocket(string socketName)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            return;
+        }
+        
+        int delivered = 0;
+        while (delivered < maxMessagesPerPoll)
+        {
+            // Cada chamada devolve todos os frames de uma mensagem
+            int result = zmq_bridge_receive_multipart(socketId, _receiveBuffer, _receiveBuffer.Length,
+                                                      _frameSizes, _frameSizes.Length, out int frameCount, out int totalSize);
+            if (result == ZMQ_BRIDGE_ERROR_BUFFER_TOO_SMALL)
+            {
+                // A mensagem continua pendente: aumenta os buffers e tenta de novo
+                EnsureReceiveBuffer(totalSize);
+                if (frameCount > _frameSizes.Length)
+                {
+                    _frameSizes = new int[frameCount];
+                }
+                continue;
+            }
+            
+            if (result != ZMQ_BRIDGE_OK)
+            {
+                break;
+            }
+            
+            // Com mais de um frame, o primeiro é o tópico e os restantes são os dados
+            string topic = null;
+            int offset = 0;
+            if (frameCount > 1)
+            {
+                topic = Encoding.UTF8.GetString(_receiveBuffer, 0, _frameSizes[0]);
+                offset = _frameSizes[0];
+            }
+            
+            int size = totalSize - offset;
+            if (size > 0)
+            {
+                // Copia os dados recebidos
+                byte[] data = new byte[size];
+                Array.Copy(_receiveBuffer, offset, data, 0, size);
+                DeliverMessage(socketName, topic, data);
+            }
+            
+            delivered++;
+        }
+    }
+    
+    // Dispara os eventos de recepção
+    private void DeliverMessage(string socketName, string topic, byte[] data)
+    {
+        OnMessageReceived?.Invoke(socketName, data);
+        
+        if (topic != null)
+        {
+            OnTopicMessageReceived?.Invoke(socketName, topic, data);
+        }
+        
+        // Tenta converter para string
+        try
+        {
+            string message = Encoding.UTF8.GetString(data);
+            OnStringMessageReceived?.Invoke(socketName, message);
+        }
+        catch
+        {
+            // Ignora erros de conversão
+        }
+    }
+    
+    // Fecha um socket
+    public void CloseSocket(string socketName)
+    {
+        if (_latestPublishers.TryGetValue(socketName, out int latestId))
+        {
+            zmq_bridge_latest_destroy(latestId);
+            _latestPublishers.Remove(socketName);
+        }
+        
+        if (_schedulers.TryGetValue(socketName, out int schedulerId))
+        {
+            zmq_bridge_scheduler_destroy(schedulerId);
+            _schedulers.Remove(socketName);
+        }
+        
+        if (_shmChannels.TryGetValue(socketName, out int shmId))
+        {
+            zmq_bridge_shm_destroy(shmId);
+            _shmChannels.Remove(socketName);
+        }
+        
+        if (_sockets.TryGetValue(socketName, out int socketId))
+        {
+            zmq_bridge_close_socket(socketId);
+            _sockets.Remove(socketName);
+            _socketNames.Remove(socketId);
+            Debug.Log($"Socket '{socketName}' closed");
+        }
+    }
+    
+    // Ativa a publicação "último valor" num socket publicador: por tópico só
+    // o frame mais recente espera pelo envio e os anteriores são descartados.
+    // singleFrame envia [tópico + dados] num só frame, para subscritores com conflate.
+    public bool EnableLatestPublishing(string socketName, bool singleFrame = false)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        if (_latestPublishers.ContainsKey(socketName))
+        {
+            return true;
+        }
+        
+        int latestId = zmq_bridge_latest_create(socketId, singleFrame ? ZMQ_BRIDGE_LATEST_SINGLE_FRAME : 0);
+        if (latestId < 0)
+        {
+            Debug.LogError($"Failed to enable latest publishing on socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        _latestPublishers[socketName] = latestId;
+        return true;
+    }
+    
+    // Substitui o frame pendente do tópico; regressa sem esperar pelo envio
+    public bool PublishLatest(string socketName, string topic, byte[] data)
+    {
+        if (!_latestPublishers.TryGetValue(socketName, out int latestId))
+        {
+            Debug.LogError($"Latest publishing not enabled on socket '{socketName}'");
+            return false;
+        }
+        
+        int result = zmq_bridge_latest_publish(latestId, topic, data, data.Length);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to publish latest frame on topic '{topic}' through socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    // Publica o tópico a rateHz numa thread nativa, independente do ritmo de
+    // Update: PublishScheduled só guarda o último frame e cada tick envia o
+    // mais recente. Com repeat, um tick sem frame novo repete o anterior.
+    // Chamar de novo muda o ritmo do tópico.
+    public bool ScheduleTopic(string socketName, string topic, double rateHz, bool repeat = false)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        if (!_schedulers.TryGetValue(socketName, out int schedulerId))
+        {
+            schedulerId = zmq_bridge_scheduler_create(socketId);
+            if (schedulerId < 0)
+            {
+                Debug.LogError($"Failed to create scheduler on socket '{socketName}': {GetLastError()}");
+                return false;
+            }
+            
+            _schedulers[socketName] = schedulerId;
+        }
+        
+        int result = zmq_bridge_scheduler_add_topic(schedulerId, topic, rateHz, repeat ? ZMQ_BRIDGE_SCHEDULE_REPEAT : 0);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to schedule topic '{topic}' at {rateHz} Hz: {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    public bool PublishScheduled(string socketName, string topic, byte[] data)
+    {
+        if (!_schedulers.TryGetValue(socketName, out int schedulerId))
+        {
+            Debug.LogError($"No scheduled topics on socket '{socketName}'");
+            return false;
+        }
+        
+        int result = zmq_bridge_scheduler_publish(schedulerId, topic, data, data.Length);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to publish scheduled frame on topic '{topic}' through socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    // Contadores e jitter dos ticks de um tópico
+    public bool TryGetScheduleStats(string socketName, string topic, out ScheduleStats stats)
+    {
+        stats = new ScheduleStats();
+        return _schedulers.TryGetValue(socketName, out int schedulerId)
+            && zmq_bridge_scheduler_get_stats(schedulerId, topic, out stats) == ZMQ_BRIDGE_OK;
+    }
+    
+    // Canal de memória partilhada num socket publicador: PublishShared copia
+    // os dados para um anel de slotCount slots de slotSize bytes e publica só
+    // uma notificação. Com subscritores noutro host (endpoint tcp que não
+    // seja loopback) os dados seguem no frame, salvo com always.
+    public bool CreateSharedMemoryChannel(string socketName, string name, int slotCount, int slotSize, bool always = false)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        if (_shmChannels.ContainsKey(socketName))
+        {
+            Debug.LogError($"Socket '{socketName}' already has a shared memory channel");
+            return false;
+        }
+        
+        int shmId = zmq_bridge_shm_create(socketId, name, slotCount, slotSize, always ? ZMQ_BRIDGE_SHM_ALWAYS : 0);
+        if (shmId < 0)
+        {
+            Debug.LogError($"Failed to create shared memory channel '{name}' on socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        _shmChannels[socketName] = shmId;
+        return true;
+    }
+    
+    public bool PublishShared(string socketName, string topic, byte[] data)
+    {
+        if (!_shmChannels.TryGetValue(socketName, out int shmId))
+        {
+            Debug.LogError($"Shared memory channel not created on socket '{socketName}'");
+            return false;
+        }
+        
+        int result = zmq_bridge_shm_publish(shmId, topic, data, data.Length);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to publish shared frame on topic '{topic}' through socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    // Lado do subscritor: copia os dados referidos por uma notificação (ou
+    // devolve o próprio frame, se não for uma). false se o slot já tiver
+    // sido reescrito ou o segmento não existir neste host.
+    public bool TryReadShared(byte[] frame, out byte[] data)
+    {
+        data = null;
+        
+        int result = zmq_bridge_shm_resolve(frame, frame.Length, out ShmView view);
+        if (result == ZMQ_BRIDGE_SHM_INLINE)
+        {
+            data = frame;
+            return true;
+        }
+        
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            return false;
+        }
+        
+        byte[] copy = new byte[view.size];
+        Marshal.Copy(view.data, copy, 0, view.size);
+        
+        // O anel não espera pelos leitores: a cópia só vale se o slot não mudou
+        if (zmq_bridge_shm_valid(ref view) == 0)
+        {
+            return false;
+        }
+        
+        data = copy;
+        return true;
+    }
+    
+    // Grava a sessão em path.000000.zbl, path.000001.zbl, ... (segmentos de
+    // segmentSizeMb MB) com um índice em path.zbi
+    public bool StartRecording(string path, int segmentSizeMb = 256)
+    {
+        if (_recorder >= 0)
+        {
+            Debug.LogError("A recording is already in progress");
+            return false;
+        }
+        
+        int recorderId = zmq_bridge_recorder_open(path, (long)segmentSizeMb << 20);
+        if (recorderId < 0)
+        {
+            Debug.LogError($"Failed to start recording to '{path}': {GetLastError()}");
+            return false;
+        }
+        
+        _recorder = recorderId;
+        return true;
+    }
+    
+    // Grava as mensagens enviadas pelo socket no canal indicado. Com received
+    // grava as recebidas, mas o socket passa a ser entregue pelo dispatcher
+    // nativo e deixa de ser lido por ReceiveData/PollSocket.
+    public bool RecordSocket(string socketName, int channel, bool received = false)
+    {
+        if (_recorder < 0)
+        {
+            Debug.LogError("No recording in progress");
+            return false;
+        }
+        
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        int result = received
+            ? zmq_bridge_recorder_attach(_recorder, socketId, channel)
+            : zmq_bridge_recorder_tap(_recorder, socketId, channel);
+        if (result != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to record socket '{socketName}': {GetLastError()}");
+            return false;
+        }
+        
+        return true;
+    }
+    
+    public void StopRecording()
+    {
+        if (_recorder >= 0)
+        {
+            zmq_bridge_recorder_close(_recorder);
+            _recorder = -1;
+        }
+    }
+    
+    public LogStats GetRecordingStats()
+    {
+        LogStats stats = new LogStats();
+        if (_recorder >= 0)
+        {
+            zmq_bridge_recorder_get_stats(_recorder, out stats);
+        }
+        
+        return stats;
+    }
     
-    // Configurações de polling
-    [Header("ZeroMQ Settings")]
-    public int pollingIntervalMs = 10;
-    public bool autoPolling = true;
+    // Abre um log gravado; os canais são encaminhados com RouteReplay antes
+    // de PlayReplay
+    public bool OpenReplay(string path)
+    {
+        StopReplay();
+        
+        int replayerId = zmq_bridge_replayer_open(path);
+        if (replayerId < 0)
+        {
+            Debug.LogError($"Failed to open replay '{path}': {GetLastError()}");
+            return false;
+        }
+        
+        _replayer = replayerId;
+        return true;
+    }
     
-    // Inicialização do plugin
-    void Awake()
+    public bool RouteReplay(int channel, string socketName)
     {
-        int result = zmq_bridge_init();
-        if (result != ZMQ_BRIDGE_OK)
+        if (_replayer < 0 || !_sockets.TryGetValue(socketName, out int socketId))
         {
-            Debug.LogError($"Failed to initialize ZeroMQ bridge: {result} - {GetLastError()}");
+            Debug.LogError($"No replay open or socket '{socketName}' not found");
+            return false;
         }
-        else
+        
+        if (zmq_bridge_replayer_route(_replayer, channel, socketId) != ZMQ_BRIDGE_OK)
         {
-            Debug.Log("ZeroMQ bridge initialized successfully");
+            Debug.LogError($"Failed to route replay channel {channel}: {GetLastError()}");
+            return false;
         }
+        
+        return true;
     }
     
-  
-    void Update()
+    // speed 1 reproduz ao ritmo original, 2 duas vezes mais rápido e 0 tão
+    // depressa quanto possível; startSeconds salta para esse instante
+    public bool PlayReplay(double speed = 1.0, double startSeconds = 0)
     {
-        if (autoPolling)
+        if (_replayer < 0)
         {
-            foreach (var socket in _sockets)
-            {
-                PollSocket(socket.Key);
-            }
+            Debug.LogError("No replay open");
+            return false;
+        }
+        
+        if (zmq_bridge_replayer_start(_replayer, speed, (long)(startSeconds * 1e9)) != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to start replay: {GetLastError()}");
+            return false;
         }
+        
+        return true;
     }
     
- 
-    void OnDestroy()
+    public bool IsReplaying()
     {
-        foreach (var socket in _sockets)
+        return _replayer >= 0 && zmq_bridge_replayer_is_running(_replayer) != 0;
+    }
+    
+    public LogStats GetReplayStats()
+    {
+        LogStats stats = new LogStats();
+        if (_replayer >= 0)
         {
-            zmq_bridge_close_socket(socket.Value);
+            zmq_bridge_replayer_get_stats(_replayer, out stats);
         }
-        _sockets.Clear();
         
-        zmq_bridge_shutdown();
-        Debug.Log("ZeroMQ bridge shutdown");
+        return stats;
     }
     
- 
-    public bool SetupPublisher(string name, string endpoint)
+    public void StopReplay()
     {
-        if (_sockets.ContainsKey(name))
+        if (_replayer >= 0)
         {
-            zmq_bridge_close_socket(_sockets[name]);
+            zmq_bridge_replayer_close(_replayer);
+            _replayer = -1;
+        }
+    }
+    
+    // Contadores de um tópico (ou de todos, com topic null)
+    public LatestStats GetLatestStats(string socketName, string topic = null)
+    {
+        LatestStats stats = new LatestStats();
+        if (_latestPublishers.TryGetValue(socketName, out int latestId))
+        {
+            zmq_bridge_latest_get_stats(latestId, topic, out stats);
         }
         
-        int socketId = zmq_bridge_create_publisher(endpoint);
-        if (socketId < 0)
+        return stats;
+    }
+    
+    // Métricas do socket; barato o suficiente para ser lido a cada frame
+    public bool TryGetSocketStats(string socketName, out SocketStats stats)
+    {
+        stats = new SocketStats();
+        if (!_sockets.TryGetValue(socketName, out int socketId))
         {
-            Debug.LogError($"Failed to create publisher socket: {GetLastError()}");
             return false;
         }
         
-        _sockets[name] = socketId;
-        Debug.Log($"Publisher socket '{name}' created at {endpoint}");
-        return true;
+        return zmq_bridge_get_stats(socketId, out stats) == ZMQ_BRIDGE_OK;
     }
     
- 
-    public bool SetupSubscriber(string name, string endpoint, string topic)
+    // Envelope de rastreio: emissor e recetor têm de o ativar; a latência e as
+    // perdas aparecem em SocketStats do socket que recebe (só no mesmo host)
+    public bool SetEnvelope(string socketName, bool enabled)
     {
-        if (_sockets.ContainsKey(name))
+        if (!_sockets.TryGetValue(socketName, out int socketId))
         {
-            zmq_bridge_close_socket(_sockets[name]);
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
         }
         
-        int socketId = zmq_bridge_create_subscriber(endpoint, topic);
-        if (socketId < 0)
+        int result = zmq_bridge_set_envelope(socketId, enabled ? 1 : 0);
+        if (result != ZMQ_BRIDGE_OK)
         {
-            Debug.LogError($"Failed to create subscriber socket: {GetLastError()}");
+            Debug.LogError($"Failed to set envelope on '{socketName}': {GetLastError()}");
             return false;
         }
         
-        _sockets[name] = socketId;
-        Debug.Log($"Subscriber socket '{name}' created at {endpoint} for topic '{topic}'");
         return true;
     }
     
- 
-    public bool SetupRequestSocket(string name, string endpoint)
+    public void ResetSocketStats(string socketName)
     {
-        if (_sockets.ContainsKey(name))
+        if (_sockets.TryGetValue(socketName, out int socketId))
         {
-            zmq_bridge_close_socket(_sockets[name]);
+            zmq_bridge_reset_stats(socketId);
+        }
+    }
+    
+    // Contadores do pool de buffers usado pelos envios e por ReceiveBorrowed
+    public PoolStats GetPoolStats()
+    {
+        zmq_bridge_get_pool_stats(out PoolStats stats);
+        return stats;
+    }
+    
+    // Indica se o codec foi incluído na build da biblioteca nativa
+    public bool IsCodecAvailable(int codec)
+    {
+        return zmq_bridge_codec_available(codec) != 0;
+    }
+    
+    // Define o codec (CodecNone/Lz4/Zstd/Jpeg) e a qualidade usados por PublishImage no tópico
+    public bool SetTopicCodec(string socketName, string topic, int codec, int quality = 0)
+    {
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
         }
         
-        int socketId = zmq_bridge_create_request(endpoint);
-        if (socketId < 0)
+        if (zmq_bridge_set_topic_codec(socketId, topic, codec, quality) != ZMQ_BRIDGE_OK)
         {
-            Debug.LogError($"Failed to create request socket: {GetLastError()}");
+            Debug.LogError($"Failed to set codec for topic '{topic}': {GetLastError()}");
             return false;
         }
         
-        _sockets[name] = socketId;
-        Debug.Log($"Request socket '{name}' created at {endpoint}");
         return true;
     }
     
- 
-    public bool SetupReplySocket(string name, string endpoint)
+    // Entrega os píxeis ao pool nativo, que os comprime e publica (requer useEncoder).
+    // Devolve false se a fila estiver cheia; o frame é descartado nesse caso.
+    public bool PublishImage(string socketName, string topic, byte[] pixels, int width, int height, int channels)
     {
-        if (_sockets.ContainsKey(name))
+        if (!_sockets.TryGetValue(socketName, out int socketId))
         {
-            zmq_bridge_close_socket(_sockets[name]);
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
         }
         
-        int socketId = zmq_bridge_create_reply(endpoint);
-        if (socketId < 0)
+        if (pixels.Length < width * height * channels)
         {
-            Debug.LogError($"Failed to create reply socket: {GetLastError()}");
+            Debug.LogError($"Image buffer smaller than {width}x{height}x{channels}");
             return false;
         }
         
-        _sockets[name] = socketId;
-        Debug.Log($"Reply socket '{name}' created at {endpoint}");
-        return true;
+        int result = zmq_bridge_publish_image(socketId, topic, pixels, width, height, channels);
+        if (result != ZMQ_BRIDGE_OK && result != ZMQ_BRIDGE_ERROR_QUEUE_FULL)
+        {
+            Debug.LogError($"Failed to publish image on topic '{topic}' through socket '{socketName}': {GetLastError()}");
+        }
+        
+        return result == ZMQ_BRIDGE_OK;
     }
     
- 
-    public bool SetupPushSocket(string name, string endpoint)
+    // Descomprime um frame recebido de um tópico publicado com PublishImage
+    public byte[] DecodeFrame(byte[] frame, out FrameInfo info)
     {
-        if (_sockets.ContainsKey(name))
+        if (zmq_bridge_decode_info(frame, frame.Length, out info) != ZMQ_BRIDGE_OK)
         {
-            zmq_bridge_close_socket(_sockets[name]);
+            return null;
         }
         
-        int socketId = zmq_bridge_create_push(endpoint);
-        if (socketId < 0)
+        byte[] pixels = new byte[info.rawSize];
+        if (zmq_bridge_decode(frame, frame.Length, pixels, pixels.Length, out int bytesWritten) != ZMQ_BRIDGE_OK)
         {
-            Debug.LogError($"Failed to create push socket: {GetLastError()}");
+            Debug.LogError($"Failed to decode frame: {GetLastError()}");
+            return null;
+        }
+        
+        return pixels;
+    }
+    
+    // Regista um esquema de registo binário na biblioteca nativa ("nome:tipo,...",
+    // ver zmq_bridge_schema_register), para uso por clientes C++ e Python
+    public bool RegisterSchema(int schemaId, string layout)
+    {
+        if (zmq_bridge_schema_register(schemaId, layout) != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to register schema {schemaId}: {GetLastError()}");
             return false;
         }
         
-        _sockets[name] = socketId;
-        Debug.Log($"Push socket '{name}' created at {endpoint}");
         return true;
     }
     
- 
-    public bool SetupPullSocket(string name, string endpoint)
+    // Escreve value como registo binário em buffer e devolve o número de bytes.
+    // T deve ser [StructLayout(LayoutKind.Sequential, Pack = 1)] com os campos pela
+    // ordem e com os tipos do esquema (as plataformas do Unity são little-endian).
+    public static int EncodeRecord<T>(ushort schemaId, T value, Span<byte> buffer) where T : struct
     {
-        if (_sockets.ContainsKey(name))
+        int size = Marshal.SizeOf<T>();
+        if (buffer.Length < RecordHeaderSize + size)
         {
-            zmq_bridge_close_socket(_sockets[name]);
+            return -1;
         }
         
-        int socketId = zmq_bridge_create_pull(endpoint);
-        if (socketId < 0)
+        buffer[0] = (byte)'Z';
+        buffer[1] = (byte)'R';
+        BinaryPrimitives.WriteUInt16LittleEndian(buffer.Slice(2), schemaId);
+        BinaryPrimitives.WriteUInt32LittleEndian(buffer.Slice(4), (uint)size);
+        MemoryMarshal.Write(buffer.Slice(RecordHeaderSize), ref value);
+        return RecordHeaderSize + size;
+    }
+    
+    // Lê um registo binário diretamente do frame, sem alocações
+    public static bool TryDecodeRecord<T>(ReadOnlySpan<byte> data, ushort schemaId, out T value) where T : struct
+    {
+        value = default;
+        
+        int size = Marshal.SizeOf<T>();
+        if (data.Length < RecordHeaderSize + size || data[0] != (byte)'Z' || data[1] != (byte)'R')
         {
-            Debug.LogError($"Failed to create pull socket: {GetLastError()}");
             return false;
         }
         
-        _sockets[name] = socketId;
-        Debug.Log($"Pull socket '{name}' created at {endpoint}");
+        if (BinaryPrimitives.ReadUInt16LittleEndian(data.Slice(2)) != schemaId
+            || BinaryPrimitives.ReadUInt32LittleEndian(data.Slice(4)) != (uint)size)
+        {
+            return false;
+        }
+        
+        value = MemoryMarshal.Read<T>(data.Slice(RecordHeaderSize));
         return true;
     }
     
- 
-    public bool SendData(string socketName, byte[] data)
+    // Publica [tópico][registo binário] (ver EncodeRecord)
+    public bool PublishRecord<T>(string socketName, string topic, ushort schemaId, T value) where T : struct
     {
         if (!_sockets.TryGetValue(socketName, out int socketId))
         {
@@ -256,18 +2218,27 @@ public class ZMQPlugin : MonoBehaviour
             return false;
         }
         
-        int result = zmq_bridge_send(socketId, data, data.Length);
+        int size = RecordHeaderSize + Marshal.SizeOf<T>();
+        if (_recordBuffer.Length < size)
+        {
+            _recordBuffer = new byte[size];
+        }
+        
+        EncodeRecord(schemaId, value, _recordBuffer);
+        
+        int result = zmq_bridge_publish(socketId, topic, _recordBuffer, size);
         if (result != ZMQ_BRIDGE_OK)
         {
-            Debug.LogError($"Failed to send data through socket '{socketName}': {GetLastError()}");
+            Debug.LogError($"Failed to publish record on topic '{topic}' through socket '{socketName}': {GetLastError()}");
             return false;
         }
         
         return true;
     }
     
- 
-    public bool SendString(string socketName, string message)
+    // Passa o I/O do socket para a thread do reactor (requer useReactor).
+    // A partir daqui use ReactorSend/ReactorPublish/ReactorReceive neste socket.
+    public bool AttachToReactor(string socketName, int queueCapacity = 1024)
     {
         if (!_sockets.TryGetValue(socketName, out int socketId))
         {
@@ -275,18 +2246,19 @@ public class ZMQPlugin : MonoBehaviour
             return false;
         }
         
-        int result = zmq_bridge_send_string(socketId, message);
-        if (result != ZMQ_BRIDGE_OK)
+        if (zmq_bridge_reactor_attach(socketId, queueCapacity) != ZMQ_BRIDGE_OK)
         {
-            Debug.LogError($"Failed to send string through socket '{socketName}': {GetLastError()}");
+            Debug.LogError($"Failed to attach socket '{socketName}' to reactor: {GetLastError()}");
             return false;
         }
         
+        // O reactor passa a ler o socket; Update deixa de o esvaziar
+        zmq_bridge_poller_remove(_poller, socketId);
         return true;
     }
     
- 
-    public bool PublishData(string socketName, string topic, byte[] data)
+    // Enfileira dados para envio pela thread do reactor; false se a fila estiver cheia
+    public bool ReactorSend(string socketName, byte[] data)
     {
         if (!_sockets.TryGetValue(socketName, out int socketId))
         {
@@ -294,25 +2266,35 @@ public class ZMQPlugin : MonoBehaviour
             return false;
         }
         
-        int result = zmq_bridge_publish(socketId, topic, data, data.Length);
-        if (result != ZMQ_BRIDGE_OK)
+        int result = zmq_bridge_reactor_send(socketId, data, data.Length);
+        if (result != ZMQ_BRIDGE_OK && result != ZMQ_BRIDGE_ERROR_QUEUE_FULL)
         {
-            Debug.LogError($"Failed to publish data on topic '{topic}' through socket '{socketName}': {GetLastError()}");
-            return false;
+            Debug.LogError($"Failed to queue data on socket '{socketName}': {GetLastError()}");
         }
         
-        return true;
+        return result == ZMQ_BRIDGE_OK;
     }
     
- 
-    public bool PublishString(string socketName, string topic, string message)
+    // Enfileira [tópico][dados] para a thread do reactor; false se a fila estiver cheia
+    public bool ReactorPublish(string socketName, string topic, byte[] data)
     {
-        byte[] data = Encoding.UTF8.GetBytes(message);
-        return PublishData(socketName, topic, data);
+        if (!_sockets.TryGetValue(socketName, out int socketId))
+        {
+            Debug.LogError($"Socket '{socketName}' not found");
+            return false;
+        }
+        
+        int result = zmq_bridge_reactor_publish(socketId, topic, data, data.Length);
+        if (result != ZMQ_BRIDGE_OK && result != ZMQ_BRIDGE_ERROR_QUEUE_FULL)
+        {
+            Debug.LogError($"Failed to queue topic '{topic}' on socket '{socketName}': {GetLastError()}");
+        }
+        
+        return result == ZMQ_BRIDGE_OK;
     }
     
- 
-    public byte[] ReceiveData(string socketName)
+    // Retira um frame recebido pela thread do reactor (null se não houver)
+    public byte[] ReactorReceive(string socketName)
     {
         if (!_sockets.TryGetValue(socketName, out int socketId))
         {
@@ -320,17 +2302,17 @@ public class ZMQPlugin : MonoBehaviour
             return null;
         }
         
-        int bytesReceived = 0;
-        int result = zmq_bridge_receive(socketId, _receiveBuffer, _receiveBuffer.Length, ref bytesReceived);
-        
-        if (result == ZMQ_BRIDGE_NO_MESSAGE)
+        if (zmq_bridge_reactor_peek_size(socketId, out int size) != ZMQ_BRIDGE_OK)
         {
-            return null; // Nenhuma mensagem disponível
+            return null;
         }
         
+        // O frame só sai da fila depois de copiado; garante que não é truncado
+        EnsureReceiveBuffer(size);
+        
+        int result = zmq_bridge_reactor_receive(socketId, _receiveBuffer, _receiveBuffer.Length, out int bytesReceived, out int flags);
         if (result != ZMQ_BRIDGE_OK)
         {
-            Debug.LogError($"Failed to receive data from socket '{socketName}': {GetLastError()}");
             return null;
         }
         
@@ -339,34 +2321,35 @@ public class ZMQPlugin : MonoBehaviour
         return data;
     }
     
-   
-    public string ReceiveString(string socketName)
+    // Passa a receber o socket numa thread nativa, logo que cada mensagem chega,
+    // em vez de esperar pelo próximo Update. As mensagens são entregues pelos
+    // eventos habituais em FixedUpdate/Update, ou com TryDequeueCallbackMessage.
+    public bool EnableCallback(string socketName)
     {
         if (!_sockets.TryGetValue(socketName, out int socketId))
         {
             Debug.LogError($"Socket '{socketName}' not found");
-            return null;
+            return false;
         }
         
-        _stringBuffer.Clear();
-        int result = zmq_bridge_receive_string(socketId, _stringBuffer, _stringBuffer.Capacity);
-        
-        if (result == ZMQ_BRIDGE_NO_MESSAGE)
+        if (!_selfHandle.IsAllocated)
         {
-            return null; // Nenhuma mensagem disponível
+            _selfHandle = GCHandle.Alloc(this);
         }
         
-        if (result != ZMQ_BRIDGE_OK)
+        if (zmq_bridge_set_callback(socketId, s_messageCallback, GCHandle.ToIntPtr(_selfHandle)) != ZMQ_BRIDGE_OK)
         {
-            Debug.LogError($"Failed to receive string from socket '{socketName}': {GetLastError()}");
-            return null;
+            Debug.LogError($"Failed to set callback on socket '{socketName}': {GetLastError()}");
+            return false;
         }
         
-        return _stringBuffer.ToString();
+        // A thread de callbacks passa a ler o socket; Update deixa de o esvaziar
+        zmq_bridge_poller_remove(_poller, socketId);
+        return true;
     }
     
-   
-    public bool CheckMessage(string socketName)
+    // Volta à leitura por polling em Update
+    public bool DisableCallback(string socketName)
     {
         if (!_sockets.TryGetValue(socketName, out int socketId))
         {
@@ -374,68 +2357,83 @@ public class ZMQPlugin : MonoBehaviour
             return false;
         }
         
-        int result = zmq_bridge_check_message(socketId);
-        return result == 1;
+        zmq_bridge_set_callback(socketId, null, IntPtr.Zero);
+        
+        if (_poller >= 0 && zmq_bridge_poller_add(_poller, socketId, ZMQ_BRIDGE_POLLIN) != ZMQ_BRIDGE_OK)
+        {
+            Debug.LogError($"Failed to add socket '{socketName}' to poller: {GetLastError()}");
+        }
+        
+        return true;
     }
     
-    // Aguarda mensagens com timeout
-    public bool WaitForMessage(string socketName, int timeoutMs)
+    // Retira uma mensagem recebida por callback (com deliverCallbackMessages desativado).
+    // Pode ser chamado de qualquer thread; topic é null em mensagens de um só frame.
+    public bool TryDequeueCallbackMessage(out string socketName, out string topic, out byte[] data)
     {
-        if (!_sockets.TryGetValue(socketName, out int socketId))
+        while (_callbackMessages.TryDequeue(out CallbackMessage message))
         {
-            Debug.LogError($"Socket '{socketName}' not found");
-            return false;
+            // Ignora mensagens de sockets entretanto fechados
+            if (_socketNames.TryGetValue(message.socketId, out socketName))
+            {
+                topic = message.topic;
+                data = message.data;
+                return true;
+            }
         }
         
-        int result = zmq_bridge_poll(socketId, timeoutMs);
-        return result == 1;
+        socketName = null;
+        topic = null;
+        data = null;
+        return false;
     }
     
-    // Verifica e processa mensagens disponíveis
-    public void PollSocket(string socketName)
+    private void DeliverCallbackMessages()
     {
-        if (!_sockets.TryGetValue(socketName, out int socketId))
+        while (TryDequeueCallbackMessage(out string socketName, out string topic, out byte[] data))
+        {
+            DeliverMessage(socketName, topic, data);
+        }
+    }
+    
+    // Chamado pela thread nativa de callbacks: copia a mensagem e regressa logo
+    [AOT.MonoPInvokeCallback(typeof(NativeMessageCallback))]
+    private static void OnNativeMessage(int socketId, IntPtr data, IntPtr frameSizes, int frameCount, IntPtr userData)
+    {
+        if (!(GCHandle.FromIntPtr(userData).Target is ZMQPlugin plugin) || frameCount <= 0)
         {
             return;
         }
         
-        if (zmq_bridge_poll(socketId, 0) == 1)
+        // Como em PollSocket: com mais de um frame, o primeiro é o tópico
+        int total = 0;
+        for (int i = 0; i < frameCount; i++)
         {
-            // Há mensagem disponível, vamos processá-la
-            int bytesReceived = 0;
-            int result = zmq_bridge_receive(socketId, _receiveBuffer, _receiveBuffer.Length, ref bytesReceived);
-            
-            if (result == ZMQ_BRIDGE_OK && bytesReceived > 0)
-            {
-                // Copia os dados recebidos
-                byte[] data = new byte[bytesReceived];
-                Array.Copy(_receiveBuffer, data, bytesReceived);
-                
-                // Dispara o evento de recepção
-                OnMessageReceived?.Invoke(socketName, data);
-                
-                // Tenta converter para string
-                try
-                {
-                    string message = Encoding.UTF8.GetString(data);
-                    OnStringMessageReceived?.Invoke(socketName, message);
-                }
-                catch
-                {
-                    // Ignora erros de conversão
-                }
-            }
+            total += Marshal.ReadInt32(frameSizes, i * sizeof(int));
+        }
+        
+        string topic = null;
+        int offset = 0;
+        if (frameCount > 1)
+        {
+            offset = Marshal.ReadInt32(frameSizes);
+            topic = Marshal.PtrToStringUTF8(data, offset);
         }
+        
+        byte[] payload = new byte[total - offset];
+        Marshal.Copy(IntPtr.Add(data, offset), payload, 0, payload.Length);
+        
+        plugin._callbackMessages.Enqueue(new CallbackMessage { socketId = socketId, topic = topic, data = payload });
     }
     
-    // Fecha um socket
-    public void CloseSocket(string socketName)
+    // Regista um socket de recepção no poller usado por Update
+    private void WatchSocket(string name, int socketId)
     {
-        if (_sockets.TryGetValue(socketName, out int socketId))
+        _socketNames[socketId] = name;
+        
+        if (_poller >= 0 && zmq_bridge_poller_add(_poller, socketId, ZMQ_BRIDGE_POLLIN) != ZMQ_BRIDGE_OK)
         {
-            zmq_bridge_close_socket(socketId);
-            _sockets.Remove(socketName);
-            Debug.Log($"Socket '{socketName}' closed");
+            Debug.LogError($"Failed to add socket '{name}' to poller: {GetLastError()}");
         }
     }
     
@@ -445,4 +2443,18 @@ public class ZMQPlugin : MonoBehaviour
         IntPtr errorPtr = zmq_bridge_get_last_error();
         return Marshal.PtrToStringAnsi(errorPtr);
     }
+    
+    // Último erro das threads nativas (dispatcher, reactor, ...), ou null;
+    // GetLastError só vê os erros da thread que chama
+    public string TakeBackgroundError()
+    {
+        byte[] buffer = new byte[512];
+        if (zmq_bridge_get_background_error(buffer, buffer.Length) != ZMQ_BRIDGE_OK)
+        {
+            return null;
+        }
+        
+        int length = Array.IndexOf(buffer, (byte)0);
+        return Encoding.UTF8.GetString(buffer, 0, length < 0 ? buffer.Length : length);
+    }
 }